@@ -19,6 +19,9 @@
 
 #include "A31L12x_hal_uartn.h"
 #include "A31L12x_hal_libcfg.h"
+#ifdef _DEBUG_MSG_BUFFERED
+#include "A31L12x_hal_dmacn.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -34,8 +37,26 @@ extern "C" {
 
 #if (USED_UART_DEBUG_PORT == 0)
 #define DEBUG_UART_PORT          UART0
+#define DEBUG_UART_PERSEL_TX     PERSEL_UART0Tx
 #elif (USED_UART_DEBUG_PORT == 1)
 #define DEBUG_UART_PORT          UART1
+#define DEBUG_UART_PERSEL_TX     PERSEL_UART1Tx
+#endif
+
+#ifndef DEBUG_CPRINTF_BUF_SIZE
+#define DEBUG_CPRINTF_BUF_SIZE   128         // cprintf() stack buffer, longer output is truncated
+#endif
+
+#ifdef _DEBUG_MSG_BUFFERED
+// Buffered output: messages are copied to a RAM ring and drained by DMA
+#ifndef DEBUG_TX_BUF_SIZE
+#define DEBUG_TX_BUF_SIZE        512         // ring size (power of 2), messages that do not fit are dropped
+#endif
+#define DEBUG_TX_DMA_CHANNEL     DMAC1       // DMA channel for debug TX
+#define DEBUG_TX_DMA_IRQn        DMAC1_IRQn  // DMAC1_Handler() must call debug_frmwrk_dma_handler()
+#ifndef DEBUG_TX_FLUSH_SPIN
+#define DEBUG_TX_FLUSH_SPIN      100000uL    // flush polls without progress before the ring is dropped
+#endif
 #endif
 
 //******************************************************************************
@@ -89,6 +110,13 @@ void cprintf( const char* format, ... );
 void debug_frmwrk_init( void );
 uint8_t getstring( void );
 
+#ifdef _DEBUG_MSG_BUFFERED
+FunctionalState debug_frmwrk_buffered( FunctionalState NewState );
+void debug_frmwrk_flush( void );
+void debug_frmwrk_dma_handler( void );
+uint32_t debug_frmwrk_get_drops( void );
+#endif
+
 #endif   /* _DEBUG_MSG */
 
 #ifdef __cplusplus
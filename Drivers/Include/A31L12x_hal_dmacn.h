@@ -95,6 +95,8 @@ HAL_Status_Type HAL_DMAC_Init( DMACn_Type* DMACx, uint8_t PERSEL, uint8_t DIR, u
 HAL_Status_Type HAL_DMAC_DeInit( DMACn_Type* DMACx );
 
 HAL_Status_Type HAL_DMAC_Setup( DMACn_Type* DMACx, uint32_t MAR, uint16_t TRANSCNT );
+HAL_Status_Type HAL_DMAC_Stop( DMACn_Type* DMACx );
+uint16_t HAL_DMAC_GetTransferCount( DMACn_Type* DMACx );
 
 #ifdef __cplusplus
 }
@@ -140,6 +140,8 @@ HAL_Status_Type HAL_LPUART_DeInit( void );
 HAL_Status_Type HAL_LPUART_ConfigStructInit( LPUART_CFG_Type* LPUART_Config );
 HAL_Status_Type HAL_LPUART_ConfigInterrupt( LPUART_INT_Type LPUART_IntCfg, FunctionalState NewState );
 HAL_Status_Type HAL_LPUART_DataControlConfig( LPUART_CONTROL_Type Mode, FunctionalState NewState );
+HAL_Status_Type HAL_LPUART_SetReceiveTimeOut( uint32_t TimeOutData );
+HAL_Status_Type HAL_LPUART_SetCharacterDetect( uint8_t DetectData );
 HAL_Status_Type HAL_LPUART_Enable( FunctionalState state );
 HAL_Status_Type HAL_LPUART_ClearStatus( LPUART_STATUS_Type Status );
 uint8_t HAL_LPUART_GetStatus( void );
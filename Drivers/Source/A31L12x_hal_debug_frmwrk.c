@@ -50,6 +50,97 @@ void ( *_db_hex_32 )( UARTn_Type* UARTx, uint32_t hexn );
 uint8_t ( *_db_get_char )( UARTn_Type* UARTx );
 uint8_t ( *_db_get_ch )( UARTn_Type* UARTx, uint8_t* ch );
 
+#ifdef _DEBUG_MSG_BUFFERED
+// buffered output ring (producers: any context, consumer: DMA)
+static uint8_t             db_tx_buf[DEBUG_TX_BUF_SIZE];
+static uint16_t            db_tx_head;          // next write position
+static uint16_t            db_tx_tail;          // start of in-flight DMA chunk
+static volatile uint16_t   db_tx_count;         // queued bytes, including in-flight chunk
+static volatile uint16_t   db_tx_dma_len;       // in-flight chunk length (0: DMA idle)
+static volatile uint32_t   db_tx_drops;         // bytes dropped on overflow
+static volatile uint8_t    db_tx_buffered;      // 1: buffered mode
+
+/* Private Functions -------------------------------------------------------- */
+//******************************************************************************
+// Private Function
+//******************************************************************************
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         Starts DMA for the contiguous queued bytes if DMA is idle
+ * @param         None
+ * @return        None
+ * @note          Called with interrupts disabled or from the DMA handler
+ *//*-------------------------------------------------------------------------*/
+static void db_tx_kick( void )
+{
+   uint16_t    len;
+
+   if( db_tx_dma_len != 0 || db_tx_count == 0 )
+   {
+      return;
+   }
+
+   // up to the end of the ring; the wrapped part goes in the next chunk
+   len = DEBUG_TX_BUF_SIZE - db_tx_tail;
+   if( len > db_tx_count )
+   {
+      len = db_tx_count;
+   }
+
+   db_tx_dma_len = len;
+   HAL_DMAC_Setup( ( DMACn_Type* )DEBUG_TX_DMA_CHANNEL, ( uint32_t )&db_tx_buf[db_tx_tail], len );
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         Queues bytes to the buffered output ring
+ * @param[in]     UARTx
+ *                   Pointer to the target UART
+ * @param[in]     data
+ *                   Bytes to queue
+ * @param[in]     len
+ *                   Number of bytes
+ * @return        1 if handled by the ring (queued or dropped), 0 if the caller must transmit directly
+ * @details       A message that does not fit is dropped as a whole and counted in db_tx_drops,
+ *                the caller never waits for the UART.
+ *//*-------------------------------------------------------------------------*/
+static uint8_t db_tx_write( UARTn_Type* UARTx, const uint8_t* data, uint16_t len )
+{
+   uint32_t    primask;
+   uint16_t    head;
+
+   if( !db_tx_buffered || UARTx != ( UARTn_Type* )DEBUG_UART_PORT )
+   {
+      return 0;
+   }
+
+   primask = __get_PRIMASK();
+   __disable_irq();
+
+   if( len > DEBUG_TX_BUF_SIZE - db_tx_count )
+   {
+      db_tx_drops += len;
+   }
+   else
+   {
+      head = db_tx_head;
+      db_tx_count += len;
+
+      while( len-- )
+      {
+         db_tx_buf[head] = *data++;
+         head = ( head + 1 ) & ( DEBUG_TX_BUF_SIZE - 1 );
+      }
+
+      db_tx_head = head;
+      db_tx_kick();
+   }
+
+   __set_PRIMASK( primask );
+
+   return 1;
+}
+#endif   /* _DEBUG_MSG_BUFFERED */
+
 /* Public Functions --------------------------------------------------------- */
 //******************************************************************************
 // Function
@@ -85,6 +176,13 @@ int fputc( int ch, FILE* f )
  *//*-------------------------------------------------------------------------*/
 void UARTPutChar( UARTn_Type* UARTx, uint8_t ch )
 {
+#ifdef _DEBUG_MSG_BUFFERED
+   if( db_tx_write( UARTx, &ch, 1 ) )
+   {
+      return;
+   }
+#endif
+
    HAL_UART_Transmit( UARTx, &ch, 1, BLOCKING );
 }
 
@@ -140,6 +238,23 @@ void UARTPuts( UARTn_Type* UARTx, const void* str )
 {
    uint8_t*    s = ( uint8_t* )str;
 
+#ifdef _DEBUG_MSG_BUFFERED
+   if( db_tx_buffered )
+   {
+      while( *s )
+      {
+         s++;
+      }
+
+      if( db_tx_write( UARTx, ( uint8_t* )str, ( uint16_t )( s - ( uint8_t* )str ) ) )
+      {
+         return;
+      }
+
+      s = ( uint8_t* )str;
+   }
+#endif
+
    while( *s )
    {
       UARTPutChar( UARTx, *s++ );
@@ -307,14 +422,15 @@ void UARTPutHex32( UARTn_Type* UARTx, uint32_t hexnum )
  * @param[in]     format
  *                   formatted string to be print
  * @return        None
+ * @note          Output longer than DEBUG_CPRINTF_BUF_SIZE - 1 characters is truncated
  *//*-------------------------------------------------------------------------*/
 void cprintf( const char* format, ... )
 {
-   char        buffer[512 + 1];
+   char        buffer[DEBUG_CPRINTF_BUF_SIZE];
    va_list     vArgs;
 
    va_start( vArgs, format );
-   vsprintf( ( char* )buffer, ( char const* )format, vArgs );
+   vsnprintf( ( char* )buffer, sizeof( buffer ), ( char const* )format, vArgs );
    va_end( vArgs );
 
    _DBG( buffer );
@@ -374,6 +490,158 @@ void debug_frmwrk_init( void )
    _db_get_ch = UARTGetCh;
 }
 
+#ifdef _DEBUG_MSG_BUFFERED
+/*-------------------------------------------------------------------------*//**
+ * @brief         Enables or disables buffered (DMA) output on the debug port
+ * @param[in]     NewState
+ *                   -  ENABLE: _DBG() etc. queue to a RAM ring and return at once
+ *                   -  DISABLE: flush the ring and return to blocking output
+ * @return        Previous state
+ * @note          DMAC1_Handler() must call debug_frmwrk_dma_handler().
+ *                While interrupts are disabled, the ring is not drained beyond the current chunk.
+ *//*-------------------------------------------------------------------------*/
+FunctionalState debug_frmwrk_buffered( FunctionalState NewState )
+{
+   DMACn_Type*       dmac = ( DMACn_Type* )DEBUG_TX_DMA_CHANNEL;
+   FunctionalState   prev = db_tx_buffered ? ENABLE : DISABLE;
+
+   if( NewState == prev )
+   {
+      return prev;
+   }
+
+   if( NewState == ENABLE )
+   {
+      db_tx_head = 0;
+      db_tx_tail = 0;
+      db_tx_count = 0;
+      db_tx_dma_len = 0;
+
+      // ring -> UART THR (8bit)
+      HAL_DMAC_Init( dmac, DEBUG_UART_PERSEL_TX, DIR_MemToPeri, SIZE_8bit, ERFGSTP_Disable );
+      dmac->IESR = DMACn_IESR_TRCIENn_Msk | DMACn_IESR_TRCIFGn_Msk | DMACn_IESR_TRERIFGn_Msk;
+      NVIC_ClearPendingIRQ( DEBUG_TX_DMA_IRQn );
+      NVIC_EnableIRQ( DEBUG_TX_DMA_IRQn );
+
+      db_tx_buffered = 1;
+   }
+   else
+   {
+      debug_frmwrk_flush();
+
+      db_tx_buffered = 0;
+      NVIC_DisableIRQ( DEBUG_TX_DMA_IRQn );
+      dmac->IESR = DMACn_IESR_TRCIFGn_Msk | DMACn_IESR_TRERIFGn_Msk;
+
+      // wait for the last byte to leave the shift register
+      while( !( ( ( UARTn_Type* )DEBUG_UART_PORT )->LSR & UARTn_LSR_TEMT ) );
+   }
+
+   return prev;
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         Waits until the buffered output ring is empty
+ * @param         None
+ * @return        None
+ * @note          Blocks the caller. Use before sleep or reset, not from the protocol path.
+ *                If the DMA makes no progress for DEBUG_TX_FLUSH_SPIN polls (e.g. the UART
+ *                clock is stopped), the channel is stopped and the queued bytes are dropped.
+ *//*-------------------------------------------------------------------------*/
+void debug_frmwrk_flush( void )
+{
+   DMACn_Type*    dmac = ( DMACn_Type* )DEBUG_TX_DMA_CHANNEL;
+   uint32_t       spin = 0;
+   uint32_t       primask;
+   uint16_t       count;
+   uint16_t       left;
+
+   count = db_tx_count;
+   left = HAL_DMAC_GetTransferCount( dmac );
+
+   while( db_tx_buffered && db_tx_count != 0 )
+   {
+      // drain without the DMA interrupt (e.g. called with interrupts disabled)
+      if( dmac->IESR & ( DMACn_IESR_TRCIFGn_Msk | DMACn_IESR_TRERIFGn_Msk ) )
+      {
+         debug_frmwrk_dma_handler();
+      }
+
+      if( db_tx_count != count || HAL_DMAC_GetTransferCount( dmac ) != left )
+      {
+         count = db_tx_count;
+         left = HAL_DMAC_GetTransferCount( dmac );
+         spin = 0;
+      }
+      else if( ++spin >= DEBUG_TX_FLUSH_SPIN )
+      {
+         primask = __get_PRIMASK();
+         __disable_irq();
+
+         HAL_DMAC_Stop( dmac );
+         dmac->IESR |= DMACn_IESR_TRCIFGn_Msk | DMACn_IESR_TRERIFGn_Msk;
+
+         db_tx_drops += db_tx_count;
+         db_tx_head = 0;
+         db_tx_tail = 0;
+         db_tx_count = 0;
+         db_tx_dma_len = 0;
+
+         __set_PRIMASK( primask );
+      }
+   }
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         Debug TX DMA transfer complete/error handler
+ * @param         None
+ * @return        None
+ * @details       Releases the finished chunk and starts the next one.
+ *                On a transfer error the chunk is dropped (counted in db_tx_drops)
+ *                and the next one is started, so the ring never stalls on it.
+ *//*-------------------------------------------------------------------------*/
+void debug_frmwrk_dma_handler( void )
+{
+   DMACn_Type*    dmac = ( DMACn_Type* )DEBUG_TX_DMA_CHANNEL;
+   uint32_t       primask;
+   uint32_t       flags;
+
+   primask = __get_PRIMASK();
+   __disable_irq();
+
+   flags = dmac->IESR & ( DMACn_IESR_TRCIFGn_Msk | DMACn_IESR_TRERIFGn_Msk );
+   if( flags != 0 )
+   {
+      // reset the pending TRCIFGn/TRERIFGn only (reset by w1)
+      dmac->IESR = ( dmac->IESR & ~( DMACn_IESR_TRCIFGn_Msk | DMACn_IESR_TRERIFGn_Msk ) ) | flags;
+
+      if( flags & DMACn_IESR_TRERIFGn_Msk )
+      {
+         HAL_DMAC_Stop( dmac );
+         db_tx_drops += db_tx_dma_len;
+      }
+
+      db_tx_tail = ( db_tx_tail + db_tx_dma_len ) & ( DEBUG_TX_BUF_SIZE - 1 );
+      db_tx_count -= db_tx_dma_len;
+      db_tx_dma_len = 0;
+
+      db_tx_kick();
+   }
+
+   __set_PRIMASK( primask );
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         Returns the number of debug output bytes dropped on ring overflow
+ * @param         None
+ * @return        Dropped bytes since startup
+ *//*-------------------------------------------------------------------------*/
+uint32_t debug_frmwrk_get_drops( void )
+{
+   return db_tx_drops;
+}
+#endif   /* _DEBUG_MSG_BUFFERED */
+
 /*-------------------------------------------------------------------------*//**
  * @brief         Get a character to UART port
  * @param         None
@@ -198,3 +198,36 @@ HAL_Status_Type HAL_DMAC_Setup( DMACn_Type* DMACx, uint32_t MAR, uint16_t TRANSC
    return HAL_OK;
 }
 
+/*-------------------------------------------------------------------------*//**
+ * @brief         Disable the transfer
+ * @param[in]     DMACx
+ *                   Pointer to the target DMAC
+ *                   -  DMAC0 ~ DMAC4
+ * @return        @ref HAL_Status_Type
+ * @details       This function stops the DMA transfer before the count expires.
+ *//*-------------------------------------------------------------------------*/
+HAL_Status_Type HAL_DMAC_Stop( DMACn_Type* DMACx )
+{
+   /* Check DMAC handle */
+   if( DMACx == NULL )
+   {
+      return HAL_ERROR;
+   }
+
+   // disable channel
+   DMACx->CR_b.CHnEN = 0;      // CHnEN[00:00]   [0] in [0(disable channel n) 1(enable; reset by transfer complete or error)]
+
+   return HAL_OK;
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         Get the remaining transfer count
+ * @param[in]     DMACx
+ *                   Pointer to the target DMAC
+ *                   -  DMAC0 ~ DMAC4
+ * @return        Number of transfers not yet performed
+ *//*-------------------------------------------------------------------------*/
+uint16_t HAL_DMAC_GetTransferCount( DMACn_Type* DMACx )
+{
+   return DMACx->CR_b.TRANSCNT;
+}
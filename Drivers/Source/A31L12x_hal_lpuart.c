@@ -313,6 +313,34 @@ HAL_Status_Type HAL_LPUART_DataControlConfig( LPUART_CONTROL_Type Mode, Function
    return HAL_OK;
 }
 
+/*-------------------------------------------------------------------------*//**
+ * @brief         Set the receive time-out data of LPUART peripheral
+ * @param[in]     TimeOutData
+ *                   Receive time-out period in bit times (24-bit)
+ * @return        @ref HAL_Status_Type
+ * @details       The time-out takes effect when LPUART_CONTROL_RTOEN is enabled.
+ *//*-------------------------------------------------------------------------*/
+HAL_Status_Type HAL_LPUART_SetReceiveTimeOut( uint32_t TimeOutData )
+{
+   LPUART->RTODR = TimeOutData & LPUART_RTODR_RTOD_Msk;
+
+   return HAL_OK;
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         Set the receive character detection data of LPUART peripheral
+ * @param[in]     DetectData
+ *                   Character to be detected
+ * @return        @ref HAL_Status_Type
+ * @details       The detection takes effect when LPUART_CONTROL_RCDEN is enabled.
+ *//*-------------------------------------------------------------------------*/
+HAL_Status_Type HAL_LPUART_SetCharacterDetect( uint8_t DetectData )
+{
+   LPUART->RCDR = DetectData;
+
+   return HAL_OK;
+}
+
 /*-------------------------------------------------------------------------*//**
  * @brief         LPUART enable control
  * @param[in]     state
@@ -27,6 +27,7 @@
  ******************************************************************************/
 
 #include "main_conf.h"
+#include "meter_protocol.h"    // METER_LPUART_WAKE
 
 /* Private typedef ---------------------------------------------------------- */
 /* Private define ----------------------------------------------------------- */
@@ -63,6 +64,11 @@ void SystemClock_Config( void )
 {
    uint32_t    i;
 
+#ifdef METER_LPUART_WAKE
+   // sub x-tal pins (PE[1:0]): LPUART runs from XSOSC in power-down
+   HAL_SCU_SubXtal_PinConfig();
+#endif
+
    // enable clock source
    HAL_SCU_ClockSource_Enable( CLKSRCR_HIRCEN | CLKSRCR_XMOSCEN | CLKSRCR_XSOSCEN | CLKSRCR_WDTRCEN, HIRCSEL_HIRC1 );
    for( i = 0; i < 1000; i++ );  // Clock Stable Time
@@ -101,7 +107,11 @@ void SystemClock_Config( void )
 #endif
 
    // disable unused clock source
+#ifdef METER_LPUART_WAKE
+   HAL_SCU_ClockSource_Disable( CLKSRCR_XMOSCEN );    // keep XSOSC for LPUART
+#else
    HAL_SCU_ClockSource_Disable( CLKSRCR_XMOSCEN | CLKSRCR_XSOSCEN );
+#endif
 
    // enable clock monitoring
    HAL_SCU_ClockMonitoring( MACTS_SysClkChg, MONCS_MCLK );
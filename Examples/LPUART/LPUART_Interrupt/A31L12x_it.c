@@ -16,6 +16,10 @@
 
 #include "main_conf.h"
 #include "meter_protocol.h"
+#include "meter_log.h"
+#include "meter_nor.h"
+#include "meter_power.h"
+#include "meter_event.h"
 
 /* Private typedef ---------------------------------------------------------- */
 /* Private define ----------------------------------------------------------- */
@@ -88,6 +92,31 @@ void SysTick_Handler( void )
 /*  file (startup_A31L12x.s).                                                 */
 /******************************************************************************/
 
+/*-------------------------------------------------------------------------*//**
+ * @brief         This function handles LVI Handler.
+ * @param         None
+ * @return        None
+ * @details       저전압 경고: 대기 검침 레코드를 flash에 긴급 기록
+ *                (로그 변경 중이면 서비스 이벤트의 MeterLog_Task()로 미뤄짐)
+ *//*-------------------------------------------------------------------------*/
+void LVI_Handler( void )
+{
+   SCULV_ClrLviFlag();
+   MeterLog_EmergencyFlush();
+   MeterEvent_Post( METER_EVT_SERVICE, 0, 0, NULL );
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         This function handles TIMER50 Handler.
+ * @param         None
+ * @return        None
+ * @details       저전력 스케줄러 깨움 타이머 (METER_POWER_TIMER)
+ *//*-------------------------------------------------------------------------*/
+void TIMER50_Handler( void )
+{
+   MeterPower_TimerHandler();
+}
+
 /*-------------------------------------------------------------------------*//**
  * @brief         This function handles LPUART Handler.
  * @param         None
@@ -96,5 +125,66 @@ void SysTick_Handler( void )
 void LPUART_Handler( void )
 {
    LPUART_IRQHandler_IT();
+   MeterEvent_Post( METER_EVT_SERVICE, 0, 0, NULL );
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         This function handles UART0 Handler.
+ * @param         None
+ * @return        None
+ * @details       UART0 계량기 포트 (UART1은 디버그 포트로 사용하므로 핸들러 없음)
+ *//*-------------------------------------------------------------------------*/
+void UART0_Handler( void )
+{
+   Meter_PortIRQHandler( METER_PORT_UART0 );
+   MeterEvent_Post( METER_EVT_SERVICE, 0, 0, NULL );
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         This function handles USART10 Handler.
+ * @param         None
+ * @return        None
+ * @details       USART10 계량기 포트 (UART 모드)
+ *//*-------------------------------------------------------------------------*/
+void USART10_Handler( void )
+{
+   Meter_PortIRQHandler( METER_PORT_USART10 );
+   MeterEvent_Post( METER_EVT_SERVICE, 0, 0, NULL );
+}
+
+#ifdef _DEBUG_MSG_BUFFERED
+/*-------------------------------------------------------------------------*//**
+ * @brief         This function handles DMAC1 Handler.
+ * @param         None
+ * @return        None
+ * @details       디버그 출력 DMA 전송 완료 (DEBUG_TX_DMA_CHANNEL)
+ *//*-------------------------------------------------------------------------*/
+void DMAC1_Handler( void )
+{
+   debug_frmwrk_dma_handler();
+}
+#endif
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         This function handles DMAC2 Handler.
+ * @param         None
+ * @return        None
+ * @details       외부 NOR 쓰기 데이터 전송 완료 (METER_NOR_TX_DMA_CHANNEL)
+ *//*-------------------------------------------------------------------------*/
+void DMAC2_Handler( void )
+{
+   MeterNor_DmaHandler();
+   MeterEvent_Post( METER_EVT_SERVICE, 0, 0, NULL );
 }
 
+/*-------------------------------------------------------------------------*//**
+ * @brief         This function handles DMAC3 Handler.
+ * @param         None
+ * @return        None
+ * @details       외부 NOR 읽기 데이터 수신 완료 (METER_NOR_RX_DMA_CHANNEL)
+ *//*-------------------------------------------------------------------------*/
+void DMAC3_Handler( void )
+{
+   MeterNor_DmaHandler();
+   MeterEvent_Post( METER_EVT_SERVICE, 0, 0, NULL );
+}
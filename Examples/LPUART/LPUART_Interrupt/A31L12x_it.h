@@ -41,7 +41,16 @@ void DebugMon_Handler( void );
 void PendSV_Handler( void );
 void SysTick_Handler( void );
 
+void LVI_Handler( void );
+void TIMER50_Handler( void );
 void LPUART_Handler( void );
+void UART0_Handler( void );
+void USART10_Handler( void );
+#ifdef _DEBUG_MSG_BUFFERED
+void DMAC1_Handler( void );
+#endif
+void DMAC2_Handler( void );
+void DMAC3_Handler( void );
 
 #ifdef __cplusplus
 }
@@ -21,6 +21,18 @@
 #include "main_conf.h"
 #include <string.h>
 #include "meter_protocol.h"
+#include "meter_trace.h"
+#include "meter_record.h"
+#include "meter_log.h"
+#include "meter_retain.h"
+#include "meter_flash.h"
+#include "meter_nor.h"
+#include "meter_history.h"
+#include "meter_nor_cache.h"
+#include "meter_codec.h"
+#include "meter_power.h"
+#include "meter_event.h"
+#include "meter_clock.h"
 
 
 /* Private typedef ---------------------------------------------------------- */
@@ -39,23 +51,63 @@ void LPUART_IRQHandler_IT( void );
 void DEBUG_Init( void );
 void DEBUG_MenuPrint( void );
 void LPUART_Configure( void );
+#ifdef METER_LPUART_WAKE
+bool LPUART_WaitSubXtal( void );
+#endif
 void LPUART_InterruptRun( void );
 void mainloop( void );
 int main( void );
 void Error_Handler( void );
 
 // Meter protocol callback function prototypes
-void OnMeterResponseReceived( uint8_t* data, uint16_t length );
-void OnMeterError( METER_ERROR_Type error );
+void OnMeterResponseReceived( METER_PORT_Type port, uint8_t* data, uint16_t length );
+void OnMeterError( METER_PORT_Type port, METER_ERROR_Type error );
+void Handle_Service( const MeterEvent_t* evt );
+void Handle_Poll( const MeterEvent_t* evt );
+void Handle_Frame( const MeterEvent_t* evt );
+void Handle_Error( const MeterEvent_t* evt );
+void Handle_Key( const MeterEvent_t* evt );
 void Test_Protocol_Parser( void );
+void Test_BCD_Benchmark( void );
+void Print_Flash_Log( void );
+void Print_Link_Stats( void );
+void Print_History( void );
+void Scan_History( void );
+void Query_History( void );
+void Test_Codec_Benchmark( void );
+void Print_Event_Stats( void );
+void Record_RestoreTime( void );
 
 //******************************************************************************
 // Constant
 //******************************************************************************
 
+// Meter poll period (tickless: the MCU sleeps/powers down between polls)
+#define METER_POLL_INTERVAL_MS   5000
+
 // ring buffer size
 #define RING_BUF_SIZE      32
 
+// UART1 debug port baud rate (set by debug_frmwrk_init, retuned on clock level changes)
+#define DEBUG_BAUDRATE     38400
+
+// BCD benchmark sample count (measured with IRQ masked, must stay within one SysTick period)
+#define BCD_BENCH_COUNT    16
+
+// NOR history records printed by 'h' (newest), records per read burst
+#define HISTORY_PRINT_COUNT   16
+#define HISTORY_PRINT_BURST   4
+
+// NOR history full scan by 'x': records per read (one NOR page)
+#define HISTORY_SCAN_BURST    ( METER_NOR_PAGE_SIZE / METER_RECORD_SIZE )
+
+// NOR history time range query by 'q': readings within this many seconds of the newest one
+#define HISTORY_QUERY_SECONDS 3600
+
+// Reading series compression benchmark by 'c': newest NOR history records examined, block size
+#define CODEC_BENCH_COUNT     256
+#define CODEC_BENCH_BLOCK     256
+
 //******************************************************************************
 // Type
 //******************************************************************************
@@ -107,6 +159,15 @@ const uint8_t menu[] =  "************************************************\n\r"
                         "UART RXD Pin:      PB4(LPRXD) \n\r"
                         "************************************************\n\r"
                         "Press 't' to run Protocol Parser Test\n\r"
+                        "Press 'b' to run BCD Decode Benchmark\n\r"
+                        "Press 'l' to dump binary trace log (tools/trace_decode.py)\n\r"
+                        "Press 'f' to print readings stored in flash log\n\r"
+                        "Press 's' to print link statistics (retained SRAM)\n\r"
+                        "Press 'h' to print readings stored in external NOR history\n\r"
+                        "Press 'x' to scan whole NOR history through the read cache\n\r"
+                        "Press 'q' to look up the last hour of NOR history by timestamp\n\r"
+                        "Press 'c' to run reading series compression benchmark\n\r"
+                        "Press 'e' to print event handler statistics (then reset)\n\r"
                         "************************************************\n\r\n\r";
 
 // ring buffer
@@ -115,6 +176,13 @@ RING_BUF                rb;
 // Current Tx Interrupt enable state
 volatile FlagStatus     TxIntStat;
 
+// XSOSC confirmed running: LPUART with RCD wake-up and TIMER50 run from it
+// (false: LPUART on PCLK, TIMER50 on WDTRC; no sub x-tal or METER_LPUART_WAKE undefined)
+static bool             lpuart_xsosc;
+
+// NOR history read buffer shared by 'h', 'x', 'q' and 'c' (static: 512-byte default stack)
+static MeterRecord_t    history_rec[HISTORY_SCAN_BURST];
+
 //******************************************************************************
 // Function
 //******************************************************************************
@@ -302,18 +370,35 @@ void LPUART_IRQHandler_IT( void )
    // get interrupt flag
    intsrc = HAL_LPUART_GetStatus();
 
+#ifdef METER_RX_HW_DELIMIT
+   // if Character Detect / Receive Time-Out Interrupt
+   if( intsrc & ( LPUART_IFSR_RCDIFLAG_Msk | LPUART_IFSR_RTOIFLAG_Msk ) )
+   {
+      // Meter frame is delimited by hardware (RCD: start, DMA: body, RTO: end)
+      Meter_RxIRQHandler( ( uint8_t )intsrc );
+      // Clear RX interrupt flags
+      HAL_LPUART_ClearStatus( LPUART_STATUS_RCDIFLAG );
+      HAL_LPUART_ClearStatus( LPUART_STATUS_RTOIFLAG );
+   }
+#else
    // if Receive Complete Interrupt
    if( ( intsrc & LPUART_IFSR_RXCIFLAG_Msk ) == LPUART_IFSR_RXCIFLAG_Msk )
    {
-      IntReceive();
+      // Meter frame is assembled from the port byte ring in Meter_Task()
+      Meter_RxByteIRQHandler( METER_PORT_LPUART, HAL_LPUART_ReceiveByte() );
       // Clear RX interrupt flag
       HAL_LPUART_ClearStatus( LPUART_STATUS_RXCIFLAG );
    }
+#endif
 
    // if Transmit Complete Interrupt
    if( ( intsrc & LPUART_IFSR_TXCIFLAG_Msk ) == LPUART_IFSR_TXCIFLAG_Msk )
    {
-      IntTransmit();
+      // Meter frame transfer owns the transmitter first, ring buffer otherwise
+      if( Meter_TxIRQHandler( METER_PORT_LPUART ) == 0 )
+      {
+         IntTransmit();
+      }
       // Clear TX interrupt flag
       HAL_LPUART_ClearStatus( LPUART_STATUS_TXCIFLAG );
    }
@@ -357,6 +442,39 @@ void DEBUG_MenuPrint( void )
 #endif
 }
 
+#ifdef METER_LPUART_WAKE
+/*-------------------------------------------------------------------------*//**
+ * @brief         Check that the sub x-tal (XSOSC) runs before clocking LPUART and TIMER50 from it
+ * @param         None
+ * @return        true: XSOSC ready for METER_LPUART_XSOSC_SETTLE_MS, false: not started within METER_LPUART_XSOSC_WAIT_MS
+ * @details       The clock monitor watches XSOSC (flag only) while waiting, then goes back to MCLK with
+ *                system clock change. Counted with the SysTick COUNTFLAG (1ms), works before interrupts are enabled.
+ *                The oscillator is started by SystemClock_Config().
+ *//*-------------------------------------------------------------------------*/
+bool LPUART_WaitSubXtal( void )
+{
+   uint32_t    ms;
+   uint32_t    settled;
+
+   HAL_SCU_ClockMonitoring( MACTS_FlagChk, MONCS_XSOSC );
+   ( void )SysTick->CTRL;    // clear COUNTFLAG
+
+   for( ms = 0, settled = 0; ( ms < METER_LPUART_XSOSC_WAIT_MS ) && ( settled < METER_LPUART_XSOSC_SETTLE_MS ); )
+   {
+      if( SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk )
+      {
+         ms++;
+         settled = SCUCG_GetMonFlag() ? ( settled + 1 ) : 0;   // MONFLAG 1: monitored clock ready
+      }
+   }
+
+   HAL_SCU_ClockMonitoring_Disable();
+   HAL_SCU_ClockMonitoring( MACTS_SysClkChg, MONCS_MCLK );
+
+   return ( settled >= METER_LPUART_XSOSC_SETTLE_MS );
+}
+
+#endif
 /*-------------------------------------------------------------------------*//**
  * @brief         LPUART_Configure
  * @param         None
@@ -417,19 +535,49 @@ void LPUART_Configure( void )
          LPUART_Config.Baudrate = 1200;
          _DBG( "Baudrate: 1200 bps\n\r" );
 
-         // select peripheral clock: PCLK
-         HAL_SCU_Peripheral_ClockSelection( PPCLKSR_LPUTCLK, LPUTCLK_PCLK );
-         LPUART_Config.BaseClock = SystemPeriClock;
+#ifdef METER_LPUART_WAKE
+         // select peripheral clock: XSOSC (keeps running in power-down, 27 clocks per bit), checked in main()
+         if( lpuart_xsosc )
+         {
+            HAL_SCU_Peripheral_ClockSelection( PPCLKSR_LPUTCLK, LPUTCLK_XSOSC );
+            LPUART_Config.BaseClock = METER_LPUART_XSOSC_HZ;
+            LPUART_Config.OverSampling = LPUART_OVRS_1;
+         }
+         else
+         {
+            // no sub x-tal: fall back to PCLK (response wait in sleep mode)
+            _DBG( "XSOSC not ready, LPUART falls back to PCLK\n\r" );
+         }
+         if( !lpuart_xsosc )
+#endif
+         {
+            // select peripheral clock: PCLK
+            HAL_SCU_Peripheral_ClockSelection( PPCLKSR_LPUTCLK, LPUTCLK_PCLK );
+            LPUART_Config.BaseClock = SystemPeriClock;
+         }
          _DBG( "Base Clock: " );
-         _DBD32( SystemPeriClock );
+         _DBD32( LPUART_Config.BaseClock );
          _DBG( " Hz\n\r" );
 
          // init LPUART
          HAL_LPUART_Init( &LPUART_Config );
+#ifdef METER_LPUART_WAKE
+         if( lpuart_xsosc )
+         {
+            // 1213.6 bps -> 1200.3 bps: one extra clock on 3 of 9 bits
+            LPUART->BCMP = METER_LPUART_XSOSC_BCMP;
+
+            // RCD match wakes the core from power-down (armed by Meter_Init)
+            HAL_LPUART_DataControlConfig( LPUART_CONTROL_WAKEN, ENABLE );
+         }
+#endif
          _DBG( "LPUART Initialized\n\r" );
 
          // enable interrupt
+#ifndef METER_RX_HW_DELIMIT
+         // (METER_RX_HW_DELIMIT: RX interrupts are armed by Meter_Init via RCD)
          HAL_LPUART_ConfigInterrupt( LPUART_INTCFG_RXCIEN, ENABLE );
+#endif
          HAL_LPUART_ConfigInterrupt( LPUART_INTCFG_TXCIEN, ENABLE );
          _DBG( "Interrupts Enabled (RX/TX)\n\r" );
 
@@ -448,6 +596,11 @@ void LPUART_Configure( void )
          _DBH( (uint8_t)(LPUART->BDR & 0xFF) );
          _DBG( "\n\r" );
 
+         _DBG( "  BCMP: 0x" );
+         _DBH( (uint8_t)((LPUART->BCMP >> 8) & 0xFF) );
+         _DBH( (uint8_t)(LPUART->BCMP & 0xFF) );
+         _DBG( "\n\r" );
+
          _DBG( "========================================\n\r\n\r" );
       }
 
@@ -496,39 +649,156 @@ void LPUART_Configure( void )
 
 /*-------------------------------------------------------------------------*//**
  * @brief         Meter response received callback
+ * @param         port - Meter port the response arrived on
  * @param         data - Received data
  * @param         length - Data length
  * @return        None
+ * @details       Held frame buffers (LPUART hardware RX) are handed to the event
+ *                queue and processed by Handle_Frame() after Meter_Task() returns.
+ *                Frames assembled in software are only valid during the callback
+ *                and are processed here.
  *//*-------------------------------------------------------------------------*/
-// Global buffer to store received meter data
-static uint8_t g_meter_rx_data[256];
-static uint16_t g_meter_rx_length = 0;  // Length of last received frame
+void OnMeterResponseReceived( METER_PORT_Type port, uint8_t* data, uint16_t length )
+{
+   MeterEvent_t   evt;
 
-void OnMeterResponseReceived( uint8_t* data, uint16_t length )
+   if( Meter_FrameIsHeld( data ) &&
+       MeterEvent_Post( METER_EVT_FRAME, (uint8_t)port, length, data ) )
+   {
+      return;
+   }
+
+   evt.id = METER_EVT_FRAME;
+   evt.arg = (uint8_t)port;
+   evt.len = length;
+   evt.ptr = data;
+   Handle_Frame( &evt );
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         Meter error callback
+ * @param         port - Meter port the error occurred on
+ * @param         error - Error code
+ * @return        None
+ *//*-------------------------------------------------------------------------*/
+void OnMeterError( METER_PORT_Type port, METER_ERROR_Type error )
 {
-   // Store data to global buffer for later use
-   if( length <= sizeof( g_meter_rx_data ) )
+   // Reported from the event queue (dropped if the low priority ring is full)
+   MeterEvent_Post( METER_EVT_ERROR, (uint8_t)port, (uint16_t)error, NULL );
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         Service event: protocol, flash log and NOR tasks, debug key input
+ * @param         evt - METER_EVT_SERVICE (posted by interrupts and on every wake-up)
+ * @return        None
+ *//*-------------------------------------------------------------------------*/
+void Handle_Service( const MeterEvent_t* evt )
+{
+   (void)evt;
+
+   // Execute meter protocol task (RX processing and timeout check on every port)
+   Meter_Task();
+
+   // Write pending log records on deadline (or a low voltage flush deferred by the LVI interrupt)
+   if( MeterLog_Task() != METER_LOG_OK )
+   {
+      _DBG( "[ERROR] Flash log write failed\n\r" );
+   }
+
+   // External NOR: program/erase completion, history writes, deep power-down when idle
+   MeterNor_Task();
+   MeterHistory_Task();
+
+   // Check for debug UART input (UART1 has no interrupt here, polled on every service run)
+   if( HAL_UART_GetLineStatus( (UARTn_Type*)UART1 ) & UARTn_LSR_RDR )
    {
-      memcpy( g_meter_rx_data, data, length );
-      g_meter_rx_length = length;
+      // Stay awake for the next key (UART1 cannot wake the MCU from power-down)
+      MeterPower_Hold( METER_POWER_CONSOLE_MS );
 
-      // Prevent unused variable warning
-      (void)g_meter_rx_length;
+      MeterEvent_Post( METER_EVT_KEY, HAL_UART_ReceiveByte( (UARTn_Type*)UART1 ), 0, NULL );
    }
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         Poll event: send the read command to every meter port
+ * @param         evt - METER_EVT_POLL (periodic timer, METER_POLL_INTERVAL_MS)
+ * @return        None
+ *//*-------------------------------------------------------------------------*/
+void Handle_Poll( const MeterEvent_t* evt )
+{
+   // Actual TX frame: 10-5B-01-5C-16
+   uint8_t     test_data[] = { 0x5C };  // Data 1 byte
+   uint8_t     meter_cmd = 0x5B;        // Command
+   uint8_t     ports;
+
+   (void)evt;
 
+   _DBG( "\n\rSending command to meters (Frame: 10-5B-01-5C-16)...\n\r" );
+
+#ifdef _DEBUG_MSG_BUFFERED
+   if( debug_frmwrk_get_drops() != 0 )
+   {
+      cprintf( "Debug output dropped: %lu bytes\n\r", debug_frmwrk_get_drops() );
+   }
+#endif
+
+   // Send command to every meter port at once (returns immediately,
+   // preamble/TX/response wait of all ports overlap in interrupts)
+   // TX Frame: [0x10] [0x5B] [0x01] [0x5C] [0x16]
+   //            HEADER  CMD    LEN   DATA   CHECKSUM
+   METER_RETAIN->state.sched.poll_count++;
+   (void)Meter_RecordTime();        // keep record time across the 49.7-day tick wrap
+   ports = Meter_PollAll(
+      meter_cmd,                     // Command: 0x5B
+      test_data,                     // Data: 0x5C
+      sizeof( test_data )            // Data length: 1
+   );
+
+   if( ports == 0 )
+   {
+      _DBG( "Failed to send command\n\r" );
+   }
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         Frame event: parse, print and store a meter response
+ * @param         evt - METER_EVT_FRAME (arg: port, len: length, ptr: frame buffer)
+ * @return        None
+ * @details       The frame buffer is returned with Meter_ReleaseFrame() at the end.
+ *//*-------------------------------------------------------------------------*/
+void Handle_Frame( const MeterEvent_t* evt )
+{
    // 범용 파서 사용: 자동 버전 감지 및 파싱
    MeterData_t parsed_data;
+   uint8_t*    data = (uint8_t*)evt->ptr;
+   uint16_t    length = evt->len;
 
    _DBG( "\n\r" );
    _DBG( "====================================\n\r" );
-   _DBG( "  Meter Response Received\n\r" );
+   _DBG( "  Meter Response Received (port " );
+   _DBD( evt->arg );
+   _DBG( ")\n\r" );
    _DBG( "====================================\n\r" );
 
-   // 프레임 파싱 시도
-   if( Meter_ParseFrame( data, length, &parsed_data ) )
+   // 프레임 파싱 시도 (수신 중 누적한 체크섬 사용)
+   const METER_RX_FRAME_Type* rx = Meter_GetFrameInfo( data );
+
+   if( ( rx != NULL ) ? Meter_ParseRxFrame( rx, &parsed_data ) : Meter_ParseFrame( data, length, &parsed_data ) )
    {
       // 파싱 성공: 구조화된 데이터 출력
       Meter_PrintParsedData( &parsed_data );
+
+      // 검침 레코드를 flash 로그에 저장 (유지 SRAM 대기열 14개가 차거나 4시간 기한, LVI 경고 시 기록)
+      MeterRecord_t  rec;
+
+      Meter_RecordEncode( &parsed_data, Meter_RecordTime(), &rec );
+      if( MeterLog_Write( &rec ) != METER_LOG_OK )
+      {
+         _DBG( "[ERROR] Flash log write failed\n\r" );
+      }
+
+      // Long-term history on external NOR (written from the main loop, never blocks here)
+      MeterHistory_Append( &rec );
    }
    else
    {
@@ -552,18 +822,24 @@ void OnMeterResponseReceived( uint8_t* data, uint16_t length )
       }
       _DBG( "\n\r====================================\n\r\n\r" );
    }
+
+   // Frame buffer can be reused for the next response
+   Meter_ReleaseFrame( data );
 }
 
+
 /*-------------------------------------------------------------------------*//**
- * @brief         Meter error callback
- * @param         error - Error code
+ * @brief         Error event: print a protocol error
+ * @param         evt - METER_EVT_ERROR (arg: port, len: METER_ERROR_Type)
  * @return        None
  *//*-------------------------------------------------------------------------*/
-void OnMeterError( METER_ERROR_Type error )
+void Handle_Error( const MeterEvent_t* evt )
 {
-   _DBG( "Meter Error: " );
+   _DBG( "Meter Error (port " );
+   _DBD( evt->arg );
+   _DBG( "): " );
 
-   switch( error )
+   switch( (METER_ERROR_Type)evt->len )
    {
       case METER_ERR_TIMEOUT:
          _DBG( "Timeout\n\r" );
@@ -586,6 +862,98 @@ void OnMeterError( METER_ERROR_Type error )
    }
 }
 
+/*-------------------------------------------------------------------------*//**
+ * @brief         Key event: debug menu command
+ * @param         evt - METER_EVT_KEY (arg: received character)
+ * @return        None
+ * @details       Runs at low priority: frames and service work posted while a
+ *                test or dump is running are handled right after it returns.
+ *//*-------------------------------------------------------------------------*/
+void Handle_Key( const MeterEvent_t* evt )
+{
+   uint8_t     ch = evt->arg;
+
+   // Press 't' to run Protocol Parser Test
+   if( ch == 't' || ch == 'T' )
+   {
+      _DBG( "\n\rRunning Protocol Parser Test...\n\r" );
+      Test_Protocol_Parser();
+      _DBG( "Test complete. Press 't' again to re-run.\n\r\n\r" );
+   }
+   else if( ch == 'b' || ch == 'B' )
+   {
+      // Compute-bound work runs at the high clock level
+      MeterClock_Boost();
+      Test_BCD_Benchmark();
+      MeterClock_Release();
+   }
+   else if( ch == 'l' || ch == 'L' )
+   {
+      Trace_Dump();
+   }
+   else if( ch == 'f' || ch == 'F' )
+   {
+      Print_Flash_Log();
+   }
+   else if( ch == 's' || ch == 'S' )
+   {
+      Print_Link_Stats();
+   }
+   else if( ch == 'h' || ch == 'H' )
+   {
+      Print_History();
+   }
+   else if( ch == 'x' || ch == 'X' )
+   {
+      Scan_History();
+   }
+   else if( ch == 'q' || ch == 'Q' )
+   {
+      Query_History();
+   }
+   else if( ch == 'c' || ch == 'C' )
+   {
+      MeterClock_Boost();
+      Test_Codec_Benchmark();
+      MeterClock_Release();
+   }
+   else if( ch == 'e' || ch == 'E' )
+   {
+      Print_Event_Stats();
+   }
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         Continue record timestamps after the newest stored reading
+ * @param         None
+ * @return        None
+ * @details       No RTC: record time counts on from the newest timestamp in the
+ *                pending queue, the newest flash log page or the NOR history, so
+ *                readings stored after a reset never go back in time (history range lookups).
+ *//*-------------------------------------------------------------------------*/
+void Record_RestoreTime( void )
+{
+   const MeterLogPage_t*   page;
+   const MeterRecord_t*    pending;
+   uint8_t                 pending_count;
+   uint32_t                last = MeterHistory_GetLastStamp();
+
+   pending_count = MeterLog_GetPending( &pending );
+   if( pending_count != 0 && pending[pending_count - 1].timestamp > last )
+   {
+      last = pending[pending_count - 1].timestamp;
+   }
+
+   page = MeterLog_GetPage( 0 );
+   if( page != NULL && page->header.count != 0 && page->rec[page->header.count - 1].timestamp > last )
+   {
+      last = page->rec[page->header.count - 1].timestamp;
+   }
+
+   Meter_RecordTimeInit( last );
+   cprintf( "Record time: %lu s\n\r", Meter_RecordTime() );
+}
+
 /*-------------------------------------------------------------------------*//**
  * @brief         LPUART_InterruptRun
  * @param         None
@@ -593,77 +961,79 @@ void OnMeterError( METER_ERROR_Type error )
  *//*-------------------------------------------------------------------------*/
 void LPUART_InterruptRun( void )
 {
-   // Actual TX frame: 10-5B-01-5C-16
-   uint8_t     test_data[] = { 0x5C };  // Data 1 byte
-   uint8_t     meter_cmd = 0x5B;        // Command
-   uint8_t     meter_addr = 0x01;       // Address (not used)
-   volatile uint32_t delay;
+   uint8_t     retained;
+
+   // Restore pending readings, link statistics and scheduler state kept in retained SRAM
+   // (must precede Meter_Init/MeterLog_Mount: sets link statistics storage, pending queue)
+   retained = MeterRetain_Restore();
+
+   // Application work runs to completion from the event queue
+   // (frames first so the RX buffer is returned quickly, debug commands last)
+   MeterEvent_Subscribe( METER_EVT_FRAME, METER_EVENT_PRIO_HIGH, 0, Handle_Frame );
+   MeterEvent_Subscribe( METER_EVT_SERVICE, METER_EVENT_PRIO_NORMAL, METER_EVENT_COALESCE, Handle_Service );
+   MeterEvent_Subscribe( METER_EVT_POLL, METER_EVENT_PRIO_NORMAL, METER_EVENT_COALESCE, Handle_Poll );
+   MeterEvent_Subscribe( METER_EVT_ERROR, METER_EVENT_PRIO_LOW, 0, Handle_Error );
+   MeterEvent_Subscribe( METER_EVT_KEY, METER_EVENT_PRIO_LOW, 0, Handle_Key );
 
-   // Initialize meter protocol
-   Meter_Init();
+   // Initialize meter protocol (one instance per configured port)
+   // Additional meters: configure UART0/USART10 at 1200bps 8-N-1, enable their NVIC
+   // interrupt, then call Meter_Init( METER_PORT_UART0 ) etc. with the same callbacks.
+   Meter_Init( METER_PORT_LPUART );
 
    // Register callback functions
-   Meter_SetResponseCallback( OnMeterResponseReceived );
-   Meter_SetErrorCallback( OnMeterError );
+   Meter_SetResponseCallback( METER_PORT_LPUART, OnMeterResponseReceived );
+   Meter_SetErrorCallback( METER_PORT_LPUART, OnMeterError );
+
+   // LPUART runs from XSOSC with WAKEN: the response wait powers down until the 0x68 start
+   // (PCLK fallback without a sub x-tal: the response wait stays in sleep mode)
+   Meter_SetRxWake( METER_PORT_LPUART, lpuart_xsosc );
 
    _DBG( "\n\rSeoul Digital Water Meter Protocol Initialized\n\r" );
    _DBG( "Baudrate: 1200 bps, Format: 8-N-1\n\r" );
-   _DBG( "Auto Version Detection: V1.1, V1.2, V1.3, V1.4\n\r\n\r" );
-
-   /* Infinite loop */
-   while( 1 )
-   {
-      // Execute meter protocol task (RX processing and timeout check)
-      Meter_Task();
+   _DBG( "Auto Version Detection: V1.1, V1.2, V1.3, V1.4\n\r" );
 
-      // Check for debug UART input (UART1)
-      // Press 't' to run Protocol Parser Test
-      if( HAL_UART_GetLineStatus( (UARTn_Type*)UART1 ) & UARTn_LSR_RDR )
-      {
-         uint8_t ch = HAL_UART_ReceiveByte( (UARTn_Type*)UART1 );
+   // Low voltage warning flushes pending log records from the LVI interrupt
+   HAL_LVI_Init( LVIEN_Enable, LVINTEN_Enable, METER_LOG_LVI_LEVEL );
 
-         if( ch == 't' || ch == 'T' )
-         {
-            _DBG( "\n\rRunning Protocol Parser Test...\n\r" );
-            Test_Protocol_Parser();
-            _DBG( "Test complete. Press 't' again to re-run.\n\r\n\r" );
-         }
-      }
+   // Restore flash log head (binary search over page sequence numbers)
+   cprintf( "Flash log: %u/%u pages", MeterLog_Mount(), METER_LOG_PAGE_COUNT );
+   cprintf( ", %u uncommitted page(s) discarded\n\r", MeterLog_GetStats()->recovered );
+   NVIC_EnableIRQ( LVI_IRQn );
 
-      // Test: Send command every 5 seconds
-      static uint32_t tick_counter = 0;
+   // External NOR history (deep power-down between accesses)
+   if( MeterNor_Init() == METER_NOR_OK )
+   {
+      cprintf( "NOR history: %lu slots\n\r", MeterHistory_Mount() );
+   }
+   else
+   {
+      _DBG( "NOR history: P25Q16 not found (JEDEC ID mismatch)\n\r" );
+   }
 
-      tick_counter++;
+   // Record timestamps must not go back after a reset (uptime restarts at 0)
+   Record_RestoreTime();
 
-      // Send every ~5 seconds (adjust based on loop speed)
-      if( tick_counter >= 500000 )
-      {
-         tick_counter = 0;
+   cprintf( "Retained SRAM: queue %s (%u pending), state %s (warm start %lu)\n\r",
+            ( retained & METER_RETAIN_QUEUE_OK ) ? "restored" : "cleared", METER_RETAIN->queue.count,
+            ( retained & METER_RETAIN_STATE_OK ) ? "restored" : "cleared", METER_RETAIN->state.sched.warm_starts );
 
-         _DBG( "\n\rSending command to meter (Frame: 10-5B-01-5C-16)...\n\r" );
+   // Clock level changes retune the PCLK baud divisors (XSOSC-clocked LPUART is not affected)
+   MeterClock_Attach( METER_CLOCK_DEV_UART, UART1, DEBUG_BAUDRATE, METER_PORT_MAX );
+   MeterClock_Attach( METER_CLOCK_DEV_SPI, METER_NOR_SPI, METER_NOR_SPI_BAUD, METER_PORT_MAX );
+   if( !lpuart_xsosc )
+   {
+      MeterClock_Attach( METER_CLOCK_DEV_LPUART, LPUART, 1200, METER_PORT_LPUART );
+   }
 
-         // Send command to meter
-         // TX Frame: [0x10] [0x5B] [0x01] [0x5C] [0x16]
-         //            HEADER  CMD    LEN   DATA   CHECKSUM
-         METER_ERROR_Type err = Meter_SendCommand(
-            meter_addr,                    // Meter address (not used)
-            meter_cmd,                     // Command: 0x5B
-            test_data,                     // Data: 0x5C
-            sizeof( test_data )            // Data length: 1
-         );
+   // Drop to the low clock level (boosted only for compression and flash log writes)
+   MeterClock_Release();
+   cprintf( "System clock: %lu Hz (boost %lu Hz)\n\r\n\r", SystemCoreClock, METER_CLOCK_HIGH_HZ );
 
-         if( err != METER_ERR_NONE )
-         {
-            _DBG( "Failed to send command\n\r" );
-         }
-      }
+   // Test: Send command every METER_POLL_INTERVAL_MS
+   MeterEvent_SetTimer( METER_EVT_POLL, METER_POLL_INTERVAL_MS );
 
-      // 작은 지연
-      for( delay = 0; delay < 100; delay++ )
-      {
-         __NOP();
-      }
-   }
+   // Dispatch events, sleep until the next timer, log deadline or interrupt when the queue is empty
+   MeterEvent_Run();
 }
 
 /*-------------------------------------------------------------------------*//**
@@ -684,6 +1054,11 @@ void mainloop( void )
    /* Enable IRQ Interrupts */
    __enable_irq();
 
+#ifdef _DEBUG_MSG_BUFFERED
+   /* Debug output from here on is queued and drained by DMA (no blocking in callbacks) */
+   debug_frmwrk_buffered( ENABLE );
+#endif
+
    /* LPUART hardware stabilization delay */
    for( delay = 0; delay < 500000; delay++ );
 
@@ -707,17 +1082,76 @@ int main( void )
    /* Initialize Debug frame work through initializing USART port  */
    DEBUG_Init();
 
+   /* Move vector table to RAM: SysTick keeps counting while flash is erased/written */
+   MeterFlash_Init();
+
    /* Configure SysTick for 1ms tick (Meter protocol timeout support) */
    // SystemCoreClock = 32MHz
    // SysTick_Config(32000) = 1ms 인터럽트
    SysTick_Config( SystemCoreClock / 1000 );
 
+#ifdef METER_LPUART_WAKE
+   /* Sub x-tal check (counts SysTick): clocks LPUART and TIMER50 if it oscillates, stopped otherwise */
+   lpuart_xsosc = LPUART_WaitSubXtal();
+   if( !lpuart_xsosc )
+   {
+      HAL_SCU_ClockSource_Disable( CLKSRCR_XSOSCEN );
+   }
+#endif
+
+   /* Power-down wake-up timer (TIMER50 on XSOSC at 1024Hz, WDTRC at 1ms without sub x-tal) */
+   MeterPower_Init( lpuart_xsosc );
+
+   /* Event queue (interrupts may post from here on) */
+   MeterEvent_Init();
+
+   /* Clock levels: held at HSI 32MHz until the peripherals are registered */
+   MeterClock_Init();
+
    /* Infinite loop */
    mainloop();
 
    return 0;
 }
 
+/*-------------------------------------------------------------------------*//**
+ * @brief         레코드 변환 확인 (MeterData_t → 16바이트 레코드 → MeterData_t)
+ * @param         data: 파싱된 데이터
+ * @return        None
+ *//*-------------------------------------------------------------------------*/
+static void Test_Record_RoundTrip( const MeterData_t* data )
+{
+   static MeterData_t   decoded;    // static: 512-byte default stack
+   MeterRecord_t        rec;
+   const uint8_t*       raw = (const uint8_t*)&rec;
+   uint8_t              i;
+
+   Meter_RecordEncode( data, Meter_RecordTime(), &rec );
+   Meter_RecordDecode( &rec, &decoded );
+
+   _DBG( "  Record (" );
+   _DBD( sizeof( rec ) );
+   _DBG( " bytes):" );
+   for( i = 0; i < sizeof( rec ); i++ )
+   {
+      _DBG( " " );
+      _DBH( raw[i] );
+   }
+
+   if( decoded.version == data->version && decoded.meter_id == data->meter_id &&
+       decoded.reading_value == data->reading_value && decoded.decimal_point == data->decimal_point &&
+       decoded.diameter_mm == data->diameter_mm &&
+       memcmp( decoded.reading_bcd, data->reading_bcd, 4 ) == 0 &&
+       memcmp( &decoded.status, &data->status, sizeof( MeterStatus_t ) ) == 0 )
+   {
+      _DBG( " [OK]\r\n\r\n" );
+   }
+   else
+   {
+      _DBG( " [MISMATCH]\r\n\r\n" );
+   }
+}
+
 /*-------------------------------------------------------------------------*//**
  * @brief         프로토콜 파서 테스트 함수 (V1.1~V1.4 샘플 데이터)
  * @param         None
@@ -761,6 +1195,7 @@ void Test_Protocol_Parser( void )
    if (Meter_ParseFrame(frame_v11, sizeof(frame_v11), &parsed_data))
    {
       Meter_PrintParsedData(&parsed_data);
+      Test_Record_RoundTrip(&parsed_data);
    }
    else
    {
@@ -796,6 +1231,7 @@ void Test_Protocol_Parser( void )
    if (Meter_ParseFrame(frame_v12, sizeof(frame_v12), &parsed_data))
    {
       Meter_PrintParsedData(&parsed_data);
+      Test_Record_RoundTrip(&parsed_data);
    }
    else
    {
@@ -830,6 +1266,7 @@ void Test_Protocol_Parser( void )
    if (Meter_ParseFrame(frame_v13, sizeof(frame_v13), &parsed_data))
    {
       Meter_PrintParsedData(&parsed_data);
+      Test_Record_RoundTrip(&parsed_data);
    }
    else
    {
@@ -865,6 +1302,7 @@ void Test_Protocol_Parser( void )
    if (Meter_ParseFrame(frame_v14, sizeof(frame_v14), &parsed_data))
    {
       Meter_PrintParsedData(&parsed_data);
+      Test_Record_RoundTrip(&parsed_data);
    }
    else
    {
@@ -877,6 +1315,565 @@ void Test_Protocol_Parser( void )
    _DBG("\r\n");
 }
 
+/*-------------------------------------------------------------------------*//**
+ * @brief         Print readings stored in the flash log (newest page first)
+ * @param         None
+ * @return        None
+ *//*-------------------------------------------------------------------------*/
+void Print_Flash_Log( void )
+{
+   static MeterData_t      data;       // static: 512-byte default stack
+   const MeterLogPage_t*   page;
+   const MeterLogStats_t*  stats = MeterLog_GetStats();
+   const MeterRecord_t*    pending;
+   uint8_t                 pending_count;
+   uint16_t                age;
+   uint8_t                 i;
+   uint32_t                stamp;
+   uint32_t                frac;
+#ifdef _DEBUG_MSG_BUFFERED
+   FunctionalState         buffered;
+
+   // Log can exceed the debug ring, print blocking
+   buffered = debug_frmwrk_buffered( DISABLE );
+#endif
+
+   pending_count = MeterLog_GetPending( &pending );
+   cprintf( "\n\rFlash log: %u pages, %u pending in RAM\n\r", MeterLog_GetPageCount(), pending_count );
+   cprintf( "  Since boot: %lu records, %lu page programs, %u low voltage flushes\n\r",
+            stats->records, stats->programs, stats->lvi_flushes );
+
+   for( i = pending_count; i-- > 0; )
+   {
+      stamp = Meter_RecordDecode( &pending[i], &data );
+      cprintf( "  (RAM) [%lu s] V%u ID %08lu: %lu.%0*lu m3, status 0x%04X\n\r",
+               stamp, data.version, data.meter_id,
+               Meter_BCD_Split( data.reading_bcd, data.decimal_point, &frac ),
+               data.decimal_point, frac, pending[i].status );
+   }
+
+   for( age = 0; ( page = MeterLog_GetPage( age ) ) != NULL; age++ )
+   {
+      for( i = 0; i < page->header.count; i++ )
+      {
+         stamp = Meter_RecordDecode( &page->rec[i], &data );
+         cprintf( "  #%lu [%lu s] V%u ID %08lu: %lu.%0*lu m3, status 0x%04X\n\r",
+                  page->header.seq, stamp, data.version, data.meter_id,
+                  Meter_BCD_Split( data.reading_bcd, data.decimal_point, &frac ),
+                  data.decimal_point, frac, page->rec[i].status );
+      }
+   }
+
+   _DBG( "\n\r" );
+
+#ifdef _DEBUG_MSG_BUFFERED
+   debug_frmwrk_buffered( buffered );
+#endif
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         Print per-port link statistics and scheduler state (retained SRAM)
+ * @param         None
+ * @return        None
+ *//*-------------------------------------------------------------------------*/
+void Print_Link_Stats( void )
+{
+   const METER_LINK_STATS_Type*  link;
+   const MeterSchedState_t*      sched = &METER_RETAIN->state.sched;
+   const MeterPowerStats_t*      power = MeterPower_GetStats();
+   const MeterClockStats_t*      clock = MeterClock_GetStats();
+   uint8_t                       port;
+
+   cprintf( "\n\rPolls %lu, power downs %lu, warm starts %lu\n\r",
+            sched->poll_count, sched->sleep_count, sched->warm_starts );
+   cprintf( "  Since boot: %lu power downs (%lu s, %lu early wakes), %lu sleeps, up %lu s\n\r",
+            power->powerdowns, power->powerdown_ms / 1000, power->early_wakes, power->sleeps,
+            Meter_GetTickMs() / 1000 );
+   cprintf( "  Clock: %lu Hz now, %lu level switches (%lu deferred), %lu ms boosted\n\r",
+            SystemCoreClock, clock->switches, clock->deferred, clock->high_ms );
+
+   for( port = 0; port < METER_PORT_MAX; port++ )
+   {
+      link = Meter_GetLinkStats( (METER_PORT_Type)port );
+      if( link == NULL || link->tx_frames == 0 )
+      {
+         continue;
+      }
+
+      cprintf( "  Port %u: tx %lu (retry %u), rx %lu, timeout %u, checksum %u, invalid %u\n\r",
+               port, link->tx_frames, link->retries, link->rx_frames,
+               link->timeouts, link->checksum_errors, link->invalid_frames );
+   }
+
+   _DBG( "\n\r" );
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         Print per-handler execution time and event queue statistics, then reset them
+ * @param         None
+ * @return        None
+ * @note          This handler's own run is counted after the reset
+ *//*-------------------------------------------------------------------------*/
+void Print_Event_Stats( void )
+{
+   static const char* const      name[METER_EVT_COUNT] = { "service", "poll", "frame", "error", "key" };
+   const MeterEventStats_t*      stats;
+   const MeterEventQueueStats_t* queue = MeterEvent_GetQueueStats();
+   uint8_t                       id;
+
+   _DBG( "\n\rEvent       runs    avg us    max us\n\r" );
+
+   for( id = 0; id < METER_EVT_COUNT; id++ )
+   {
+      stats = MeterEvent_GetStats( (METER_EVT_Type)id );
+      cprintf( "  %-8s %6lu %9lu %9lu\n\r", name[id], stats->runs,
+               ( stats->runs != 0 ) ? stats->total_us / stats->runs : 0, stats->max_us );
+   }
+
+   cprintf( "Queue: max depth %u/%u/%u (high/normal/low), %lu dropped\n\r\n\r",
+            queue->max_depth[METER_EVENT_PRIO_HIGH], queue->max_depth[METER_EVENT_PRIO_NORMAL],
+            queue->max_depth[METER_EVENT_PRIO_LOW], queue->dropped );
+
+   MeterEvent_ResetStats();
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         Print newest readings stored in the external NOR history
+ * @param         None
+ * @return        None
+ *//*-------------------------------------------------------------------------*/
+void Print_History( void )
+{
+   static MeterData_t            data;                         // static: 512-byte default stack
+   const MeterHistoryStats_t*    stats = MeterHistory_GetStats();
+   const MeterNorStats_t*        nor = MeterNor_GetStats();
+   const MeterNorCacheStats_t*   cache = MeterNorCache_GetStats();
+   uint32_t                      count = MeterHistory_GetCount();
+   uint32_t                      index;
+   uint32_t                      stamp;
+   uint32_t                      frac;
+#ifdef _DEBUG_MSG_BUFFERED
+   FunctionalState               buffered;
+
+   // History can exceed the debug ring, print blocking
+   buffered = debug_frmwrk_buffered( DISABLE );
+#endif
+
+   cprintf( "\n\rNOR history: %lu slots, %u pending in RAM\n\r", count, MeterHistory_GetPending() );
+   cprintf( "  Since boot: %lu appended, %lu written, %u sectors opened, %u dropped, %u errors, %u slots skipped\n\r",
+            stats->appended, stats->written, stats->sectors_opened, stats->dropped, stats->errors, stats->holes );
+   cprintf( "  Time index: %u entries written, %u lookups without entry\n\r",
+            stats->index_writes, stats->index_misses );
+   cprintf( "  NOR: %lu reads (%lu bytes), %lu programs, %lu erases, %lu wakeups, %u timeouts, %u DMA errors\n\r",
+            nor->reads, nor->read_bytes, nor->programs, nor->erases, nor->wakeups, nor->timeouts, nor->dma_errors );
+   cprintf( "  Cache: %lu hits, %lu misses, %lu readaheads (%lu used, %lu waited), %u evictions, %u errors\n\r",
+            cache->hits, cache->misses, cache->readaheads, cache->readahead_used, cache->waits,
+            cache->evictions, cache->errors );
+
+   // One record per read through the page cache (oldest first, next page read ahead while printing):
+   // uncommitted slots are skipped, so the index after the read gives the record's slot
+   index = ( count > HISTORY_PRINT_COUNT ) ? count - HISTORY_PRINT_COUNT : 0;
+
+   while( index < count )
+   {
+      if( MeterHistory_Read( &index, history_rec, 1 ) == 0 )
+      {
+         if( index < count )
+         {
+            _DBG( "[ERROR] NOR read failed\n\r" );
+         }
+         break;
+      }
+
+      stamp = Meter_RecordDecode( &history_rec[0], &data );
+      cprintf( "  #%lu [%lu s] V%u ID %08lu: %lu.%0*lu m3, status 0x%04X\n\r",
+               index - 1, stamp, data.version, data.meter_id,
+               Meter_BCD_Split( data.reading_bcd, data.decimal_point, &frac ),
+               data.decimal_point, frac, history_rec[0].status );
+   }
+
+   _DBG( "\n\r" );
+
+#ifdef _DEBUG_MSG_BUFFERED
+   debug_frmwrk_buffered( buffered );
+#endif
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         Read the whole NOR history through the page cache (bulk export throughput)
+ * @param         None
+ * @return        None
+ *//*-------------------------------------------------------------------------*/
+void Scan_History( void )
+{
+   const MeterNorCacheStats_t*   cache = MeterNorCache_GetStats();
+   const MeterNorStats_t*        nor = MeterNor_GetStats();
+   uint32_t                      count = MeterHistory_GetCount();
+   uint32_t                      index = 0;
+   uint32_t                      readings = 0;
+   uint32_t                      unordered = 0;
+   uint32_t                      prev = 0;
+   uint32_t                      reads;
+   uint32_t                      wakeups;
+   uint32_t                      start;
+   uint32_t                      elapsed;
+   uint16_t                      n;
+   uint16_t                      i;
+
+   cprintf( "\n\rScanning %lu NOR history readings...\n\r", count );
+
+   MeterNorCache_ResetStats();
+   reads = nor->reads;
+   wakeups = nor->wakeups;
+   start = Meter_GetTickMs();
+
+   while( index < count )
+   {
+      n = MeterHistory_Read( &index, history_rec, HISTORY_SCAN_BURST );
+      if( n == 0 )
+      {
+         if( index < count )
+         {
+            _DBG( "[ERROR] NOR read failed\n\r" );
+         }
+         break;
+      }
+
+      // Cheap per-record check so the scan is not pure copying (export would format/send here)
+      for( i = 0; i < n; i++ )
+      {
+         if( history_rec[i].timestamp < prev )
+         {
+            unordered++;
+         }
+         prev = history_rec[i].timestamp;
+      }
+
+      readings += n;
+   }
+
+   elapsed = Meter_GetTickMs() - start;
+
+   cprintf( "  %lu readings (%lu uncommitted slots skipped, %lu out of order) in %lu ms",
+            readings, index - readings, unordered, elapsed );
+   if( elapsed != 0 )
+   {
+      cprintf( ", %lu bytes/s", ( readings * METER_RECORD_SIZE * 1000UL ) / elapsed );
+   }
+   cprintf( "\n\r  NOR: %lu read commands, %lu wakeups\n\r", nor->reads - reads, nor->wakeups - wakeups );
+   cprintf( "  Cache: %lu hits, %lu misses, %lu readaheads (%lu used, %lu waited), %u evictions, %u errors\n\r\n\r",
+            cache->hits, cache->misses, cache->readaheads, cache->readahead_used, cache->waits,
+            cache->evictions, cache->errors );
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         Find readings of the last hour with the NOR history time index
+ * @param         None
+ * @return        None
+ *//*-------------------------------------------------------------------------*/
+void Query_History( void )
+{
+   const MeterNorStats_t*  nor = MeterNor_GetStats();
+   uint32_t                count = MeterHistory_GetCount();
+   uint32_t                last = MeterHistory_GetLastStamp();
+   uint32_t                from;
+   uint32_t                first;
+   uint32_t                index;
+   uint32_t                reads;
+   uint32_t                start;
+   uint32_t                elapsed;
+   uint16_t                i;
+
+   if( count == 0 )
+   {
+      _DBG( "\n\rNOR history is empty\n\r\n\r" );
+      return;
+   }
+
+   from = ( last > HISTORY_QUERY_SECONDS ) ? last - HISTORY_QUERY_SECONDS : 0;
+
+   reads = nor->reads;
+   start = Meter_GetTickMs();
+   first = MeterHistory_Find( from );
+   elapsed = Meter_GetTickMs() - start;
+
+   cprintf( "\n\rNOR history since %lu s: slots #%lu ~ #%lu\n\r", from, first, count - 1 );
+   cprintf( "  Lookup: %lu ms, %lu NOR reads (%lu slots stored)\n\r", elapsed, nor->reads - reads, count );
+
+   index = first;
+   for( i = 0; i < HISTORY_PRINT_BURST && MeterHistory_Read( &index, history_rec, 1 ) == 1; i++ )
+   {
+      cprintf( "  #%lu [%lu s] reading %lu, status 0x%04X\n\r",
+               index - 1, history_rec[0].timestamp, history_rec[0].reading, history_rec[0].status );
+   }
+
+   _DBG( "\n\r" );
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         Reference BCD decoder (byte loop, previous Meter_BCD_To_Uint32)
+ * @param         bcd: BCD array [4] (Little Endian)
+ * @return        Decoded value, 0 on invalid BCD
+ *//*-------------------------------------------------------------------------*/
+static uint32_t Bench_BCD_ByteLoop( const uint8_t* bcd )
+{
+   uint32_t    result = 0;
+   uint8_t     i;
+
+   for( i = 0; i < 4; i++ )
+   {
+      uint8_t high_nibble = ( bcd[3 - i] >> 4 ) & 0x0F;
+      uint8_t low_nibble = bcd[3 - i] & 0x0F;
+
+      if( high_nibble > 9 || low_nibble > 9 )
+      {
+         return 0;
+      }
+
+      result = result * 100 + ( high_nibble * 10 + low_nibble );
+   }
+
+   return result;
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         SysTick cycles elapsed since start (at most one reload)
+ * @param         start: SysTick->VAL at start
+ * @return        Core clock cycles
+ *//*-------------------------------------------------------------------------*/
+static uint32_t Bench_Cycles( uint32_t start )
+{
+   uint32_t    now = SysTick->VAL;
+
+   return ( start >= now ) ? ( start - now ) : ( start + SysTick->LOAD + 1 - now );
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         BCD decode benchmark (byte loop vs SWAR, division vs BCD split)
+ * @param         None
+ * @return        None
+ * @note          Cycles include one SysTick read per measurement
+ *//*-------------------------------------------------------------------------*/
+void Test_BCD_Benchmark( void )
+{
+   // static: 512-byte default stack
+   static uint8_t    bcd[BCD_BENCH_COUNT * 4];
+   static uint32_t   ref[BCD_BENCH_COUNT];
+   static uint32_t   val[BCD_BENCH_COUNT];
+   static uint32_t   ipart[BCD_BENCH_COUNT];
+   static uint32_t   fpart[BCD_BENCH_COUNT];
+   uint32_t    cyc_ref, cyc_swar, cyc_batch, cyc_div, cyc_split;
+   uint32_t    start;
+   uint16_t    errors = 0;
+   uint16_t    i;
+   uint8_t     k;
+
+   // Valid 8-digit BCD samples (digits vary per sample and position)
+   for( i = 0; i < BCD_BENCH_COUNT; i++ )
+   {
+      for( k = 0; k < 4; k++ )
+      {
+         bcd[i * 4 + k] = (uint8_t)( ( ( ( i + k * 7 + 1 ) % 10 ) << 4 ) | ( ( i * 3 + k ) % 10 ) );
+      }
+   }
+
+   __disable_irq();
+
+   start = SysTick->VAL;
+   for( i = 0; i < BCD_BENCH_COUNT; i++ )
+   {
+      ref[i] = Bench_BCD_ByteLoop( &bcd[i * 4] );
+   }
+   cyc_ref = Bench_Cycles( start );
+
+   start = SysTick->VAL;
+   for( i = 0; i < BCD_BENCH_COUNT; i++ )
+   {
+      val[i] = Meter_BCD_To_Uint32( &bcd[i * 4] );
+   }
+   cyc_swar = Bench_Cycles( start );
+
+   start = SysTick->VAL;
+   Meter_BCD_To_Uint32_Batch( bcd, val, BCD_BENCH_COUNT );
+   cyc_batch = Bench_Cycles( start );
+
+   start = SysTick->VAL;
+   for( i = 0; i < BCD_BENCH_COUNT; i++ )
+   {
+      ipart[i] = ref[i] / 1000;
+      fpart[i] = ref[i] % 1000;
+   }
+   cyc_div = Bench_Cycles( start );
+
+   __enable_irq();
+
+   for( i = 0; i < BCD_BENCH_COUNT; i++ )
+   {
+      if( val[i] != ref[i] )
+      {
+         errors++;
+      }
+   }
+
+   // Split into integer/fraction (decimal point 3), val/ref reused as outputs
+   __disable_irq();
+
+   start = SysTick->VAL;
+   for( i = 0; i < BCD_BENCH_COUNT; i++ )
+   {
+      val[i] = Meter_BCD_Split( &bcd[i * 4], 3, &ref[i] );
+   }
+   cyc_split = Bench_Cycles( start );
+
+   __enable_irq();
+
+   for( i = 0; i < BCD_BENCH_COUNT; i++ )
+   {
+      if( val[i] != ipart[i] || ref[i] != fpart[i] )
+      {
+         errors++;
+      }
+   }
+
+   _DBG( "\n\r[BCD BENCH] cycles per " );
+   _DBD32( BCD_BENCH_COUNT );
+   _DBG( " values\n\r" );
+   cprintf( "  Byte loop:      %lu\n\r", cyc_ref );
+   cprintf( "  SWAR:           %lu\n\r", cyc_swar );
+   cprintf( "  SWAR batch:     %lu\n\r", cyc_batch );
+   cprintf( "  /1000 %%1000:    %lu\n\r", cyc_div );
+   cprintf( "  BCD split:      %lu\n\r", cyc_split );
+   _DBG( errors ? "  Result mismatch\n\r\n\r" : "  Results match\n\r\n\r" );
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief         Reading series compression benchmark on stored NOR history
+ * @param         None
+ * @return        None
+ * @note          Newest meter's readings among the last CODEC_BENCH_COUNT records are
+ *                packed into one CODEC_BENCH_BLOCK block, decoded and compared
+ *                with the history again. Cycles include one SysTick read per record.
+ *//*-------------------------------------------------------------------------*/
+void Test_Codec_Benchmark( void )
+{
+   static uint8_t          block[CODEC_BENCH_BLOCK];
+   static MeterCodecEncoder_t enc;                             // static: 512-byte default stack
+   static MeterCodecDecoder_t dec;
+   MeterCodecSample_t      sample;
+   METER_CODEC_ERROR_Type  result = METER_CODEC_OK;
+   uint32_t                count = MeterHistory_GetCount();
+   uint32_t                first;
+   uint32_t                index;
+   uint32_t                meter_id;
+   uint32_t                cyc_enc = 0;
+   uint32_t                cyc_dec = 0;
+   uint32_t                start;
+   uint16_t                encoded = 0;
+   uint16_t                decoded = 0;
+   uint16_t                errors = 0;
+   uint16_t                len;
+   uint16_t                n;
+   uint16_t                i;
+
+   // Series of the newest reading (last record of the newest burst)
+   index = ( count > HISTORY_SCAN_BURST ) ? count - HISTORY_SCAN_BURST : 0;
+   n = MeterHistory_Read( &index, history_rec, HISTORY_SCAN_BURST );
+   if( n == 0 )
+   {
+      _DBG( "\n\rNOR history is empty\n\r\n\r" );
+      return;
+   }
+
+   meter_id = history_rec[n - 1].meter_id;
+   first = ( count > CODEC_BENCH_COUNT ) ? count - CODEC_BENCH_COUNT : 0;
+   MeterCodec_EncodeBegin( &enc, block, sizeof( block ), meter_id, history_rec[n - 1].dp_dia );
+
+   // Encode: one record at a time straight from the history, until the block is full
+   for( index = first; index < count && result == METER_CODEC_OK; )
+   {
+      n = MeterHistory_Read( &index, history_rec, HISTORY_SCAN_BURST );
+      if( n == 0 && index < count )
+      {
+         _DBG( "[ERROR] NOR read failed\n\r" );
+         return;
+      }
+
+      for( i = 0; i < n && result == METER_CODEC_OK; i++ )
+      {
+         if( history_rec[i].meter_id != meter_id )
+         {
+            continue;
+         }
+
+         sample.timestamp = history_rec[i].timestamp;
+         sample.reading = history_rec[i].reading;
+         sample.status = history_rec[i].status;
+
+         __disable_irq();
+         start = SysTick->VAL;
+         result = MeterCodec_EncodeAdd( &enc, &sample );
+         cyc_enc += Bench_Cycles( start );
+         __enable_irq();
+
+         if( result == METER_CODEC_OK )
+         {
+            encoded++;
+         }
+      }
+   }
+   len = MeterCodec_EncodeEnd( &enc );
+
+   // Decode and compare against the same records read again
+   MeterCodec_DecodeBegin( &dec, block, len );
+
+   for( index = first; index < count && decoded < encoded; )
+   {
+      n = MeterHistory_Read( &index, history_rec, HISTORY_SCAN_BURST );
+      if( n == 0 && index < count )
+      {
+         _DBG( "[ERROR] NOR read failed\n\r" );
+         return;
+      }
+
+      for( i = 0; i < n && decoded < encoded; i++ )
+      {
+         if( history_rec[i].meter_id != meter_id )
+         {
+            continue;
+         }
+
+         __disable_irq();
+         start = SysTick->VAL;
+         result = MeterCodec_DecodeNext( &dec, &sample );
+         cyc_dec += Bench_Cycles( start );
+         __enable_irq();
+
+         if( result != METER_CODEC_OK || sample.timestamp != history_rec[i].timestamp ||
+             sample.reading != history_rec[i].reading || sample.status != history_rec[i].status )
+         {
+            errors++;
+         }
+         decoded++;
+      }
+   }
+
+   if( encoded == 0 )
+   {
+      _DBG( "\n\r[CODEC BENCH] no readings encoded\n\r\n\r" );
+      return;
+   }
+
+   cprintf( "\n\r[CODEC BENCH] ID %08lu, %u readings -> %u bytes (block %u)\n\r",
+            meter_id, encoded, len, (uint16_t)sizeof( block ) );
+   cprintf( "  Stored:  %lu bytes, ratio %lu.%02lu:1, %lu.%02lu bytes/reading\n\r",
+            (uint32_t)encoded * METER_RECORD_SIZE,
+            (uint32_t)encoded * METER_RECORD_SIZE / len, (uint32_t)encoded * METER_RECORD_SIZE * 100 / len % 100,
+            (uint32_t)len / encoded, (uint32_t)len * 100 / encoded % 100 );
+   cprintf( "  Encode:  %lu cycles/reading\n\r", cyc_enc / encoded );
+   cprintf( "  Decode:  %lu cycles/reading\n\r", cyc_dec / encoded );
+   _DBG( errors ? "  Round trip mismatch\n\r\n\r" : "  Round trip OK\n\r\n\r" );
+}
+
 /*-------------------------------------------------------------------------*//**
  * @brief         Driver error handler
  * @param         None
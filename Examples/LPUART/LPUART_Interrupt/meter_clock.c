@@ -0,0 +1,278 @@
+/**
+ *******************************************************************************
+ * @file        meter_clock.c
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       시스템 클럭 단계 조절 (HIRC 분주)
+ * @details     HCLK 분주, SystemCoreClock/SystemPeriClock, SysTick 재장전 값, 주변장치 분주는
+ *              인터럽트를 금지한 한 구간에서 함께 바꾼다. 분주 계산식은 HAL Init 함수와 같다
+ *              (HAL Init은 주변장치를 초기화하므로 분주 레지스터만 다시 쓴다).
+ *              SysTick은 변경 시 현재 주기를 새로 시작하므로 변경마다 1ms 미만의 틱 오차가 생긴다.
+ *******************************************************************************
+ */
+
+#include "meter_clock.h"
+#include "meter_nor.h"
+#include "meter_flash.h"
+#include <string.h>
+
+//******************************************************************************
+// 내부 구조체
+//******************************************************************************
+
+// 등록 주변장치
+typedef struct
+{
+    void*               dev;        // 레지스터 (NULL: 빈 칸)
+    uint32_t            baud;
+    uint8_t             type;       // METER_CLOCK_DEV_Type
+    uint8_t             port;       // METER_PORT_Type (METER_PORT_MAX: 계량기 포트 아님)
+} METER_CLOCK_DEV_ENTRY_Type;
+
+//******************************************************************************
+// 내부 변수
+//******************************************************************************
+
+static METER_CLOCK_DEV_ENTRY_Type g_clock_dev[METER_CLOCK_DEV_MAX];
+static METER_CLOCK_LEVEL_Type g_clock_level = METER_CLOCK_HIGH;
+static uint8_t g_clock_boost = 0;                   // MeterClock_Boost() 중첩 수
+static uint32_t g_clock_high_since = 0;             // 높은 단계 진입 시각 (ms)
+static MeterClockStats_t g_clock_stats;
+
+//******************************************************************************
+// 내부 함수 선언
+//******************************************************************************
+
+static bool MeterClock_CanSwitch(void);
+static void MeterClock_Switch(METER_CLOCK_LEVEL_Type level);
+static void MeterClock_SetDivisor(const METER_CLOCK_DEV_ENTRY_Type* entry, uint32_t pclk);
+
+//******************************************************************************
+// 함수 구현
+//******************************************************************************
+
+/**
+ * @brief 초기화
+ */
+void MeterClock_Init(void)
+{
+    memset(g_clock_dev, 0, sizeof(g_clock_dev));
+    memset(&g_clock_stats, 0, sizeof(g_clock_stats));
+
+    // 주변장치 등록 전에는 내려가지 않도록 요청 1개로 시작
+    g_clock_level = METER_CLOCK_HIGH;
+    g_clock_boost = 1;
+    g_clock_high_since = Meter_GetTickMs();
+}
+
+/**
+ * @brief 보레이트 분주를 다시 계산할 주변장치 등록
+ */
+bool MeterClock_Attach(METER_CLOCK_DEV_Type type, void* dev, uint32_t baud, METER_PORT_Type port)
+{
+    uint8_t i;
+
+    for (i = 0; i < METER_CLOCK_DEV_MAX; i++)
+    {
+        if (g_clock_dev[i].dev == NULL || g_clock_dev[i].dev == dev)
+        {
+            g_clock_dev[i].dev = dev;
+            g_clock_dev[i].baud = baud;
+            g_clock_dev[i].type = (uint8_t)type;
+            g_clock_dev[i].port = (uint8_t)port;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief 높은 단계 요청
+ */
+void MeterClock_Boost(void)
+{
+    g_clock_boost++;
+    MeterClock_Update();
+}
+
+/**
+ * @brief 높은 단계 요청 해제
+ */
+void MeterClock_Release(void)
+{
+    if (g_clock_boost != 0)
+    {
+        g_clock_boost--;
+    }
+    MeterClock_Update();
+}
+
+/**
+ * @brief 요청된 단계로 변경 재시도
+ */
+void MeterClock_Update(void)
+{
+    METER_CLOCK_LEVEL_Type level = (g_clock_boost != 0) ? METER_CLOCK_HIGH : METER_CLOCK_LOW;
+
+    if (level == g_clock_level)
+    {
+        return;
+    }
+
+    if (!MeterClock_CanSwitch())
+    {
+        g_clock_stats.deferred++;
+        return;
+    }
+
+    MeterClock_Switch(level);
+}
+
+/**
+ * @brief 현재 단계
+ */
+METER_CLOCK_LEVEL_Type MeterClock_GetLevel(void)
+{
+    return g_clock_level;
+}
+
+/**
+ * @brief 통계 조회
+ */
+const MeterClockStats_t* MeterClock_GetStats(void)
+{
+    return &g_clock_stats;
+}
+
+//******************************************************************************
+// 내부 함수 구현
+//******************************************************************************
+
+/**
+ * @brief 분주를 바꿔도 되는지 확인
+ * @return false: 등록된 계량기 포트가 IDLE이 아님 (송수신 중 바이트가 깨짐), NOR/flash 동작 중
+ */
+static bool MeterClock_CanSwitch(void)
+{
+    uint8_t i;
+
+    if (MeterNor_IsBusy() || MeterFlash_IsBusy())
+    {
+        return false;
+    }
+
+    for (i = 0; i < METER_CLOCK_DEV_MAX; i++)
+    {
+        if (g_clock_dev[i].dev != NULL && g_clock_dev[i].port < METER_PORT_MAX &&
+            Meter_GetState((METER_PORT_Type)g_clock_dev[i].port) != METER_STATE_IDLE)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief 단계 변경 (HCLK 분주, SysTick, 주변장치 분주)
+ */
+static void MeterClock_Switch(METER_CLOCK_LEVEL_Type level)
+{
+    uint32_t hz = (level == METER_CLOCK_HIGH) ? METER_CLOCK_HIGH_HZ : METER_CLOCK_LOW_HZ;
+    uint32_t now = Meter_GetTickMs();
+    uint32_t primask;
+    uint8_t i;
+
+    // 송신 중인 UART 바이트가 깨지지 않도록 디버그 출력을 먼저 내보냄
+#ifdef _DEBUG_MSG_BUFFERED
+    debug_frmwrk_flush();
+#endif
+    for (i = 0; i < METER_CLOCK_DEV_MAX; i++)
+    {
+        if (g_clock_dev[i].dev != NULL && g_clock_dev[i].type == METER_CLOCK_DEV_UART)
+        {
+            while (!(HAL_UART_GetLineStatus((UARTn_Type*)g_clock_dev[i].dev) & UARTn_LSR_TEMT))
+            {
+            }
+        }
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    HAL_SCU_SystemClockDivider(WLDIV_MCLK64 | ((level == METER_CLOCK_HIGH) ? METER_CLOCK_HIGH_HDIV : METER_CLOCK_LOW_HDIV),
+                               SYSTDIV_HCLK1 | PDIV_HCLK1);
+    SystemCoreClock = hz;
+    SystemPeriClock = hz;
+
+    // SysTick 1ms (코어 클럭 구동)
+    SysTick->LOAD = hz / 1000 - 1;
+    SysTick->VAL = 0;
+
+    for (i = 0; i < METER_CLOCK_DEV_MAX; i++)
+    {
+        if (g_clock_dev[i].dev != NULL)
+        {
+            MeterClock_SetDivisor(&g_clock_dev[i], hz);
+        }
+    }
+
+    __set_PRIMASK(primask);
+
+    if (level == METER_CLOCK_HIGH)
+    {
+        g_clock_high_since = now;
+    }
+    else
+    {
+        g_clock_stats.high_ms += now - g_clock_high_since;
+    }
+
+    g_clock_level = level;
+    g_clock_stats.switches++;
+}
+
+/**
+ * @brief 주변장치 보레이트 분주 다시 쓰기
+ * @param entry 등록 주변장치
+ * @param pclk 새 PCLK (Hz)
+ */
+static void MeterClock_SetDivisor(const METER_CLOCK_DEV_ENTRY_Type* entry, uint32_t pclk)
+{
+    uint32_t den;
+    uint32_t bdr;
+
+    switch (entry->type)
+    {
+        case METER_CLOCK_DEV_UART:
+        {
+            UARTn_Type* uart = (UARTn_Type*)entry->dev;
+
+            // bdr = PCLK / (16 * baud) - 1, bfr = 나머지 * 256 / (16 * baud)
+            den = 16 * entry->baud;
+            bdr = pclk / den - 1;
+            uart->BDR = (uint16_t)(bdr & 0xFFFF);
+            uart->BFR = (uint8_t)(((pclk - (bdr + 1) * den) * 256 / den) & 0xFF);
+            break;
+        }
+
+        case METER_CLOCK_DEV_USART:
+            ((USART1n_Type*)entry->dev)->BDR = (uint16_t)((pclk / 16 / entry->baud - 1) & 0xFFFF);
+            break;
+
+        case METER_CLOCK_DEV_LPUART:
+            // OVRS: 0 = 16배, 1 = 8배, 2 = 샘플링 없음
+            den = (LPUART->CR1_b.OVRS == LPUART_OVRS_16) ? 16 : (LPUART->CR1_b.OVRS == LPUART_OVRS_8) ? 8 : 1;
+            LPUART->BDR = (uint16_t)((pclk / den / entry->baud - 1) & 0xFFFF);
+            break;
+
+        case METER_CLOCK_DEV_SPI:
+            // SCK = PCLK / 2 / (PREDR + 1), 낮은 단계에서 요청이 PCLK / 2보다 크면 PREDR 0
+            bdr = pclk / 2 / entry->baud;
+            ((SPIn_Type*)entry->dev)->PREDR = (uint16_t)((bdr != 0) ? bdr - 1 : 0);
+            break;
+
+        default:
+            break;
+    }
+}
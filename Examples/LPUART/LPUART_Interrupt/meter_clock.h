@@ -0,0 +1,120 @@
+/**
+ *******************************************************************************
+ * @file        meter_clock.h
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       시스템 클럭 단계 조절 (HIRC 분주)
+ * @details     평소에는 HCLK/PCLK를 낮은 단계(HIRC 32MHz / 8 = 4MHz)로 두고, 계산이 많은 구간
+ *              (압축, flash 로그 기록 등)만 MeterClock_Boost()/MeterClock_Release()로 32MHz로 올린다.
+ *              - 단계를 바꿀 때마다 SysTick 주기(1ms)와 등록된 주변장치의 보레이트 분주를 다시 계산
+ *              - 등록된 계량기 포트가 통신 중이거나 NOR/flash 동작 중이면 바꾸지 않고 미룸
+ *                (올리기는 건너뛰고 낮은 단계로 실행, 내리기는 MeterPower_Idle()에서 재시도)
+ *              - XSOSC로 구동하는 LPUART(METER_LPUART_WAKE)는 영향이 없으므로 등록하지 않음 (XSOSC 미발진으로 PCLK 대체 시 등록)
+ *******************************************************************************
+ */
+
+#ifndef _METER_CLOCK_H_
+#define _METER_CLOCK_H_
+
+#include "main_conf.h"
+#include "meter_protocol.h"
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//******************************************************************************
+// 클럭 상수 정의
+//******************************************************************************
+
+// 단계별 HCLK 분주 (MCLK = HIRC 32MHz, SystemClock_Config의 USED_HIRC), PCLK = HCLK
+#define METER_CLOCK_MCLK_HZ         32000000UL
+#define METER_CLOCK_HIGH_HDIV       HDIV_MCLK1  // 32MHz
+#define METER_CLOCK_HIGH_HZ         (METER_CLOCK_MCLK_HZ / 1)
+#define METER_CLOCK_LOW_HDIV        HDIV_MCLK8  // 4MHz (SysTick 4000클럭/ms, UART1 38400bps 소수 분주)
+#define METER_CLOCK_LOW_HZ          (METER_CLOCK_MCLK_HZ / 8)
+
+// 보레이트를 다시 계산할 주변장치 수
+#define METER_CLOCK_DEV_MAX         4
+
+//******************************************************************************
+// 클럭 구조체
+//******************************************************************************
+
+// 클럭 단계
+typedef enum
+{
+    METER_CLOCK_LOW = 0,            // 평소 (대기, 통신, 이벤트 처리)
+    METER_CLOCK_HIGH,               // 부스트 (MeterClock_Boost() 중)
+    METER_CLOCK_LEVEL_COUNT
+} METER_CLOCK_LEVEL_Type;
+
+// 보레이트 분주를 다시 계산할 주변장치 종류 (PCLK 구동)
+typedef enum
+{
+    METER_CLOCK_DEV_UART = 0,       // UART0/1: BDR + BFR (16배 샘플링, 소수 분주)
+    METER_CLOCK_DEV_USART,          // USART10 UART 모드: BDR (16배 샘플링)
+    METER_CLOCK_DEV_LPUART,         // LPUART (LPUTCLK_PCLK): BDR (CR1 OVRS 배수)
+    METER_CLOCK_DEV_SPI             // SPI0/1 마스터: PREDR (PCLK / 2 / (PREDR + 1))
+} METER_CLOCK_DEV_Type;
+
+// 통계
+typedef struct
+{
+    uint32_t    switches;           // 단계 변경
+    uint32_t    deferred;           // 통신/NOR/flash 동작 중이라 미룬 변경
+    uint32_t    high_ms;            // 높은 단계 누적 시간 (현재 구간 제외, ms)
+} MeterClockStats_t;
+
+//******************************************************************************
+// 클럭 함수 프로토타입
+//******************************************************************************
+
+/**
+ * @brief 초기화 (SystemClock_Config 직후 상태 = 높은 단계로 기록)
+ * @note 높은 단계 요청 1개가 걸린 상태로 시작한다.
+ *       주변장치를 등록한 뒤 MeterClock_Release()를 호출하면 낮은 단계로 내려간다.
+ */
+void MeterClock_Init(void);
+
+/**
+ * @brief 단계를 바꿀 때 보레이트 분주를 다시 계산할 주변장치 등록
+ * @param type 주변장치 종류
+ * @param dev 레지스터 주소 (UART1, USART10, LPUART, SPI0 등)
+ * @param baud 보레이트 (SPI: SCK, PCLK / 2보다 크면 PCLK / 2)
+ * @param port 계량기 포트면 해당 포트 (IDLE이 아니면 단계 변경 보류), 아니면 METER_PORT_MAX
+ * @return false: 등록 공간 없음 (METER_CLOCK_DEV_MAX)
+ */
+bool MeterClock_Attach(METER_CLOCK_DEV_Type type, void* dev, uint32_t baud, METER_PORT_Type port);
+
+/**
+ * @brief 높은 단계 요청 (중첩 가능, MeterClock_Release()와 짝)
+ * @note 바꿀 수 없는 동안이면 낮은 단계 그대로 실행 (미룸 통계 증가)
+ */
+void MeterClock_Boost(void);
+
+/**
+ * @brief 높은 단계 요청 해제 (마지막 해제에서 낮은 단계로)
+ */
+void MeterClock_Release(void);
+
+/**
+ * @brief 요청된 단계로 변경 재시도 (MeterPower_Idle()에서 호출)
+ */
+void MeterClock_Update(void);
+
+/**
+ * @brief 현재 단계
+ */
+METER_CLOCK_LEVEL_Type MeterClock_GetLevel(void);
+
+/**
+ * @brief 통계 조회
+ */
+const MeterClockStats_t* MeterClock_GetStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _METER_CLOCK_H_ */
@@ -0,0 +1,269 @@
+/**
+ *******************************************************************************
+ * @file        meter_codec.c
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       검침값 시계열 압축 (델타 + zigzag varint)
+ * @details     블록 = 헤더 8바이트 + 레코드
+ *              헤더: 형식(1) | 계열 정보(1) | 계열 ID(4, LE) | 레코드 수(2, LE)
+ *              첫 레코드: varint(시각) | varint(검침값) | varint(상태)
+ *              이후 레코드: varint(zigzag(검침값 차이) << 1 | 상태 바뀜)
+ *                           | varint(zigzag(간격 - 이전 간격)) | [varint(상태)]
+ *              varint는 7비트씩 하위부터, 최상위 비트 = 다음 바이트 있음 (LEB128).
+ *              차이/간격은 32비트 모듈로 연산이므로 시각이 되돌아가도 그대로 복원된다.
+ *******************************************************************************
+ */
+
+#include "meter_codec.h"
+#include <string.h>
+
+//******************************************************************************
+// 내부 함수 선언
+//******************************************************************************
+
+static uint8_t MeterCodec_PutVarint(uint8_t* p, uint32_t value);
+static bool MeterCodec_GetVarint(MeterCodecDecoder_t* dec, uint32_t* value);
+static uint32_t MeterCodec_ZigZag(uint32_t value);
+static uint32_t MeterCodec_UnZigZag(uint32_t value);
+
+//******************************************************************************
+// 함수 구현
+//******************************************************************************
+
+/**
+ * @brief 블록 압축 시작 (헤더 기록)
+ */
+METER_CODEC_ERROR_Type MeterCodec_EncodeBegin(MeterCodecEncoder_t* enc, uint8_t* buf, uint16_t size,
+                                              uint32_t series_id, uint8_t series_info)
+{
+    memset(enc, 0, sizeof(*enc));
+
+    if (size < METER_CODEC_HEADER_SIZE)
+    {
+        return METER_CODEC_ERR_FULL;
+    }
+
+    enc->buf = buf;
+    enc->size = size;
+
+    buf[0] = METER_CODEC_FORMAT;
+    buf[1] = series_info;
+    buf[2] = (uint8_t)series_id;
+    buf[3] = (uint8_t)(series_id >> 8);
+    buf[4] = (uint8_t)(series_id >> 16);
+    buf[5] = (uint8_t)(series_id >> 24);
+    buf[6] = 0;
+    buf[7] = 0;
+    enc->len = METER_CODEC_HEADER_SIZE;
+
+    return METER_CODEC_OK;
+}
+
+/**
+ * @brief 레코드 추가
+ * @details 임시 버퍼에 만든 뒤 들어가면 복사하므로 실패해도 블록은 그대로이다.
+ */
+METER_CODEC_ERROR_Type MeterCodec_EncodeAdd(MeterCodecEncoder_t* enc, const MeterCodecSample_t* sample)
+{
+    uint8_t tmp[METER_CODEC_MAX_RECORD];
+    uint8_t n;
+    uint32_t interval;
+    int32_t delta;
+    bool changed;
+
+    if (enc->count == 0)
+    {
+        n = MeterCodec_PutVarint(tmp, sample->timestamp);
+        n += MeterCodec_PutVarint(&tmp[n], sample->reading);
+        n += MeterCodec_PutVarint(&tmp[n], sample->status);
+        interval = 0;
+    }
+    else
+    {
+        delta = (int32_t)(sample->reading - enc->reading);
+        if (delta > METER_CODEC_DELTA_MAX || delta < -METER_CODEC_DELTA_MAX - 1)
+        {
+            return METER_CODEC_ERR_RANGE;
+        }
+
+        changed = (sample->status != enc->status);
+        interval = sample->timestamp - enc->timestamp;
+
+        n = MeterCodec_PutVarint(tmp, (MeterCodec_ZigZag((uint32_t)delta) << 1) | (changed ? 1U : 0U));
+        n += MeterCodec_PutVarint(&tmp[n], MeterCodec_ZigZag(interval - enc->interval));
+        if (changed)
+        {
+            n += MeterCodec_PutVarint(&tmp[n], sample->status);
+        }
+    }
+
+    if (n > enc->size - enc->len || enc->count == 0xFFFF)
+    {
+        return METER_CODEC_ERR_FULL;
+    }
+
+    memcpy(&enc->buf[enc->len], tmp, n);
+    enc->len += n;
+    enc->count++;
+    enc->timestamp = sample->timestamp;
+    enc->interval = interval;
+    enc->reading = sample->reading;
+    enc->status = sample->status;
+
+    return METER_CODEC_OK;
+}
+
+/**
+ * @brief 블록 압축 끝 (헤더의 레코드 수 기록)
+ */
+uint16_t MeterCodec_EncodeEnd(MeterCodecEncoder_t* enc)
+{
+    if (enc->buf == NULL)
+    {
+        return 0;
+    }
+
+    enc->buf[6] = (uint8_t)enc->count;
+    enc->buf[7] = (uint8_t)(enc->count >> 8);
+
+    return enc->len;
+}
+
+/**
+ * @brief 블록 복원 시작 (헤더 확인)
+ */
+METER_CODEC_ERROR_Type MeterCodec_DecodeBegin(MeterCodecDecoder_t* dec, const uint8_t* buf, uint16_t len)
+{
+    memset(dec, 0, sizeof(*dec));
+
+    if (len < METER_CODEC_HEADER_SIZE || buf[0] != METER_CODEC_FORMAT)
+    {
+        return METER_CODEC_ERR_FORMAT;
+    }
+
+    dec->buf = buf;
+    dec->len = len;
+    dec->pos = METER_CODEC_HEADER_SIZE;
+    dec->series_info = buf[1];
+    dec->series_id = (uint32_t)buf[2] | ((uint32_t)buf[3] << 8) | ((uint32_t)buf[4] << 16) | ((uint32_t)buf[5] << 24);
+    dec->count = (uint16_t)(buf[6] | (buf[7] << 8));
+
+    return METER_CODEC_OK;
+}
+
+/**
+ * @brief 다음 레코드 복원
+ */
+METER_CODEC_ERROR_Type MeterCodec_DecodeNext(MeterCodecDecoder_t* dec, MeterCodecSample_t* sample)
+{
+    uint32_t control;
+    uint32_t value;
+
+    if (dec->index >= dec->count)
+    {
+        return METER_CODEC_END;
+    }
+
+    if (dec->index == 0)
+    {
+        if (!MeterCodec_GetVarint(dec, &dec->timestamp) ||
+            !MeterCodec_GetVarint(dec, &dec->reading) ||
+            !MeterCodec_GetVarint(dec, &value))
+        {
+            return METER_CODEC_ERR_FORMAT;
+        }
+        dec->status = (uint16_t)value;
+    }
+    else
+    {
+        if (!MeterCodec_GetVarint(dec, &control) || !MeterCodec_GetVarint(dec, &value))
+        {
+            return METER_CODEC_ERR_FORMAT;
+        }
+
+        dec->reading += MeterCodec_UnZigZag(control >> 1);
+        dec->interval += MeterCodec_UnZigZag(value);
+        dec->timestamp += dec->interval;
+
+        if (control & 1U)
+        {
+            if (!MeterCodec_GetVarint(dec, &value))
+            {
+                return METER_CODEC_ERR_FORMAT;
+            }
+            dec->status = (uint16_t)value;
+        }
+    }
+
+    dec->index++;
+
+    sample->timestamp = dec->timestamp;
+    sample->reading = dec->reading;
+    sample->status = dec->status;
+
+    return METER_CODEC_OK;
+}
+
+//******************************************************************************
+// 내부 함수 구현
+//******************************************************************************
+
+/**
+ * @brief varint 기록
+ * @return 기록한 바이트 수 (1~5)
+ */
+static uint8_t MeterCodec_PutVarint(uint8_t* p, uint32_t value)
+{
+    uint8_t n = 0;
+
+    while (value >= 0x80)
+    {
+        p[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    p[n++] = (uint8_t)value;
+
+    return n;
+}
+
+/**
+ * @brief varint 읽기
+ * @return false: 블록 끝에서 잘림 또는 5바이트 초과
+ */
+static bool MeterCodec_GetVarint(MeterCodecDecoder_t* dec, uint32_t* value)
+{
+    uint32_t result = 0;
+    uint8_t shift = 0;
+    uint8_t b;
+
+    do
+    {
+        if (dec->pos >= dec->len || shift > 28)
+        {
+            return false;
+        }
+
+        b = dec->buf[dec->pos++];
+        result |= (uint32_t)(b & 0x7F) << shift;
+        shift += 7;
+    } while (b & 0x80);
+
+    *value = result;
+
+    return true;
+}
+
+/**
+ * @brief zigzag 변환 (부호 있는 차이 → 작은 양수: 0, -1, 1, -2 → 0, 1, 2, 3)
+ */
+static uint32_t MeterCodec_ZigZag(uint32_t value)
+{
+    return (value << 1) ^ (uint32_t)((int32_t)value >> 31);
+}
+
+/**
+ * @brief zigzag 역변환
+ */
+static uint32_t MeterCodec_UnZigZag(uint32_t value)
+{
+    return (value >> 1) ^ (0U - (value & 1U));
+}
@@ -0,0 +1,140 @@
+/**
+ *******************************************************************************
+ * @file        meter_codec.h
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       검침값 시계열 압축 (델타 + zigzag varint)
+ * @details     한 계량기의 연속 검침값을 블록 하나로 압축한다.
+ *              - 검침값: 첫 값 + 이전 값과의 차이 (zigzag varint)
+ *              - 시각: 첫 시각 + 간격의 변화량 (delta-of-delta, zigzag varint)
+ *              - 상태: 바뀔 때만 기록 (같은 상태의 구간은 플래그 1비트)
+ *              매시 검침이면 레코드당 2~3바이트 (MeterRecord_t 16바이트).
+ *              대상/호스트 공용 (표준 헤더만 사용, 나눗셈/64비트 연산 없음).
+ *******************************************************************************
+ */
+
+#ifndef _METER_CODEC_H_
+#define _METER_CODEC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//******************************************************************************
+// 압축 상수 정의
+//******************************************************************************
+
+#define METER_CODEC_FORMAT          1           // 블록 형식 버전
+#define METER_CODEC_HEADER_SIZE     8           // 형식 1 + 계열 정보 1 + 계열 ID 4 + 레코드 수 2
+#define METER_CODEC_MAX_RECORD      15          // 레코드 하나의 최대 길이 (varint 5바이트 x 3)
+
+// 검침값 차이 범위 (zigzag 값에 상태 플래그 1비트를 붙이므로 31비트)
+#define METER_CODEC_DELTA_MAX       0x3FFFFFFFL
+
+//******************************************************************************
+// 압축 구조체
+//******************************************************************************
+
+// 압축 에러 코드
+typedef enum
+{
+    METER_CODEC_OK = 0,
+    METER_CODEC_END,                // 복원: 블록의 모든 레코드를 읽음
+    METER_CODEC_ERR_FULL,           // 압축: 출력 버퍼 부족 (레코드를 추가하지 않음)
+    METER_CODEC_ERR_RANGE,          // 압축: 검침값 차이가 METER_CODEC_DELTA_MAX 초과
+    METER_CODEC_ERR_FORMAT          // 복원: 형식 불일치, 블록이 잘림
+} METER_CODEC_ERROR_Type;
+
+// 레코드 (계열 안에서 바뀌는 값)
+typedef struct
+{
+    uint32_t    timestamp;          // 시각 (초)
+    uint32_t    reading;            // 검침값 (소수점 없는 정수)
+    uint16_t    status;             // 상태 비트
+} MeterCodecSample_t;
+
+// 압축 상태
+typedef struct
+{
+    uint8_t*    buf;                // 출력 버퍼
+    uint16_t    size;               // 출력 버퍼 크기
+    uint16_t    len;                // 기록한 길이
+    uint16_t    count;              // 레코드 수
+    uint16_t    status;             // 이전 상태
+    uint32_t    timestamp;          // 이전 시각
+    uint32_t    interval;           // 이전 간격
+    uint32_t    reading;            // 이전 검침값
+} MeterCodecEncoder_t;
+
+// 복원 상태
+typedef struct
+{
+    const uint8_t*  buf;            // 블록
+    uint16_t    len;                // 블록 길이
+    uint16_t    pos;                // 읽은 위치
+    uint16_t    count;              // 블록의 레코드 수
+    uint16_t    index;              // 복원한 레코드 수
+    uint32_t    series_id;          // 계열 ID (계량기 기물번호 등)
+    uint8_t     series_info;        // 계열 정보 (소수점 자리수 등)
+    uint16_t    status;             // 이전 상태
+    uint32_t    timestamp;          // 이전 시각
+    uint32_t    interval;           // 이전 간격
+    uint32_t    reading;            // 이전 검침값
+} MeterCodecDecoder_t;
+
+//******************************************************************************
+// 압축 함수 프로토타입
+//******************************************************************************
+
+/**
+ * @brief 블록 압축 시작 (헤더 기록)
+ * @param enc 압축 상태
+ * @param buf 출력 버퍼
+ * @param size 출력 버퍼 크기 (METER_CODEC_HEADER_SIZE 이상)
+ * @param series_id 계열 ID (복원 시 그대로 반환)
+ * @param series_info 계열 정보 (복원 시 그대로 반환)
+ * @return METER_CODEC_OK 또는 METER_CODEC_ERR_FULL
+ */
+METER_CODEC_ERROR_Type MeterCodec_EncodeBegin(MeterCodecEncoder_t* enc, uint8_t* buf, uint16_t size,
+                                              uint32_t series_id, uint8_t series_info);
+
+/**
+ * @brief 레코드 추가
+ * @param enc 압축 상태
+ * @param sample 레코드
+ * @return METER_CODEC_OK, 실패 시 레코드를 추가하지 않고 에러 코드 (새 블록으로 이어서 압축)
+ * @note 출력 버퍼에 METER_CODEC_MAX_RECORD 바이트 이상 남아 있으면 항상 성공 (범위 초과 제외)
+ */
+METER_CODEC_ERROR_Type MeterCodec_EncodeAdd(MeterCodecEncoder_t* enc, const MeterCodecSample_t* sample);
+
+/**
+ * @brief 블록 압축 끝 (헤더의 레코드 수 기록)
+ * @param enc 압축 상태
+ * @return 블록 길이 (바이트)
+ */
+uint16_t MeterCodec_EncodeEnd(MeterCodecEncoder_t* enc);
+
+/**
+ * @brief 블록 복원 시작 (헤더 확인)
+ * @param dec 복원 상태
+ * @param buf 블록
+ * @param len 블록 길이
+ * @return METER_CODEC_OK 또는 METER_CODEC_ERR_FORMAT
+ */
+METER_CODEC_ERROR_Type MeterCodec_DecodeBegin(MeterCodecDecoder_t* dec, const uint8_t* buf, uint16_t len);
+
+/**
+ * @brief 다음 레코드 복원
+ * @param dec 복원 상태
+ * @param sample 레코드 (출력)
+ * @return METER_CODEC_OK, METER_CODEC_END 또는 METER_CODEC_ERR_FORMAT
+ */
+METER_CODEC_ERROR_Type MeterCodec_DecodeNext(MeterCodecDecoder_t* dec, MeterCodecSample_t* sample);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _METER_CODEC_H_ */
@@ -0,0 +1,380 @@
+/**
+ *******************************************************************************
+ * @file        meter_event.c
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       run-to-completion 우선순위 이벤트 큐
+ * @details     링 인덱스는 메인 컨텍스트와 인터럽트가 함께 바꾸므로 게시/꺼내기는
+ *              PRIMASK를 저장하고 인터럽트를 금지한 짧은 구간에서만 한다.
+ *              핸들러는 인터럽트 허가 상태로 실행된다.
+ *******************************************************************************
+ */
+
+#include "meter_event.h"
+#include "meter_protocol.h"
+#include "meter_power.h"
+#include <string.h>
+
+//******************************************************************************
+// 내부 상수/구조체
+//******************************************************************************
+
+#define EVENT_MASK          (METER_EVENT_QUEUE_SIZE - 1)
+
+// 구독 (이벤트 ID별)
+typedef struct
+{
+    MeterEventHandler_t handler;
+    uint8_t             prio;       // METER_EVENT_PRIO_Type
+    uint8_t             flags;      // METER_EVENT_COALESCE
+} METER_EVENT_SUB_Type;
+
+// 우선순위별 링 (head: 게시, tail: 꺼내기)
+typedef struct
+{
+    MeterEvent_t        buf[METER_EVENT_QUEUE_SIZE];
+    volatile uint8_t    head;
+    volatile uint8_t    tail;
+} METER_EVENT_RING_Type;
+
+// 주기 타이머
+typedef struct
+{
+    uint32_t            due;        // 다음 게시 시각 (Meter_GetTickMs)
+    uint32_t            period;     // 0: 사용 안 함
+    uint8_t             id;
+} METER_EVENT_TIMER_Type;
+
+//******************************************************************************
+// 내부 변수
+//******************************************************************************
+
+static METER_EVENT_SUB_Type     g_evt_sub[METER_EVT_COUNT];
+static METER_EVENT_RING_Type    g_evt_ring[METER_EVENT_PRIO_COUNT];
+static METER_EVENT_TIMER_Type   g_evt_timer[METER_EVENT_TIMER_COUNT];
+static volatile uint8_t         g_evt_pending[METER_EVT_COUNT];     // 병합 이벤트 대기 중
+static MeterEventStats_t        g_evt_stats[METER_EVT_COUNT];
+static MeterEventQueueStats_t   g_evt_queue_stats;
+
+//******************************************************************************
+// 내부 함수 선언
+//******************************************************************************
+
+static void MeterEvent_PostTimers(void);
+static uint32_t MeterEvent_GetTimerMs(void);
+static uint32_t MeterEvent_Micros(void);
+
+//******************************************************************************
+// 함수 구현
+//******************************************************************************
+
+/**
+ * @brief 큐, 구독, 타이머, 통계 초기화
+ */
+void MeterEvent_Init(void)
+{
+    memset(g_evt_sub, 0, sizeof(g_evt_sub));
+    memset(g_evt_ring, 0, sizeof(g_evt_ring));
+    memset(g_evt_timer, 0, sizeof(g_evt_timer));
+    memset((void*)g_evt_pending, 0, sizeof(g_evt_pending));
+
+    MeterEvent_ResetStats();
+}
+
+/**
+ * @brief 이벤트 핸들러 등록
+ */
+void MeterEvent_Subscribe(METER_EVT_Type id, METER_EVENT_PRIO_Type prio, uint8_t flags,
+                          MeterEventHandler_t handler)
+{
+    if (id >= METER_EVT_COUNT || prio >= METER_EVENT_PRIO_COUNT)
+    {
+        return;
+    }
+
+    g_evt_sub[id].handler = handler;
+    g_evt_sub[id].prio = (uint8_t)prio;
+    g_evt_sub[id].flags = flags;
+}
+
+/**
+ * @brief 이벤트 게시
+ */
+bool MeterEvent_Post(METER_EVT_Type id, uint8_t arg, uint16_t len, void* ptr)
+{
+    METER_EVENT_RING_Type* ring;
+    MeterEvent_t* evt;
+    uint32_t primask;
+    uint8_t depth;
+    bool ok = true;
+
+    if (id >= METER_EVT_COUNT)
+    {
+        return false;
+    }
+
+    ring = &g_evt_ring[g_evt_sub[id].prio];
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if ((g_evt_sub[id].flags & METER_EVENT_COALESCE) && g_evt_pending[id])
+    {
+        // 이미 대기 중: 한 번 실행으로 충분
+    }
+    else if (((ring->head + 1) & EVENT_MASK) == ring->tail)
+    {
+        g_evt_queue_stats.dropped++;
+        ok = false;
+    }
+    else
+    {
+        evt = &ring->buf[ring->head];
+        evt->id = (uint8_t)id;
+        evt->arg = arg;
+        evt->len = len;
+        evt->ptr = ptr;
+        ring->head = (uint8_t)((ring->head + 1) & EVENT_MASK);
+        g_evt_pending[id] = 1;
+
+        depth = (uint8_t)((ring->head - ring->tail) & EVENT_MASK);
+        if (depth > g_evt_queue_stats.max_depth[g_evt_sub[id].prio])
+        {
+            g_evt_queue_stats.max_depth[g_evt_sub[id].prio] = depth;
+        }
+    }
+
+    __set_PRIMASK(primask);
+
+    return ok;
+}
+
+/**
+ * @brief 주기 타이머 설정
+ */
+void MeterEvent_SetTimer(METER_EVT_Type id, uint32_t period_ms)
+{
+    uint8_t i;
+    uint8_t slot = METER_EVENT_TIMER_COUNT;
+
+    for (i = 0; i < METER_EVENT_TIMER_COUNT; i++)
+    {
+        if (g_evt_timer[i].period != 0 && g_evt_timer[i].id == id)
+        {
+            slot = i;
+            break;
+        }
+        if (g_evt_timer[i].period == 0 && slot == METER_EVENT_TIMER_COUNT)
+        {
+            slot = i;
+        }
+    }
+
+    if (slot == METER_EVENT_TIMER_COUNT)
+    {
+        return;
+    }
+
+    g_evt_timer[slot].id = (uint8_t)id;
+    g_evt_timer[slot].period = period_ms;
+    g_evt_timer[slot].due = Meter_GetTickMs() + period_ms;
+}
+
+/**
+ * @brief 가장 높은 우선순위 이벤트 하나를 끝까지 실행
+ */
+bool MeterEvent_Dispatch(void)
+{
+    METER_EVENT_RING_Type* ring;
+    MeterEventStats_t* stats;
+    MeterEventHandler_t handler;
+    MeterEvent_t evt;
+    uint32_t primask;
+    uint32_t start;
+    uint32_t us;
+    uint8_t prio;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    for (prio = 0; prio < METER_EVENT_PRIO_COUNT; prio++)
+    {
+        ring = &g_evt_ring[prio];
+        if (ring->head != ring->tail)
+        {
+            evt = ring->buf[ring->tail];
+            ring->tail = (uint8_t)((ring->tail + 1) & EVENT_MASK);
+
+            // 실행 전에 지우므로 핸들러 실행 중 게시된 병합 이벤트는 한 번 더 실행됨
+            g_evt_pending[evt.id] = 0;
+            break;
+        }
+    }
+
+    __set_PRIMASK(primask);
+
+    if (prio == METER_EVENT_PRIO_COUNT)
+    {
+        return false;
+    }
+
+    handler = g_evt_sub[evt.id].handler;
+    if (handler == NULL)
+    {
+        return true;
+    }
+
+    start = MeterEvent_Micros();
+    handler(&evt);
+    us = MeterEvent_Micros() - start;
+
+    stats = &g_evt_stats[evt.id];
+    stats->runs++;
+    stats->total_us += us;
+    if (us > stats->max_us)
+    {
+        stats->max_us = us;
+    }
+
+    return true;
+}
+
+/**
+ * @brief 이벤트 대기 여부
+ */
+bool MeterEvent_IsPending(void)
+{
+    uint8_t prio;
+
+    for (prio = 0; prio < METER_EVENT_PRIO_COUNT; prio++)
+    {
+        if (g_evt_ring[prio].head != g_evt_ring[prio].tail)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief 이벤트 루프
+ */
+void MeterEvent_Run(void)
+{
+    MeterEvent_Post(METER_EVT_SERVICE, 0, 0, NULL);
+
+    while (1)
+    {
+        MeterEvent_PostTimers();
+
+        if (MeterEvent_Dispatch())
+        {
+            continue;
+        }
+
+        // 큐가 비었을 때만 잠 (프로토콜/로그/NOR 기한은 MeterPower_Idle()이 함께 고려)
+        MeterPower_Idle(MeterEvent_GetTimerMs());
+
+        // 깨운 인터럽트나 도달한 기한의 일은 서비스 태스크가 처리
+        MeterEvent_Post(METER_EVT_SERVICE, 0, 0, NULL);
+    }
+}
+
+/**
+ * @brief 핸들러별 통계 조회
+ */
+const MeterEventStats_t* MeterEvent_GetStats(METER_EVT_Type id)
+{
+    return (id < METER_EVT_COUNT) ? &g_evt_stats[id] : NULL;
+}
+
+/**
+ * @brief 큐 통계 조회
+ */
+const MeterEventQueueStats_t* MeterEvent_GetQueueStats(void)
+{
+    return &g_evt_queue_stats;
+}
+
+/**
+ * @brief 핸들러/큐 통계 초기화
+ */
+void MeterEvent_ResetStats(void)
+{
+    memset(g_evt_stats, 0, sizeof(g_evt_stats));
+    memset(&g_evt_queue_stats, 0, sizeof(g_evt_queue_stats));
+}
+
+//******************************************************************************
+// 내부 함수 구현
+//******************************************************************************
+
+/**
+ * @brief 기한이 지난 타이머의 이벤트 게시
+ * @details 다음 기한은 게시 시각 기준 (파워다운이 길어져도 밀린 주기를 몰아서 게시하지 않음)
+ */
+static void MeterEvent_PostTimers(void)
+{
+    uint32_t now = Meter_GetTickMs();
+    uint8_t i;
+
+    for (i = 0; i < METER_EVENT_TIMER_COUNT; i++)
+    {
+        if (g_evt_timer[i].period != 0 && (int32_t)(now - g_evt_timer[i].due) >= 0 &&
+            MeterEvent_Post((METER_EVT_Type)g_evt_timer[i].id, 0, 0, NULL))
+        {
+            g_evt_timer[i].due = now + g_evt_timer[i].period;
+        }
+    }
+}
+
+/**
+ * @brief 가장 가까운 타이머 기한까지 남은 시간
+ * @return ms (0: 지남, METER_TICK_NEVER: 타이머 없음)
+ */
+static uint32_t MeterEvent_GetTimerMs(void)
+{
+    uint32_t now = Meter_GetTickMs();
+    uint32_t wait = METER_TICK_NEVER;
+    int32_t left;
+    uint8_t i;
+
+    for (i = 0; i < METER_EVENT_TIMER_COUNT; i++)
+    {
+        if (g_evt_timer[i].period != 0)
+        {
+            left = (int32_t)(g_evt_timer[i].due - now);
+            if (left <= 0)
+            {
+                return 0;
+            }
+            if ((uint32_t)left < wait)
+            {
+                wait = (uint32_t)left;
+            }
+        }
+    }
+
+    return wait;
+}
+
+/**
+ * @brief 부팅 후 경과 시간 (us, SysTick 밀리초 + 현재 주기 내 경과, 2^32 모듈로)
+ * @details 밀리초 카운터를 두 번 읽어 그 사이 SysTick 인터럽트가 없었던 값만 사용한다.
+ *          주기 내 경과는 현재 코어 클럭으로 환산하므로 핸들러 안에서 클럭 단계가 바뀌어도
+ *          (MeterClock_Boost) 1ms 미만의 오차만 생긴다.
+ *          인터럽트를 금지한 구간이 1ms를 넘으면 그만큼 적게 측정된다.
+ */
+static uint32_t MeterEvent_Micros(void)
+{
+    uint32_t ms;
+    uint32_t val;
+
+    do
+    {
+        ms = Meter_GetTickMs();
+        val = SysTick->VAL;
+    } while (ms != Meter_GetTickMs());
+
+    return ms * 1000 + (SysTick->LOAD - val) / (SystemCoreClock / 1000000);
+}
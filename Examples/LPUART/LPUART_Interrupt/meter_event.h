@@ -0,0 +1,157 @@
+/**
+ *******************************************************************************
+ * @file        meter_event.h
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       run-to-completion 우선순위 이벤트 큐
+ * @details     애플리케이션 작업은 모두 이벤트 핸들러로 메인 컨텍스트에서 끝까지 실행된다.
+ *              - 인터럽트는 이벤트만 게시 (MeterEvent_Post, 인터럽트 금지 구간으로 보호)
+ *              - 우선순위별 정적 링 (힙 없음), 높은 우선순위부터 한 번에 하나씩 실행
+ *              - 주기 타이머가 기한에 이벤트를 게시
+ *              - 큐가 비었을 때만 MeterPower_Idle()로 잠 (sleep 결정은 여기 한 곳)
+ *              - 핸들러별 실행 횟수/누적/최대 시간 (SysTick 기준 us)
+ *******************************************************************************
+ */
+
+#ifndef _METER_EVENT_H_
+#define _METER_EVENT_H_
+
+#include "main_conf.h"
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//******************************************************************************
+// 이벤트 상수 정의
+//******************************************************************************
+
+#define METER_EVENT_QUEUE_SIZE      4           // 우선순위별 링 크기 (2의 거듭제곱)
+#define METER_EVENT_TIMER_COUNT     2           // 주기 타이머 수
+
+typedef char MeterEvent_QueueSizeCheck_t[((METER_EVENT_QUEUE_SIZE & (METER_EVENT_QUEUE_SIZE - 1)) == 0) ? 1 : -1];
+
+// 구독 플래그
+#define METER_EVENT_COALESCE        0x01        // 이미 대기 중이면 다시 게시하지 않음 (인자 무시)
+
+// 이벤트 ID
+typedef enum
+{
+    METER_EVT_SERVICE = 0,          // 프로토콜/로그/NOR 태스크, 디버그 키 확인 (인터럽트, 깨어남)
+    METER_EVT_POLL,                 // 검침 명령 송신 (주기 타이머)
+    METER_EVT_FRAME,                // 수신 프레임 처리 (arg: 포트, len: 길이, ptr: 프레임 버퍼)
+    METER_EVT_ERROR,                // 프로토콜 오류 (arg: 포트, len: METER_ERROR_Type)
+    METER_EVT_KEY,                  // 디버그 키 (arg: 문자)
+    METER_EVT_COUNT
+} METER_EVT_Type;
+
+// 우선순위
+typedef enum
+{
+    METER_EVENT_PRIO_HIGH = 0,
+    METER_EVENT_PRIO_NORMAL,
+    METER_EVENT_PRIO_LOW,
+    METER_EVENT_PRIO_COUNT
+} METER_EVENT_PRIO_Type;
+
+//******************************************************************************
+// 이벤트 구조체
+//******************************************************************************
+
+// 이벤트 (8바이트, 큐에 값으로 저장)
+typedef struct
+{
+    uint8_t     id;                 // METER_EVT_Type
+    uint8_t     arg;                // 포트, 키 문자 등
+    uint16_t    len;                // 데이터 길이, 오류 코드 등
+    void*       ptr;                // 데이터 (소유권은 핸들러로 넘어감)
+} MeterEvent_t;
+
+typedef void (*MeterEventHandler_t)(const MeterEvent_t* evt);
+
+// 핸들러별 실행 시간 통계
+typedef struct
+{
+    uint32_t    runs;               // 실행 횟수
+    uint32_t    total_us;           // 누적 실행 시간 (us)
+    uint32_t    max_us;             // 최대 실행 시간 (us)
+} MeterEventStats_t;
+
+// 큐 통계
+typedef struct
+{
+    uint32_t    dropped;            // 링이 가득 차 버린 게시
+    uint8_t     max_depth[METER_EVENT_PRIO_COUNT];  // 우선순위별 최대 대기 수
+} MeterEventQueueStats_t;
+
+//******************************************************************************
+// 이벤트 함수 프로토타입
+//******************************************************************************
+
+/**
+ * @brief 큐, 구독, 타이머, 통계 초기화
+ */
+void MeterEvent_Init(void);
+
+/**
+ * @brief 이벤트 핸들러 등록
+ * @param id 이벤트 ID
+ * @param prio 우선순위
+ * @param flags METER_EVENT_COALESCE 또는 0
+ * @param handler 핸들러 (NULL: 게시된 이벤트 무시)
+ */
+void MeterEvent_Subscribe(METER_EVT_Type id, METER_EVENT_PRIO_Type prio, uint8_t flags,
+                          MeterEventHandler_t handler);
+
+/**
+ * @brief 이벤트 게시 (인터럽트/메인 컨텍스트 모두 가능)
+ * @return false: 링이 가득 참 (ptr 소유권은 호출자에게 남음)
+ * @note 병합(METER_EVENT_COALESCE)된 게시는 true
+ */
+bool MeterEvent_Post(METER_EVT_Type id, uint8_t arg, uint16_t len, void* ptr);
+
+/**
+ * @brief 주기 타이머 설정
+ * @param id 기한마다 게시할 이벤트 (인자 0)
+ * @param period_ms 주기 (0: 해제), 첫 게시는 지금부터 period_ms 후
+ */
+void MeterEvent_SetTimer(METER_EVT_Type id, uint32_t period_ms);
+
+/**
+ * @brief 가장 높은 우선순위 이벤트 하나를 끝까지 실행
+ * @return false: 큐가 비어 있음
+ */
+bool MeterEvent_Dispatch(void);
+
+/**
+ * @brief 이벤트 대기 여부 (MeterPower_Idle()의 진입 직전 확인용)
+ */
+bool MeterEvent_IsPending(void);
+
+/**
+ * @brief 이벤트 루프 (반환하지 않음)
+ * @details 기한 도달 타이머 게시 → 이벤트 실행을 반복하다가 큐가 비면
+ *          다음 타이머 기한까지 MeterPower_Idle()로 자고, 깨어나면 METER_EVT_SERVICE를 게시한다.
+ */
+void MeterEvent_Run(void);
+
+/**
+ * @brief 핸들러별 통계 조회
+ */
+const MeterEventStats_t* MeterEvent_GetStats(METER_EVT_Type id);
+
+/**
+ * @brief 큐 통계 조회
+ */
+const MeterEventQueueStats_t* MeterEvent_GetQueueStats(void);
+
+/**
+ * @brief 핸들러/큐 통계 초기화
+ */
+void MeterEvent_ResetStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _METER_EVENT_H_ */
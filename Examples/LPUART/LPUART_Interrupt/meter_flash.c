@@ -0,0 +1,289 @@
+/**
+ *******************************************************************************
+ * @file        meter_flash.c
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       RAM 실행 flash 페이지 지우기/쓰기 (비동기 시작 + 완료 통지)
+ * @details     FMC 명령 순서는 A31L12x_hal_fmc.c의 HAL_FMC_FlashFunction()과 같다.
+ *              HAL 함수는 flash에서 실행되며 동작 내내 전역 인터럽트를 금지하므로
+ *              그동안 SysTick 틱이 유실된다 (SysTick 보류 비트는 1개).
+ *              METER_RAMFUNC 함수는 동작 중 flash의 코드/상수를 참조하지 않아야 한다
+ *              (라이브러리 함수, 나눗셈, switch 도움 함수 사용 금지).
+ *******************************************************************************
+ */
+
+#include "meter_flash.h"
+
+//******************************************************************************
+// 전역 변수
+//******************************************************************************
+
+// RAM 벡터 테이블 (VTOR, 48워드 → 256바이트 정렬)
+#if defined (__ICCARM__)
+#pragma data_alignment = 256
+static uint32_t g_flash_vectors[METER_FLASH_VECTOR_COUNT];
+#else
+static uint32_t g_flash_vectors[METER_FLASH_VECTOR_COUNT] __attribute__((aligned(256)));
+#endif
+
+static void (*g_flash_systick)(void);               // 원래 SysTick 핸들러 (flash)
+static volatile uint32_t g_flash_ticks = 0;         // 원래 핸들러에 전달할 틱 수
+static volatile bool g_flash_busy = false;
+static volatile uint32_t g_flash_result = FLASH_PGM_GOOD;
+static MeterFlashCallback_t g_flash_done = NULL;
+static uint32_t g_flash_irq_enable;                 // 동작 전 NVIC 인터럽트 허가 상태
+static uint32_t g_flash_id1;                        // 확인 값 (HAL_FMC_FlashEntry와 같은 XOR 보관)
+static uint32_t g_flash_id2;
+
+//******************************************************************************
+// 내부 함수 선언
+//******************************************************************************
+
+static METER_RAMFUNC uint32_t MeterFlash_Start(uint32_t u32FncSel, uint32_t u32Addr, const uint32_t* u32Buf,
+                                               MeterFlashCallback_t done);
+static METER_RAMFUNC void MeterFlash_Poll(void);
+static METER_RAMFUNC void MeterFlash_SysTickHandler(void);
+
+//******************************************************************************
+// 함수 구현
+//******************************************************************************
+
+/**
+ * @brief 벡터 테이블을 RAM으로 복사하고 SysTick 전단 핸들러 설치
+ */
+void MeterFlash_Init(void)
+{
+    const uint32_t* vectors = (const uint32_t*)SCB->VTOR;
+    uint8_t i;
+
+    for (i = 0; i < METER_FLASH_VECTOR_COUNT; i++)
+    {
+        g_flash_vectors[i] = vectors[i];
+    }
+
+    g_flash_systick = (void (*)(void))g_flash_vectors[METER_FLASH_SYSTICK_VECTOR];
+    g_flash_vectors[METER_FLASH_SYSTICK_VECTOR] = (uint32_t)MeterFlash_SysTickHandler;
+
+    SCB->VTOR = (uint32_t)g_flash_vectors;
+    __DSB();
+}
+
+/**
+ * @brief 페이지 지우기 시작 (완료를 기다리지 않음)
+ */
+METER_RAMFUNC uint32_t MeterFlash_StartErase(uint32_t u32UserId, uint32_t u32Addr, MeterFlashCallback_t done)
+{
+    if (u32UserId != 0xA901358F)        // HAL_FMC_PageErase()와 같은 확인 값
+    {
+        return FLASH_PGM_FAIL;
+    }
+
+    return MeterFlash_Start(FLASH_PAGE_ERASE, u32Addr, NULL, done);
+}
+
+/**
+ * @brief 페이지 쓰기 시작 (완료를 기다리지 않음)
+ */
+METER_RAMFUNC uint32_t MeterFlash_StartWrite(uint32_t u32UserId, uint32_t u32Addr, const uint32_t* u32Buf,
+                                             MeterFlashCallback_t done)
+{
+    if (u32UserId != 0x4F17DC86)        // HAL_FMC_PageWrite()와 같은 확인 값
+    {
+        return FLASH_PGM_FAIL;
+    }
+
+    return MeterFlash_Start(FLASH_PAGE_WRITE, u32Addr, u32Buf, done);
+}
+
+/**
+ * @brief 진행 중인 동작 완료 대기
+ * @details FMBUSY를 직접 확인하므로 완료 직후 반환한다 (SysTick 주기를 기다리지 않음)
+ */
+METER_RAMFUNC uint32_t MeterFlash_Wait(void)
+{
+    while (g_flash_busy)
+    {
+        MeterFlash_Poll();
+    }
+
+    return g_flash_result;
+}
+
+/**
+ * @brief 페이지 지우기 (시작 + 완료 대기)
+ */
+METER_RAMFUNC uint32_t MeterFlash_PageErase(uint32_t u32UserId, uint32_t u32Addr)
+{
+    if (MeterFlash_StartErase(u32UserId, u32Addr, NULL) != FLASH_PGM_GOOD)
+    {
+        return FLASH_PGM_FAIL;
+    }
+
+    return MeterFlash_Wait();
+}
+
+/**
+ * @brief 페이지 쓰기 (시작 + 완료 대기)
+ */
+METER_RAMFUNC uint32_t MeterFlash_PageWrite(uint32_t u32UserId, uint32_t u32Addr, const uint32_t* u32Buf)
+{
+    if (MeterFlash_StartWrite(u32UserId, u32Addr, u32Buf, NULL) != FLASH_PGM_GOOD)
+    {
+        return FLASH_PGM_FAIL;
+    }
+
+    return MeterFlash_Wait();
+}
+
+/**
+ * @brief FMC 동작 중 여부
+ */
+bool MeterFlash_IsBusy(void)
+{
+    return g_flash_busy;
+}
+
+//******************************************************************************
+// 내부 함수 구현
+//******************************************************************************
+
+/**
+ * @brief FMC 페이지 지우기/쓰기 시작
+ * @param u32FncSel FLASH_PAGE_ERASE 또는 FLASH_PAGE_WRITE
+ * @param u32Addr 페이지 주소
+ * @param u32Buf 쓰기 데이터 (지우기: NULL)
+ * @param done 완료 통지
+ * @return FLASH_PGM_GOOD: 시작됨, FLASH_PGM_FAIL: 동작 중이거나 인자 오류
+ * @details 주변장치 인터럽트를 모두 보류한 뒤 시작한다 (핸들러가 flash에 있음).
+ *          SysTick은 RAM 전단 핸들러로 계속 처리되며 완료를 확인한다.
+ *          준비 과정을 인터럽트 금지 구간에 두므로 시작과 동작 중 표시 사이에
+ *          SysTick이 완료로 오인하거나 NVIC 허가 상태가 바뀌지 않는다.
+ */
+static METER_RAMFUNC uint32_t MeterFlash_Start(uint32_t u32FncSel, uint32_t u32Addr, const uint32_t* u32Buf,
+                                               MeterFlashCallback_t done)
+{
+    volatile uint32_t* pagebuffer = &FMC->PAGEBUF;
+    uint32_t primask;
+    uint32_t i;
+
+    if (g_flash_busy)
+    {
+        return FLASH_PGM_FAIL;
+    }
+
+    // 준비 과정(페이지 버퍼 32워드)만 인터럽트 금지, 동작 중에는 SysTick 허용
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    // 주변장치 인터럽트 보류 (보류 플래그는 유지, 완료 시 다시 허가)
+    g_flash_irq_enable = NVIC->ISER[0];
+    NVIC->ICER[0] = 0xFFFFFFFFUL;
+
+    g_flash_id1 = FLASH_ID1 ^ FLASH_IDXOR;
+    g_flash_id2 = FLASH_ID2 ^ FLASH_IDXOR;
+    SCUCG->PPCLKEN2_b.FMCLKE = 1;       // Enable Flash Memory Control Clock
+
+    if (WDT->CNT < WDT->WINDR)
+    {
+        WDT->CNTR_b.CNTR = 0x6a;        // Reload WDT Counter if WDT->CNT < WDT_WINDR
+    }
+
+    FMC->ADR = FLASH_ADDR_CD0;
+    FMC->IDR1 = g_flash_id1 ^ FLASH_IDXOR;
+    FMC->IDR2 = g_flash_id2 ^ FLASH_IDXOR;
+
+    FMC->CR = FLASH_CLR_PAGEBUF;
+    for (i = 0; i < SECTOR_SIZE_BYTE / 4; i++)
+    {
+        *pagebuffer++ = (u32FncSel == FLASH_PAGE_WRITE) ? *u32Buf++ : 0xFFFFFFFFUL;
+    }
+
+    FMC->ADR = (u32Addr < FLASH_START_ADDR) ? (u32Addr + FLASH_START_ADDR) : u32Addr;
+
+    if (FMC->IDR1 != FLASH_ID1 || FMC->IDR2 != FLASH_ID2 ||
+        FMC->ADR < FLASH_START_ADDR || FMC->ADR > FLASH_END_ADDR)
+    {
+        g_flash_id1 = 0;
+        g_flash_id2 = 0;
+        FMC->ERFLAG = 0x03uL;           // Clear FMC related flag
+        SCUCG->PPCLKEN2_b.FMCLKE = 0;
+        NVIC->ISER[0] = g_flash_irq_enable;
+        __set_PRIMASK(primask);
+        return FLASH_PGM_FAIL;
+    }
+
+    g_flash_done = done;
+    g_flash_busy = true;
+    FMC->CR = FLASH_MEM_PGM_CODE | (u32FncSel & 0x0000000F);    // Start flash page erase/write from here
+
+    __set_PRIMASK(primask);
+
+    return FLASH_PGM_GOOD;
+}
+
+/**
+ * @brief 완료 확인 (FMBUSY 해제 시 정리, 인터럽트 재허가, 완료 통지)
+ * @details SysTick 전단 핸들러와 MeterFlash_Wait()에서 호출
+ */
+static METER_RAMFUNC void MeterFlash_Poll(void)
+{
+    MeterFlashCallback_t done = NULL;
+    uint32_t result = FLASH_PGM_GOOD;
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (g_flash_busy && !FMC->CR_b.FMBUSY)
+    {
+        if (FMC->ERFLAG_b.FMOPFLAG)
+        {
+            result = FLASH_PGM_FAIL;
+            FMC->ERFLAG = 0x03uL;       // Clear FMC related flag
+        }
+
+        g_flash_id1 = 0;
+        g_flash_id2 = 0;
+        SCUCG->PPCLKEN2_b.FMCLKE = 0;   // Disable Flash Memory Control Clock
+
+        g_flash_result = result;
+        done = g_flash_done;
+        g_flash_done = NULL;
+        g_flash_busy = false;
+
+        NVIC->ISER[0] = g_flash_irq_enable;
+    }
+
+    __set_PRIMASK(primask);
+
+    // flash 유휴 상태이므로 flash에 있는 통지 함수 호출 가능
+    if (done != NULL)
+    {
+        done(result);
+    }
+}
+
+/**
+ * @brief SysTick 전단 핸들러 (RAM 벡터 테이블에 설치)
+ * @details FMC 동작 중에는 틱만 모으고 완료를 확인한다. 유휴 상태가 되면 모은 틱만큼
+ *          원래 핸들러(Meter_SysTick_Increment)를 호출하므로 Meter_GetTickMs()가 밀리지 않는다.
+ */
+static METER_RAMFUNC void MeterFlash_SysTickHandler(void)
+{
+    g_flash_ticks++;
+
+    if (g_flash_busy)
+    {
+        MeterFlash_Poll();
+
+        if (g_flash_busy)
+        {
+            return;
+        }
+    }
+
+    while (g_flash_ticks != 0)
+    {
+        g_flash_ticks--;
+        g_flash_systick();
+    }
+}
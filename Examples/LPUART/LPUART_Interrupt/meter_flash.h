@@ -0,0 +1,106 @@
+/**
+ *******************************************************************************
+ * @file        meter_flash.h
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       RAM 실행 flash 페이지 지우기/쓰기 (비동기 시작 + 완료 통지)
+ * @details     FMC 동작(페이지 지우기/쓰기 각 최대 3.5ms) 중에는 flash를 읽을 수 없으므로
+ *              FMC 시작/대기 코드, 벡터 테이블, SysTick 전단 핸들러를 RAM에 둔다.
+ *              동작 중 SysTick은 RAM에서 계속 계수하고(완료 후 놓친 틱만큼 원래 핸들러 호출),
+ *              주변장치 인터럽트는 보류했다가 완료 즉시 처리한다.
+ *              보류 시간(최대 3.5ms)은 1200bps 1문자 시간(8.3ms)보다 짧으므로
+ *              수신 바이트는 수신 버퍼에 남아 유실되지 않는다.
+ *******************************************************************************
+ */
+
+#ifndef _METER_FLASH_H_
+#define _METER_FLASH_H_
+
+#include "main_conf.h"
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//******************************************************************************
+// flash 상수 정의
+//******************************************************************************
+
+// RAM 실행 함수 (KEIL: 분산 적재 파일의 "ramfunc" 섹션, IAR: initialize by copy { readwrite })
+#if defined (__ICCARM__)
+#define METER_RAMFUNC               __ramfunc
+#else
+#define METER_RAMFUNC               __attribute__((section("ramfunc")))
+#endif
+
+#define METER_FLASH_VECTOR_COUNT    48          // 시스템 예외 16 + IRQ 32 (startup_A31L12x.s)
+#define METER_FLASH_SYSTICK_VECTOR  15          // SysTick 예외 번호
+
+//******************************************************************************
+// flash 구조체
+//******************************************************************************
+
+// 완료 통지 (result: FLASH_PGM_GOOD 또는 FLASH_PGM_FAIL)
+// FMC 유휴 상태에서 호출되므로 flash에 있는 함수여도 된다 (SysTick 인터럽트 또는 MeterFlash_Wait 문맥)
+typedef void (*MeterFlashCallback_t)(uint32_t result);
+
+//******************************************************************************
+// flash 함수 프로토타입
+//******************************************************************************
+
+/**
+ * @brief 벡터 테이블을 RAM으로 복사하고 SysTick 전단 핸들러 설치
+ * @note SysTick_Config() 전에 1회 호출
+ */
+void MeterFlash_Init(void);
+
+/**
+ * @brief 페이지 지우기 시작 (완료를 기다리지 않음)
+ * @param u32UserId 지우기 확인 값 (HAL_FMC_PageErase와 동일)
+ * @param u32Addr 페이지 주소 (0x00000000 ~ 0x0000FFFF)
+ * @param done 완료 통지 (NULL: 없음)
+ * @return FLASH_PGM_GOOD: 시작됨, FLASH_PGM_FAIL: 동작 중이거나 인자 오류
+ * @note flash에 있는 코드로 돌아가면 완료까지 CPU가 멈추므로, flash에 있는 호출자는
+ *       MeterFlash_PageErase()를 사용한다.
+ */
+METER_RAMFUNC uint32_t MeterFlash_StartErase(uint32_t u32UserId, uint32_t u32Addr, MeterFlashCallback_t done);
+
+/**
+ * @brief 페이지 쓰기 시작 (완료를 기다리지 않음)
+ * @param u32UserId 쓰기 확인 값 (HAL_FMC_PageWrite와 동일)
+ * @param u32Addr 페이지 주소
+ * @param u32Buf 쓰기 데이터 (SECTOR_SIZE_BYTE, RAM)
+ * @param done 완료 통지 (NULL: 없음)
+ * @return FLASH_PGM_GOOD: 시작됨, FLASH_PGM_FAIL: 동작 중이거나 인자 오류
+ */
+METER_RAMFUNC uint32_t MeterFlash_StartWrite(uint32_t u32UserId, uint32_t u32Addr, const uint32_t* u32Buf,
+                                             MeterFlashCallback_t done);
+
+/**
+ * @brief 진행 중인 동작 완료 대기 (RAM에서 대기, SysTick 계속 처리)
+ * @return 마지막 동작 결과 (FLASH_PGM_GOOD 또는 FLASH_PGM_FAIL)
+ */
+METER_RAMFUNC uint32_t MeterFlash_Wait(void);
+
+/**
+ * @brief 페이지 지우기 (시작 + 완료 대기)
+ * @return FLASH_PGM_GOOD 또는 FLASH_PGM_FAIL
+ */
+METER_RAMFUNC uint32_t MeterFlash_PageErase(uint32_t u32UserId, uint32_t u32Addr);
+
+/**
+ * @brief 페이지 쓰기 (시작 + 완료 대기)
+ * @return FLASH_PGM_GOOD 또는 FLASH_PGM_FAIL
+ */
+METER_RAMFUNC uint32_t MeterFlash_PageWrite(uint32_t u32UserId, uint32_t u32Addr, const uint32_t* u32Buf);
+
+/**
+ * @brief FMC 동작 중 여부
+ */
+bool MeterFlash_IsBusy(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _METER_FLASH_H_ */
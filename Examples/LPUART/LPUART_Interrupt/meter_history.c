@@ -0,0 +1,1046 @@
+/**
+ *******************************************************************************
+ * @file        meter_history.c
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       외부 NOR 장기 검침 이력 (추가 전용 섹터 링)
+ * @details     섹터는 항상 0 → METER_HISTORY_SECTOR_COUNT-1 순서로 순환 기록되므로
+ *              섹터 순번은 위치와 정렬된다 (meter_log.c의 페이지 링과 같은 방식).
+ *              섹터 안의 레코드는 앞에서부터 채우므로 빈 자리(16바이트 모두 0xFF)도 이진 탐색한다.
+ *              기록은 지우기 → 헤더 → 레코드 → 커밋 비트 순으로 NOR 완료 통지에서 다음 단계로 넘어간다.
+ *              커밋 비트가 0인 자리만 레코드로 읽으므로, 쓰다 만 레코드(전원 차단)나 쓰기에 실패한 자리는
+ *              읽기/시각 조회/마지막 시각 복원에서 건너뛴다.
+ *              섹터가 가득 차면 다음 섹터를 열기 전에 시각 인덱스 항목을 기록한다
+ *              (항목 자리 확인 → 이전 순환의 항목이 있으면 인덱스 섹터 지우기 → 항목 쓰기).
+ *******************************************************************************
+ */
+
+#include "meter_history.h"
+#include "meter_nor_cache.h"
+#include "string.h"
+#include "stddef.h"
+
+//******************************************************************************
+// 전역 변수
+//******************************************************************************
+
+// 진행 중인 기록 단계
+#define HIST_OP_NONE        0
+#define HIST_OP_ERASE       1       // 다음 섹터 지우기
+#define HIST_OP_HEADER      2       // 섹터 헤더 쓰기
+#define HIST_OP_PROGRAM     3       // 레코드 쓰기
+#define HIST_OP_INDEX_CHECK 4       // 인덱스 항목 자리 확인
+#define HIST_OP_INDEX_ERASE 5       // 인덱스 섹터 지우기
+#define HIST_OP_INDEX       6       // 인덱스 항목 쓰기
+#define HIST_OP_COMMIT      7       // 커밋 비트 쓰기
+
+#define HIST_SECTOR_ADDR(seq)   (METER_HISTORY_BASE_ADDR + \
+                                 (((seq) - 1) % METER_HISTORY_SECTOR_COUNT) * METER_NOR_SECTOR_SIZE)
+#define HIST_RECORD_ADDR(seq, slot) (HIST_SECTOR_ADDR(seq) + METER_HISTORY_RECORD_OFS + \
+                                     (uint32_t)(slot) * METER_RECORD_SIZE)
+#define HIST_MAP_ADDR(seq)      (HIST_SECTOR_ADDR(seq) + METER_HISTORY_HEADER_SIZE)
+
+// g_hist_map에 읽어 둔 섹터의 자리 커밋 여부 (비트 0 = 커밋됨)
+#define HIST_COMMITTED(slot)    ((g_hist_map[(slot) >> 3] & (1U << ((slot) & 7))) == 0)
+#define HIST_COMMIT_BYTES   3       // 커밋 비트 쓰기 최대 길이 (한 번에 최대 16자리)
+
+#define HIST_INDEX_ADDR(seq)    (METER_HISTORY_INDEX_ADDR + \
+                                 (((seq) - 1) % METER_HISTORY_INDEX_SLOTS) * METER_HISTORY_INDEX_SIZE)
+
+#define HIST_EMPTY_STAMP    0xFFFFFFFFUL    // 커밋된 레코드가 없음 (MeterHistory_MapSpan())
+
+static bool g_hist_mounted = false;
+static uint32_t g_hist_seq = 0;                 // 최신 섹터 순번 (0: 비어 있음)
+static uint16_t g_hist_used = 0;                // 최신 섹터의 사용한 자리 수 (커밋되지 않은 자리 포함)
+static uint16_t g_hist_head_recs = 0;           // 최신 섹터의 커밋된 레코드 수
+static uint16_t g_hist_sectors = 0;             // 유효 섹터 수
+static uint8_t g_hist_op = HIST_OP_NONE;
+static uint8_t g_hist_prog = 0;                 // 쓰기 중인 레코드 수 (큐 앞부분)
+static MeterRecord_t g_hist_queue[METER_HISTORY_QUEUE_SIZE];    // 기록 대기 (페이지 쓰기 DMA 입력)
+static uint8_t g_hist_count = 0;
+static MeterHistoryHeader_t g_hist_header;      // 헤더 쓰기/Mount 읽기 버퍼
+static MeterHistoryStats_t g_hist_stats;
+static bool g_hist_read_error = false;          // Mount 중 NOR 읽기 실패
+static uint32_t g_hist_head_first;              // 최신 섹터 첫 커밋 레코드 시각 (없으면 직전 섹터의 마지막 시각)
+static uint32_t g_hist_head_last;               // 최신 섹터 마지막 커밋 레코드 시각 (없으면 직전 섹터의 마지막 시각)
+static bool g_hist_commit_pending = false;      // 쓰기가 끝난 큐 앞부분의 커밋 비트를 써야 함
+static uint16_t g_hist_commit_slot;             // 커밋할 첫 자리
+static uint8_t g_hist_commit[HIST_COMMIT_BYTES];    // 커밋 비트 쓰기 DMA 입력
+static uint8_t g_hist_map[METER_HISTORY_MAP_SIZE];  // 커밋 비트맵 (g_hist_map_seq 섹터)
+static uint32_t g_hist_map_seq = 0;             // g_hist_map의 섹터 순번 (0: 없음)
+static bool g_hist_index_pending = false;       // 기록할 인덱스 항목 있음
+static MeterHistoryIndex_t g_hist_index;        // 기록할 인덱스 항목
+static MeterHistoryIndex_t g_hist_index_old;    // 항목 자리 확인/Mount 읽기 버퍼
+
+//******************************************************************************
+// 내부 함수 선언
+//******************************************************************************
+
+static uint32_t MeterHistory_SectorSeq(uint16_t index);
+static bool MeterHistory_SlotErased(uint32_t seq, uint16_t slot);
+static bool MeterHistory_CachedStamp(uint32_t seq, uint16_t slot, uint32_t* stamp);
+static bool MeterHistory_LoadMap(uint32_t seq);
+static uint16_t MeterHistory_NextCommitted(uint16_t slot, uint16_t end);
+static bool MeterHistory_MapSpan(uint32_t seq, uint16_t end, uint32_t* first, uint32_t* last);
+static bool MeterHistory_SectorSpan(uint32_t seq, uint32_t* first, uint32_t* last);
+static void MeterHistory_IndexBuild(uint32_t seq, uint32_t first, uint32_t last, uint16_t count);
+static bool MeterHistory_IndexValid(const MeterHistoryIndex_t* entry, uint32_t seq);
+static void MeterHistory_IndexProgram(void);
+static void MeterHistory_OnIndexCheck(METER_NOR_ERROR_Type result);
+static void MeterHistory_OnIndexErase(METER_NOR_ERROR_Type result);
+static void MeterHistory_OnIndex(METER_NOR_ERROR_Type result);
+static void MeterHistory_OnErase(METER_NOR_ERROR_Type result);
+static void MeterHistory_OnHeader(METER_NOR_ERROR_Type result);
+static void MeterHistory_OnProgram(METER_NOR_ERROR_Type result);
+static void MeterHistory_CommitProgram(void);
+static void MeterHistory_OnCommit(METER_NOR_ERROR_Type result);
+
+//******************************************************************************
+// 함수 구현
+//******************************************************************************
+
+/**
+ * @brief NOR 섹터 헤더를 검사하여 최신 섹터와 기록 위치 복원
+ * @return 저장된 레코드 자리 수
+ * @details 최신 섹터 탐색은 MeterLog_Mount()와 같다 ("유효 && seq >= s0"인 마지막 위치).
+ *          섹터를 지운 뒤 헤더를 쓰기 전에 전원이 끊기면 그 섹터는 무효이며,
+ *          다음 기록 때 같은 위치를 다시 지운다.
+ *          최신 섹터의 첫/마지막 시각은 커밋된 레코드에서만 구한다 (쓰다 만 레코드의 시각은 믿지 않음).
+ */
+uint32_t MeterHistory_Mount(void)
+{
+    uint32_t s0;
+    uint32_t seq;
+    uint32_t first;
+    uint16_t lo;
+    uint16_t hi;
+    uint16_t mid;
+
+    g_hist_mounted = false;
+    g_hist_read_error = false;
+
+    s0 = MeterHistory_SectorSeq(0);
+
+    if (s0 == 0)
+    {
+        lo = METER_HISTORY_SECTOR_COUNT - 1;
+    }
+    else
+    {
+        lo = 0;
+        hi = METER_HISTORY_SECTOR_COUNT - 1;
+
+        while (lo < hi)
+        {
+            mid = (uint16_t)((lo + hi + 1) >> 1);
+            seq = MeterHistory_SectorSeq(mid);
+
+            if (seq != 0 && seq >= s0)
+            {
+                lo = mid;
+            }
+            else
+            {
+                hi = mid - 1;
+            }
+        }
+    }
+
+    g_hist_seq = MeterHistory_SectorSeq(lo);
+    g_hist_sectors = (g_hist_seq < METER_HISTORY_SECTOR_COUNT) ? (uint16_t)g_hist_seq : METER_HISTORY_SECTOR_COUNT;
+    g_hist_used = 0;
+    g_hist_head_recs = 0;
+    g_hist_map_seq = 0;
+
+    // 링이 가득 찬 상태에서 가장 오래된 섹터를 지우던 중 전원 차단: 그 섹터는 제외
+    if (g_hist_sectors == METER_HISTORY_SECTOR_COUNT &&
+        MeterHistory_SectorSeq((uint16_t)((g_hist_seq) % METER_HISTORY_SECTOR_COUNT)) !=
+            g_hist_seq + 1 - METER_HISTORY_SECTOR_COUNT)
+    {
+        g_hist_sectors--;
+    }
+
+    if (g_hist_seq != 0)
+    {
+        // 첫 빈 자리 탐색 (레코드는 앞에서부터 채워짐)
+        lo = 0;
+        hi = METER_HISTORY_RECS_PER_SECTOR;
+
+        while (lo < hi)
+        {
+            mid = (uint16_t)((lo + hi) >> 1);
+
+            if (!MeterHistory_SlotErased(g_hist_seq, mid))
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+
+        // 쓰기 실패나 전원 차단은 빈 자리 뒤에 쓰다 만 자리를 남길 수 있다 (페이지 쓰기의 바이트 순서는 보장되지 않음).
+        // 섹터 끝까지 확인하여 지워지지 않은 마지막 자리 다음부터 기록한다 (사이의 자리는 커밋되지 않아 건너뜀).
+        for (mid = lo; mid < METER_HISTORY_RECS_PER_SECTOR && !g_hist_read_error; mid++)
+        {
+            if (!MeterHistory_SlotErased(g_hist_seq, mid))
+            {
+                lo = mid + 1;
+            }
+        }
+
+        g_hist_used = lo;
+
+        if (!MeterHistory_MapSpan(g_hist_seq, g_hist_used, &g_hist_head_first, &g_hist_head_last))
+        {
+            g_hist_read_error = true;
+        }
+
+        for (mid = 0; mid < g_hist_used; mid++)
+        {
+            if (HIST_COMMITTED(mid))
+            {
+                g_hist_head_recs++;
+            }
+        }
+    }
+
+    // 최신 섹터에 커밋된 레코드가 없음: 직전 섹터의 마지막 시각을 이어받음 (MeterHistory_GetLastStamp(), 섹터 시각 순서)
+    if (g_hist_head_recs == 0)
+    {
+        g_hist_head_last = 0;
+        if (g_hist_sectors > 1 && !MeterHistory_SectorSpan(g_hist_seq - 1, &first, &g_hist_head_last))
+        {
+            g_hist_read_error = true;
+        }
+        g_hist_head_first = g_hist_head_last;
+    }
+
+    g_hist_index_pending = false;
+    g_hist_commit_pending = false;
+    g_hist_prog = 0;
+
+    // 섹터가 가득 찬 뒤 인덱스 항목을 쓰기 전에 전원 차단: 다시 기록
+    if (g_hist_used >= METER_HISTORY_RECS_PER_SECTOR)
+    {
+        // 앞의 캐시 읽기가 미리 읽기를 시작했을 수 있으므로 캐시를 거침
+        if (MeterNorCache_Read(HIST_INDEX_ADDR(g_hist_seq), (uint8_t*)&g_hist_index_old,
+                               sizeof(g_hist_index_old)) != METER_NOR_OK)
+        {
+            g_hist_read_error = true;
+        }
+        else if (!MeterHistory_IndexValid(&g_hist_index_old, g_hist_seq))
+        {
+            MeterHistory_IndexBuild(g_hist_seq, g_hist_head_first, g_hist_head_last, g_hist_head_recs);
+        }
+    }
+
+    if (g_hist_read_error)
+    {
+        return 0;
+    }
+
+    g_hist_op = HIST_OP_NONE;
+    g_hist_mounted = true;
+
+    return MeterHistory_GetCount();
+}
+
+/**
+ * @brief 레코드 추가 (RAM 큐에 대기)
+ * @param rec 레코드
+ * @return METER_HISTORY_OK 또는 에러 코드
+ */
+METER_HISTORY_ERROR_Type MeterHistory_Append(const MeterRecord_t* rec)
+{
+    if (!g_hist_mounted)
+    {
+        return METER_HISTORY_ERR_NOT_MOUNTED;
+    }
+
+    if (g_hist_count >= METER_HISTORY_QUEUE_SIZE)
+    {
+        g_hist_stats.dropped++;
+        return METER_HISTORY_ERR_QUEUE_FULL;
+    }
+
+    // 쓰기 중인 앞부분(g_hist_prog)은 건드리지 않음
+    g_hist_queue[g_hist_count++] = *rec;
+    g_hist_stats.appended++;
+
+    return METER_HISTORY_OK;
+}
+
+/**
+ * @brief 대기 레코드 기록 진행
+ * @details 레코드는 16바이트 정렬이고 헤더도 16바이트이므로 페이지 경계에 걸치지 않는다.
+ *          페이지 쓰기 1회 = 같은 페이지에 남은 자리까지의 대기 레코드.
+ */
+void MeterHistory_Task(void)
+{
+    uint32_t addr;
+    uint16_t room;
+    uint8_t n;
+
+    if (!g_hist_mounted || g_hist_op != HIST_OP_NONE || MeterNor_IsBusy())
+    {
+        return;
+    }
+
+    // 커밋 비트 쓰기 실패: 같은 비트를 다시 씀 (이미 0인 비트는 그대로)
+    if (g_hist_commit_pending)
+    {
+        MeterHistory_CommitProgram();
+        return;
+    }
+
+    // 가득 찬 섹터의 인덱스 항목 먼저 (항목 자리 확인부터)
+    if (g_hist_index_pending)
+    {
+        g_hist_op = HIST_OP_INDEX_CHECK;
+        if (MeterNor_StartRead(HIST_INDEX_ADDR(g_hist_index.seq), (uint8_t*)&g_hist_index_old,
+                               sizeof(g_hist_index_old), MeterHistory_OnIndexCheck) != METER_NOR_OK)
+        {
+            g_hist_op = HIST_OP_NONE;
+        }
+        return;
+    }
+
+    if (g_hist_count == 0)
+    {
+        return;
+    }
+
+    if (g_hist_seq == 0 || g_hist_used >= METER_HISTORY_RECS_PER_SECTOR)
+    {
+        // 다음 섹터 열기: 링이 가득 찼으면 가장 오래된 섹터를 지움
+        if (g_hist_sectors >= METER_HISTORY_SECTOR_COUNT)
+        {
+            g_hist_sectors = METER_HISTORY_SECTOR_COUNT - 1;
+        }
+
+        g_hist_op = HIST_OP_ERASE;
+        MeterNorCache_Invalidate(HIST_SECTOR_ADDR(g_hist_seq + 1), METER_NOR_SECTOR_SIZE);
+        if (MeterNor_StartErase(HIST_SECTOR_ADDR(g_hist_seq + 1), MeterHistory_OnErase) != METER_NOR_OK)
+        {
+            g_hist_op = HIST_OP_NONE;
+        }
+        return;
+    }
+
+    addr = HIST_RECORD_ADDR(g_hist_seq, g_hist_used);
+    room = (uint16_t)((METER_NOR_PAGE_SIZE - addr % METER_NOR_PAGE_SIZE) / METER_RECORD_SIZE);
+
+    n = g_hist_count;
+    if (n > room)
+    {
+        n = (uint8_t)room;
+    }
+    if (n > METER_HISTORY_RECS_PER_SECTOR - g_hist_used)
+    {
+        n = (uint8_t)(METER_HISTORY_RECS_PER_SECTOR - g_hist_used);
+    }
+
+    g_hist_op = HIST_OP_PROGRAM;
+    g_hist_prog = n;
+    MeterNorCache_Invalidate(addr, (uint32_t)n * METER_RECORD_SIZE);
+    if (MeterNor_StartProgram(addr, (const uint8_t*)g_hist_queue, (uint16_t)(n * METER_RECORD_SIZE),
+                              MeterHistory_OnProgram) != METER_NOR_OK)
+    {
+        g_hist_op = HIST_OP_NONE;
+        g_hist_prog = 0;
+    }
+}
+
+/**
+ * @brief 저장된 레코드 읽기 시작 (비동기)
+ */
+uint16_t MeterHistory_StartRead(uint32_t index, MeterRecord_t* rec, uint16_t count, MeterNorCallback_t done)
+{
+    uint32_t total = MeterHistory_GetCount();
+    uint32_t first;
+    uint32_t seq;
+    uint16_t slot;
+    uint16_t n;
+
+    if (!g_hist_mounted || index >= total || count == 0)
+    {
+        return 0;
+    }
+
+    // 가장 오래된 섹터부터의 번호 → 섹터 순번/자리
+    first = g_hist_seq - g_hist_sectors + 1;
+    seq = first + index / METER_HISTORY_RECS_PER_SECTOR;
+    slot = (uint16_t)(index % METER_HISTORY_RECS_PER_SECTOR);
+
+    n = (uint16_t)(METER_HISTORY_RECS_PER_SECTOR - slot);
+    if (n > count)
+    {
+        n = count;
+    }
+    if (n > total - index)
+    {
+        n = (uint16_t)(total - index);
+    }
+
+    if (MeterNor_StartRead(HIST_RECORD_ADDR(seq, slot), (uint8_t*)rec, (uint16_t)(n * METER_RECORD_SIZE),
+                           done) != METER_NOR_OK)
+    {
+        return 0;
+    }
+
+    return n;
+}
+
+/**
+ * @brief 저장된 레코드 읽기 (읽기 캐시, 완료 대기)
+ * @details 섹터 헤더를 건너뛰며 섹터 단위로 나누어 캐시에서 복사한다.
+ *          커밋 비트맵에서 연속으로 커밋된 자리를 한 번에 복사하고, 커밋되지 않은 자리는 건너뛴다.
+ *          기록 중 가장 오래된 섹터가 지워지면 번호가 섹터 하나만큼 밀리므로 구간마다 다시 계산한다.
+ */
+uint16_t MeterHistory_Read(uint32_t* index, MeterRecord_t* rec, uint16_t count)
+{
+    uint32_t total;
+    uint32_t seq;
+    uint16_t slot;
+    uint16_t end;
+    uint16_t done = 0;
+    uint16_t n;
+
+    while (g_hist_mounted && done < count)
+    {
+        total = MeterHistory_GetCount();
+        if (*index >= total)
+        {
+            break;
+        }
+
+        seq = g_hist_seq - g_hist_sectors + 1 + *index / METER_HISTORY_RECS_PER_SECTOR;
+        slot = (uint16_t)(*index % METER_HISTORY_RECS_PER_SECTOR);
+        end = (seq == g_hist_seq) ? g_hist_used : METER_HISTORY_RECS_PER_SECTOR;
+
+        if (!MeterHistory_LoadMap(seq))
+        {
+            break;
+        }
+
+        // 커밋되지 않은 자리 건너뛰기
+        n = (uint16_t)(MeterHistory_NextCommitted(slot, end) - slot);
+        if (n != 0)
+        {
+            *index += n;
+            continue;
+        }
+
+        // 연속으로 커밋된 자리
+        for (n = 1; slot + n < end && n < count - done && HIST_COMMITTED(slot + n); n++)
+        {
+        }
+
+        if (MeterNorCache_Read(HIST_RECORD_ADDR(seq, slot), (uint8_t*)&rec[done],
+                               (uint16_t)(n * METER_RECORD_SIZE)) != METER_NOR_OK)
+        {
+            break;
+        }
+
+        done += n;
+        *index += n;
+    }
+
+    return done;
+}
+
+/**
+ * @brief 시각 이상인 첫 레코드 찾기
+ * @details 1) 마지막 시각 >= stamp 인 첫 섹터를 이진 탐색 (섹터마다 인덱스 항목 1회 읽기)
+ *          2) 그 섹터 안에서 시각 >= stamp 인 첫 커밋 레코드를 이진 탐색 (최대 8회 읽기).
+ *             중간 자리가 커밋되지 않았으면 그 뒤의 첫 커밋 자리를 비교한다 (비트맵은 RAM).
+ *          인덱스 항목이 없는 섹터(기록 전 전원 차단, 인덱스 섹터를 중간에서 지움)는
+ *          첫/마지막 커밋 레코드를 직접 읽는다.
+ *          커밋된 레코드가 없는 섹터는 직전 섹터의 마지막 시각을 이어받으므로 다음 섹터에서 찾을 수 있다.
+ */
+uint32_t MeterHistory_Find(uint32_t stamp)
+{
+    uint32_t total = MeterHistory_GetCount();
+    uint32_t oldest;
+    uint32_t lo;
+    uint32_t hi;
+    uint32_t mid;
+    uint32_t first;
+    uint32_t last;
+    uint16_t end;
+    uint16_t a;
+    uint16_t b;
+    uint16_t m;
+    uint16_t k;
+
+    if (!g_hist_mounted || total == 0)
+    {
+        return total;
+    }
+
+    oldest = g_hist_seq - g_hist_sectors + 1;
+
+    // 섹터 탐색 (hi = g_hist_seq + 1: 해당 섹터 없음)
+    lo = oldest;
+    hi = g_hist_seq + 1;
+
+    while (lo < hi)
+    {
+        mid = lo + ((hi - lo) >> 1);
+
+        if (!MeterHistory_SectorSpan(mid, &first, &last))
+        {
+            return total;
+        }
+
+        if (last >= stamp)
+        {
+            hi = mid;
+        }
+        else
+        {
+            lo = mid + 1;
+        }
+    }
+
+    // 섹터 안 탐색 (b 이후의 첫 커밋 레코드는 항상 조건을 만족)
+    for (; lo <= g_hist_seq; lo++)
+    {
+        end = (lo == g_hist_seq) ? g_hist_used : METER_HISTORY_RECS_PER_SECTOR;
+
+        if (!MeterHistory_LoadMap(lo))
+        {
+            return total;
+        }
+
+        a = 0;
+        b = end;
+
+        while (a < b)
+        {
+            m = (uint16_t)((a + b) >> 1);
+            k = MeterHistory_NextCommitted(m, b);
+
+            if (k >= b)
+            {
+                b = m;
+                continue;
+            }
+
+            if (!MeterHistory_CachedStamp(lo, k, &first))
+            {
+                return total;
+            }
+
+            if (first >= stamp)
+            {
+                b = m;
+            }
+            else
+            {
+                a = k + 1;
+            }
+        }
+
+        a = MeterHistory_NextCommitted(a, end);
+        if (a < end)
+        {
+            return (lo - oldest) * METER_HISTORY_RECS_PER_SECTOR + a;
+        }
+    }
+
+    return total;
+}
+
+/**
+ * @brief 가장 최근 저장된 레코드 시각
+ */
+uint32_t MeterHistory_GetLastStamp(void)
+{
+    if (!g_hist_mounted || MeterHistory_GetCount() == 0)
+    {
+        return 0;
+    }
+
+    // 최신 섹터가 비어 있으면 직전 섹터의 마지막 시각 (Mount, MeterHistory_OnHeader())
+    return g_hist_head_last;
+}
+
+/**
+ * @brief 저장된 레코드 수
+ */
+uint32_t MeterHistory_GetCount(void)
+{
+    if (g_hist_sectors == 0)
+    {
+        return 0;
+    }
+
+    return (uint32_t)(g_hist_sectors - 1) * METER_HISTORY_RECS_PER_SECTOR + g_hist_used;
+}
+
+/**
+ * @brief 기록 대기 레코드 수
+ */
+uint8_t MeterHistory_GetPending(void)
+{
+    return g_hist_count;
+}
+
+/**
+ * @brief 기록 통계
+ */
+const MeterHistoryStats_t* MeterHistory_GetStats(void)
+{
+    return &g_hist_stats;
+}
+
+//******************************************************************************
+// 내부 함수 구현
+//******************************************************************************
+
+/**
+ * @brief 섹터 헤더 검사 (읽기 완료 대기)
+ * @param index 섹터 위치
+ * @return 섹터 순번, 지워졌거나 손상된 헤더는 0
+ */
+static uint32_t MeterHistory_SectorSeq(uint16_t index)
+{
+    uint32_t seq;
+
+    if (MeterNor_StartRead(METER_HISTORY_BASE_ADDR + (uint32_t)index * METER_NOR_SECTOR_SIZE,
+                           (uint8_t*)&g_hist_header, sizeof(g_hist_header), NULL) != METER_NOR_OK ||
+        MeterNor_Wait() != METER_NOR_OK)
+    {
+        g_hist_read_error = true;
+        return 0;
+    }
+
+    seq = g_hist_header.seq;
+
+    if (g_hist_header.magic != METER_HISTORY_MAGIC || g_hist_header.format != METER_HISTORY_FORMAT ||
+        g_hist_header.seq_inv != ~seq || seq == 0 ||
+        HIST_SECTOR_ADDR(seq) != METER_HISTORY_BASE_ADDR + (uint32_t)index * METER_NOR_SECTOR_SIZE)
+    {
+        return 0;
+    }
+
+    return seq;
+}
+
+/**
+ * @brief 레코드 자리가 지워진 상태인지 (16바이트 모두 0xFF, 읽기 캐시)
+ * @return false: 쓴 자리 또는 읽기 실패 (g_hist_read_error)
+ */
+static bool MeterHistory_SlotErased(uint32_t seq, uint16_t slot)
+{
+    uint32_t word[METER_RECORD_SIZE / sizeof(uint32_t)];
+    uint8_t i;
+
+    if (MeterNorCache_Read(HIST_RECORD_ADDR(seq, slot), (uint8_t*)word, sizeof(word)) != METER_NOR_OK)
+    {
+        g_hist_read_error = true;
+        return false;
+    }
+
+    for (i = 0; i < sizeof(word) / sizeof(uint32_t); i++)
+    {
+        if (word[i] != 0xFFFFFFFFUL)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief 레코드 시각 읽기 (읽기 캐시, 조회용)
+ */
+static bool MeterHistory_CachedStamp(uint32_t seq, uint16_t slot, uint32_t* stamp)
+{
+    return MeterNorCache_Read(HIST_RECORD_ADDR(seq, slot), (uint8_t*)stamp, sizeof(*stamp)) == METER_NOR_OK;
+}
+
+/**
+ * @brief 섹터의 커밋 비트맵을 g_hist_map에 읽기 (읽기 캐시, 같은 섹터면 다시 읽지 않음)
+ * @return false: NOR 읽기 실패
+ */
+static bool MeterHistory_LoadMap(uint32_t seq)
+{
+    if (g_hist_map_seq == seq)
+    {
+        return true;
+    }
+
+    g_hist_map_seq = 0;
+
+    if (MeterNorCache_Read(HIST_MAP_ADDR(seq), g_hist_map, sizeof(g_hist_map)) != METER_NOR_OK)
+    {
+        return false;
+    }
+
+    g_hist_map_seq = seq;
+    return true;
+}
+
+/**
+ * @brief slot 이상 end 미만의 첫 커밋 자리 (g_hist_map)
+ * @return 자리, 없으면 end
+ */
+static uint16_t MeterHistory_NextCommitted(uint16_t slot, uint16_t end)
+{
+    while (slot < end && !HIST_COMMITTED(slot))
+    {
+        slot++;
+    }
+
+    return slot;
+}
+
+/**
+ * @brief 섹터의 첫/마지막 커밋 레코드 시각 (커밋 비트맵, 읽기 캐시)
+ * @param end 섹터의 사용한 자리 수
+ * @return false: NOR 읽기 실패. 커밋된 레코드가 없으면 두 시각 모두 HIST_EMPTY_STAMP
+ */
+static bool MeterHistory_MapSpan(uint32_t seq, uint16_t end, uint32_t* first, uint32_t* last)
+{
+    uint16_t a;
+    uint16_t b;
+
+    *first = HIST_EMPTY_STAMP;
+    *last = HIST_EMPTY_STAMP;
+
+    if (!MeterHistory_LoadMap(seq))
+    {
+        return false;
+    }
+
+    a = MeterHistory_NextCommitted(0, end);
+    if (a >= end)
+    {
+        return true;
+    }
+
+    for (b = (uint16_t)(end - 1); !HIST_COMMITTED(b); b--)
+    {
+    }
+
+    return MeterHistory_CachedStamp(seq, a, first) && MeterHistory_CachedStamp(seq, b, last);
+}
+
+/**
+ * @brief 섹터의 첫/마지막 커밋 레코드 시각 (최신 섹터는 RAM, 그 외는 인덱스 항목)
+ * @return false: NOR 읽기 실패
+ * @details 커밋된 레코드가 없는 섹터는 직전 섹터의 마지막 시각을 첫/마지막 시각으로 삼는다
+ *          (섹터 시각 순서 유지, 링 안에 직전 섹터가 없으면 0).
+ */
+static bool MeterHistory_SectorSpan(uint32_t seq, uint32_t* first, uint32_t* last)
+{
+    uint32_t oldest = g_hist_seq - g_hist_sectors + 1;
+    bool empty = false;
+
+    if (seq == g_hist_seq)
+    {
+        *first = g_hist_head_first;
+        *last = g_hist_head_last;
+        return true;
+    }
+
+    for (; seq >= oldest; seq--)
+    {
+        if (MeterNorCache_Read(HIST_INDEX_ADDR(seq), (uint8_t*)&g_hist_index_old, sizeof(g_hist_index_old)) !=
+            METER_NOR_OK)
+        {
+            return false;
+        }
+
+        if (MeterHistory_IndexValid(&g_hist_index_old, seq))
+        {
+            *first = empty ? g_hist_index_old.last : g_hist_index_old.first;
+            *last = g_hist_index_old.last;
+            return true;
+        }
+
+        // 인덱스 항목 없음: 가득 찬 섹터이므로 첫/마지막 커밋 레코드를 직접 읽음
+        g_hist_stats.index_misses++;
+
+        if (!MeterHistory_MapSpan(seq, METER_HISTORY_RECS_PER_SECTOR, first, last))
+        {
+            return false;
+        }
+
+        if (*last != HIST_EMPTY_STAMP)
+        {
+            if (empty)
+            {
+                *first = *last;
+            }
+            return true;
+        }
+
+        empty = true;
+    }
+
+    *first = 0;
+    *last = 0;
+    return true;
+}
+
+/**
+ * @brief 인덱스 항목 작성 후 기록 예약 (MeterHistory_Task())
+ */
+static void MeterHistory_IndexBuild(uint32_t seq, uint32_t first, uint32_t last, uint16_t count)
+{
+    g_hist_index.seq = seq;
+    g_hist_index.first = first;
+    g_hist_index.last = last;
+    g_hist_index.count = count;
+    g_hist_index.crc = Meter_CRC16(&g_hist_index, (uint16_t)offsetof(MeterHistoryIndex_t, crc), 0xFFFF);
+    g_hist_index_pending = true;
+}
+
+/**
+ * @brief 인덱스 항목 유효성 (순번 일치, CRC, 커밋된 레코드가 없는 섹터는 count 0)
+ */
+static bool MeterHistory_IndexValid(const MeterHistoryIndex_t* entry, uint32_t seq)
+{
+    return entry->seq == seq && entry->count <= METER_HISTORY_RECS_PER_SECTOR &&
+           entry->crc == Meter_CRC16(entry, (uint16_t)offsetof(MeterHistoryIndex_t, crc), 0xFFFF);
+}
+
+/**
+ * @brief 인덱스 항목 쓰기 시작
+ */
+static void MeterHistory_IndexProgram(void)
+{
+    uint32_t addr = HIST_INDEX_ADDR(g_hist_index.seq);
+
+    g_hist_op = HIST_OP_INDEX;
+    MeterNorCache_Invalidate(addr, sizeof(g_hist_index));
+    if (MeterNor_StartProgram(addr, (const uint8_t*)&g_hist_index, sizeof(g_hist_index),
+                              MeterHistory_OnIndex) != METER_NOR_OK)
+    {
+        g_hist_op = HIST_OP_NONE;
+    }
+}
+
+/**
+ * @brief 인덱스 항목 자리 확인 완료 → 비어 있으면 쓰기, 이전 순환의 항목이 있으면 인덱스 섹터 지우기
+ * @details 인덱스 섹터의 첫 항목을 쓸 때 지우면 그 섹터의 항목은 모두 링에서 지워진 섹터의 것이다.
+ *          첫 항목을 건너뛴 경우(전원 차단)에는 최근 항목도 지워지며, 조회 시 섹터를 직접 읽는다.
+ */
+static void MeterHistory_OnIndexCheck(METER_NOR_ERROR_Type result)
+{
+    const uint32_t* word = (const uint32_t*)&g_hist_index_old;
+    uint32_t addr = HIST_INDEX_ADDR(g_hist_index.seq);
+    uint8_t i;
+
+    g_hist_op = HIST_OP_NONE;
+
+    if (result != METER_NOR_OK)
+    {
+        g_hist_stats.errors++;
+        return;
+    }
+
+    for (i = 0; i < sizeof(g_hist_index_old) / sizeof(uint32_t); i++)
+    {
+        if (word[i] != 0xFFFFFFFFUL)
+        {
+            addr -= addr % METER_NOR_SECTOR_SIZE;
+
+            g_hist_op = HIST_OP_INDEX_ERASE;
+            MeterNorCache_Invalidate(addr, METER_NOR_SECTOR_SIZE);
+            if (MeterNor_StartErase(addr, MeterHistory_OnIndexErase) != METER_NOR_OK)
+            {
+                g_hist_op = HIST_OP_NONE;
+            }
+            return;
+        }
+    }
+
+    MeterHistory_IndexProgram();
+}
+
+/**
+ * @brief 인덱스 섹터 지우기 완료 → 항목 쓰기
+ */
+static void MeterHistory_OnIndexErase(METER_NOR_ERROR_Type result)
+{
+    g_hist_op = HIST_OP_NONE;
+
+    if (result != METER_NOR_OK)
+    {
+        g_hist_stats.errors++;
+        return;
+    }
+
+    MeterHistory_IndexProgram();
+}
+
+/**
+ * @brief 인덱스 항목 쓰기 완료
+ */
+static void MeterHistory_OnIndex(METER_NOR_ERROR_Type result)
+{
+    g_hist_op = HIST_OP_NONE;
+
+    if (result != METER_NOR_OK)
+    {
+        g_hist_stats.errors++;
+        return;
+    }
+
+    g_hist_index_pending = false;
+    g_hist_stats.index_writes++;
+}
+
+/**
+ * @brief 다음 섹터 지우기 완료 → 헤더 쓰기
+ */
+static void MeterHistory_OnErase(METER_NOR_ERROR_Type result)
+{
+    uint32_t seq = g_hist_seq + 1;
+
+    g_hist_op = HIST_OP_NONE;
+
+    if (result != METER_NOR_OK)
+    {
+        g_hist_stats.errors++;
+        return;
+    }
+
+    memset(&g_hist_header, 0xFF, sizeof(g_hist_header));
+    g_hist_header.seq = seq;
+    g_hist_header.seq_inv = ~seq;
+    g_hist_header.magic = METER_HISTORY_MAGIC;
+    g_hist_header.format = METER_HISTORY_FORMAT;
+
+    g_hist_op = HIST_OP_HEADER;
+    MeterNorCache_Invalidate(HIST_SECTOR_ADDR(seq), sizeof(g_hist_header));
+    if (MeterNor_StartProgram(HIST_SECTOR_ADDR(seq), (const uint8_t*)&g_hist_header, sizeof(g_hist_header),
+                              MeterHistory_OnHeader) != METER_NOR_OK)
+    {
+        g_hist_op = HIST_OP_NONE;
+    }
+}
+
+/**
+ * @brief 섹터 헤더 쓰기 완료 → 새 섹터가 최신 섹터
+ */
+static void MeterHistory_OnHeader(METER_NOR_ERROR_Type result)
+{
+    g_hist_op = HIST_OP_NONE;
+
+    if (result != METER_NOR_OK)
+    {
+        g_hist_stats.errors++;
+        return;
+    }
+
+    g_hist_seq++;
+    g_hist_used = 0;
+    g_hist_head_recs = 0;
+    g_hist_sectors++;
+    g_hist_stats.sectors_opened++;
+
+    // 커밋된 레코드가 생길 때까지 직전 섹터의 마지막 시각을 이어받음
+    g_hist_head_first = g_hist_head_last;
+}
+
+/**
+ * @brief 레코드 쓰기 완료 → 커밋 비트 쓰기
+ * @details 쓰기를 시작한 자리는 결과와 관계없이 사용한 것으로 본다 (실패한 쓰기도 일부 바이트를 바꿨을 수 있음).
+ *          실패하면 커밋하지 않고 큐의 같은 레코드를 다음 자리에 다시 쓴다.
+ */
+static void MeterHistory_OnProgram(METER_NOR_ERROR_Type result)
+{
+    uint16_t slot = g_hist_used;
+    uint16_t bit;
+    uint8_t i;
+
+    g_hist_op = HIST_OP_NONE;
+    g_hist_used += g_hist_prog;
+
+    if (result != METER_NOR_OK)
+    {
+        g_hist_stats.errors++;
+        g_hist_stats.holes += g_hist_prog;
+        g_hist_prog = 0;
+
+        // 섹터가 가득 참: 다음 섹터를 열기 전에 인덱스 항목 기록
+        if (g_hist_used >= METER_HISTORY_RECS_PER_SECTOR)
+        {
+            MeterHistory_IndexBuild(g_hist_seq, g_hist_head_first, g_hist_head_last, g_hist_head_recs);
+        }
+        return;
+    }
+
+    // 비트맵 바이트 slot / 8부터, 쓴 자리의 비트만 0 (나머지는 0xFF로 그대로)
+    g_hist_commit_slot = slot;
+    memset(g_hist_commit, 0xFF, sizeof(g_hist_commit));
+    for (i = 0; i < g_hist_prog; i++)
+    {
+        bit = (uint16_t)((slot & 7) + i);
+        g_hist_commit[bit >> 3] &= (uint8_t)~(1U << (bit & 7));
+    }
+
+    g_hist_commit_pending = true;
+    MeterHistory_CommitProgram();
+}
+
+/**
+ * @brief 커밋 비트 쓰기 시작
+ */
+static void MeterHistory_CommitProgram(void)
+{
+    uint32_t addr = HIST_MAP_ADDR(g_hist_seq) + (g_hist_commit_slot >> 3);
+    uint16_t len = (uint16_t)(((g_hist_commit_slot + g_hist_prog - 1) >> 3) - (g_hist_commit_slot >> 3) + 1);
+
+    g_hist_op = HIST_OP_COMMIT;
+    MeterNorCache_Invalidate(addr, len);
+    if (MeterNor_StartProgram(addr, g_hist_commit, len, MeterHistory_OnCommit) != METER_NOR_OK)
+    {
+        g_hist_op = HIST_OP_NONE;
+    }
+}
+
+/**
+ * @brief 커밋 비트 쓰기 완료 → 큐에서 제거
+ */
+static void MeterHistory_OnCommit(METER_NOR_ERROR_Type result)
+{
+    uint8_t n = g_hist_prog;
+
+    g_hist_op = HIST_OP_NONE;
+
+    if (result != METER_NOR_OK)
+    {
+        // g_hist_commit_pending 유지: MeterHistory_Task()가 다시 씀
+        g_hist_stats.errors++;
+        return;
+    }
+
+    g_hist_commit_pending = false;
+    g_hist_prog = 0;
+    g_hist_map_seq = 0;
+
+    if (g_hist_head_recs == 0)
+    {
+        g_hist_head_first = g_hist_queue[0].timestamp;
+    }
+    g_hist_head_last = g_hist_queue[n - 1].timestamp;
+    g_hist_head_recs += n;
+
+    // 섹터가 가득 참: 다음 섹터를 열기 전에 인덱스 항목 기록
+    if (g_hist_used >= METER_HISTORY_RECS_PER_SECTOR)
+    {
+        MeterHistory_IndexBuild(g_hist_seq, g_hist_head_first, g_hist_head_last, g_hist_head_recs);
+    }
+
+    g_hist_count -= n;
+    memmove(&g_hist_queue[0], &g_hist_queue[n], (size_t)g_hist_count * sizeof(MeterRecord_t));
+    g_hist_stats.written += n;
+}
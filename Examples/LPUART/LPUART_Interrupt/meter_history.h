@@ -0,0 +1,193 @@
+/**
+ *******************************************************************************
+ * @file        meter_history.h
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       외부 NOR 장기 검침 이력 (추가 전용 섹터 링)
+ * @details     NOR 앞부분(4KB 섹터 508개)을 순환 사용하는 링.
+ *              섹터마다 순번 헤더 16바이트 + 커밋 비트맵 32바이트 + 검침 레코드(MeterRecord_t) 253개.
+ *              레코드는 RAM 큐에 모았다가 메인 루프에서 비동기로 기록한다 (페이지 쓰기 1회에 최대 16개).
+ *              레코드 쓰기가 끝나면 비트맵에서 그 자리의 비트를 0으로 써서 커밋한다.
+ *              커밋되지 않은 자리(전원 차단으로 찢어진 레코드, 쓰기 실패)는 읽기/조회에서 건너뛴다.
+ *              매시 검침 기준 약 14년분 (507섹터 x 253개 = 128,271개).
+ *              NOR 끝 4섹터는 시각 인덱스 (섹터마다 첫/마지막 시각, 레코드 수)로
+ *              시각 구간 조회를 섹터 이진 탐색 + 섹터 안 이진 탐색으로 처리한다.
+ *******************************************************************************
+ */
+
+#ifndef _METER_HISTORY_H_
+#define _METER_HISTORY_H_
+
+#include "meter_record.h"
+#include "meter_nor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//******************************************************************************
+// 이력 상수 정의
+//******************************************************************************
+
+#define METER_HISTORY_BASE_ADDR     0x000000UL
+#define METER_HISTORY_INDEX_SECTORS 4           // 시각 인덱스 섹터 수 (NOR 끝)
+#define METER_HISTORY_SECTOR_COUNT  (METER_NOR_SIZE / METER_NOR_SECTOR_SIZE - METER_HISTORY_INDEX_SECTORS)  // 508
+
+#define METER_HISTORY_MAGIC         0x484DU     // "MH"
+#define METER_HISTORY_FORMAT        3           // 섹터 형식 버전 (2: 시각 인덱스 영역, 3: 커밋 비트맵)
+#define METER_HISTORY_HEADER_SIZE   16
+#define METER_HISTORY_MAP_SIZE      32          // 커밋 비트맵 (헤더 뒤, 자리마다 1비트, 0 = 커밋됨)
+#define METER_HISTORY_RECORD_OFS    (METER_HISTORY_HEADER_SIZE + METER_HISTORY_MAP_SIZE)                    // 48
+#define METER_HISTORY_RECS_PER_SECTOR   ((METER_NOR_SECTOR_SIZE - METER_HISTORY_RECORD_OFS) / METER_RECORD_SIZE)    // 253
+
+typedef char MeterHistoryMap_SizeCheck_t[(METER_HISTORY_MAP_SIZE * 8 >= METER_HISTORY_RECS_PER_SECTOR) ? 1 : -1];
+
+// 시각 인덱스: 섹터 순번 seq의 항목 위치 = (seq - 1) % METER_HISTORY_INDEX_SLOTS
+// 인덱스 섹터를 지울 때 그 안의 항목은 모두 링에서 이미 지워진 섹터의 것이어야 하므로
+// 항목 수 >= 데이터 섹터 수 + 인덱스 섹터당 항목 수
+#define METER_HISTORY_INDEX_ADDR    (METER_HISTORY_BASE_ADDR + (uint32_t)METER_HISTORY_SECTOR_COUNT * METER_NOR_SECTOR_SIZE)
+#define METER_HISTORY_INDEX_SIZE    16
+#define METER_HISTORY_INDEX_PER_SECTOR  (METER_NOR_SECTOR_SIZE / METER_HISTORY_INDEX_SIZE)                     // 256
+#define METER_HISTORY_INDEX_SLOTS   (METER_HISTORY_INDEX_SECTORS * METER_HISTORY_INDEX_PER_SECTOR)           // 1024
+
+typedef char MeterHistoryIndex_SlotCheck_t[(METER_HISTORY_INDEX_SLOTS >= METER_HISTORY_SECTOR_COUNT + METER_HISTORY_INDEX_PER_SECTOR) ? 1 : -1];
+
+// 기록 대기 큐 (NOR 지우기 최대 30ms 동안 들어오는 레코드 보관)
+#define METER_HISTORY_QUEUE_SIZE    8
+
+//******************************************************************************
+// 이력 구조체
+//******************************************************************************
+
+// 이력 에러 코드
+typedef enum
+{
+    METER_HISTORY_OK = 0,
+    METER_HISTORY_ERR_NOT_MOUNTED,  // MeterHistory_Mount() 미호출 또는 NOR 없음
+    METER_HISTORY_ERR_QUEUE_FULL    // 기록 대기 큐 가득 참
+} METER_HISTORY_ERROR_Type;
+
+// 섹터 헤더 (16바이트, 섹터 지우기 직후 기록)
+typedef struct
+{
+    uint32_t    seq;                // 섹터 순번 (1부터, 섹터 위치 = (seq - 1) % METER_HISTORY_SECTOR_COUNT)
+    uint32_t    seq_inv;            // ~seq (헤더 유효성)
+    uint16_t    magic;              // METER_HISTORY_MAGIC
+    uint8_t     format;             // METER_HISTORY_FORMAT
+    uint8_t     reserved1;          // 0xFF
+    uint32_t    reserved2;          // 0xFFFFFFFF
+} MeterHistoryHeader_t;
+
+typedef char MeterHistoryHeader_SizeCheck_t[(sizeof(MeterHistoryHeader_t) == METER_HISTORY_HEADER_SIZE) ? 1 : -1];
+
+// 시각 인덱스 항목 (16바이트, 섹터가 가득 찬 뒤 기록)
+typedef struct
+{
+    uint32_t    seq;                // 섹터 순번
+    uint32_t    first;              // 첫 레코드 시각
+    uint32_t    last;               // 마지막 레코드 시각 (커밋된 레코드가 없으면 first = last = 직전 섹터의 마지막 시각)
+    uint16_t    count;              // 커밋된 레코드 수
+    uint16_t    crc;                // CRC-16 (crc 필드 앞까지)
+} MeterHistoryIndex_t;
+
+typedef char MeterHistoryIndex_SizeCheck_t[(sizeof(MeterHistoryIndex_t) == METER_HISTORY_INDEX_SIZE) ? 1 : -1];
+
+// 기록 통계 (Mount 이후)
+typedef struct
+{
+    uint32_t    appended;           // MeterHistory_Append() 레코드 수
+    uint32_t    written;            // NOR에 기록한 레코드 수
+    uint16_t    sectors_opened;     // 새로 연 섹터 수 (지우기 + 헤더)
+    uint16_t    dropped;            // 큐가 가득 차 버린 레코드 수
+    uint16_t    errors;             // 지우기/쓰기/커밋 실패 (재시도)
+    uint16_t    holes;              // 쓰기 실패로 건너뛴 레코드 자리
+    uint16_t    index_writes;       // 시각 인덱스 항목 기록 수
+    uint16_t    index_misses;       // 조회 중 인덱스 항목이 없어 섹터를 직접 읽은 횟수
+} MeterHistoryStats_t;
+
+//******************************************************************************
+// 이력 함수 프로토타입
+//******************************************************************************
+
+/**
+ * @brief NOR 섹터 헤더를 검사하여 최신 섹터와 기록 위치 복원
+ * @return 저장된 레코드 자리 수 (NOR 읽기 실패 시 0, 마운트되지 않음)
+ * @note MeterNor_Init() 성공 후 호출. 섹터 헤더 이진 탐색 (log2(508) + 3회)
+ *       + 최신 섹터 커밋 비트맵 + 빈 자리 이진 탐색 (8회) + 빈 자리부터 섹터 끝까지 확인
+ *       + 최신 섹터 첫/마지막 커밋 레코드 시각, 읽기마다 완료 대기
+ * @note 최신 섹터가 가득 찼는데 인덱스 항목이 없으면 (기록 전 전원 차단) 다시 기록하도록 예약
+ */
+uint32_t MeterHistory_Mount(void);
+
+/**
+ * @brief 레코드 추가 (RAM 큐에 대기, MeterHistory_Task()가 기록)
+ * @param rec 레코드
+ * @return METER_HISTORY_OK 또는 에러 코드
+ */
+METER_HISTORY_ERROR_Type MeterHistory_Append(const MeterRecord_t* rec);
+
+/**
+ * @brief 대기 레코드 기록 진행 (메인 루프에서 MeterNor_Task() 다음에 호출)
+ * @note 섹터가 차면 시각 인덱스 항목을 기록하고, 다음(가장 오래된) 섹터를 지우고
+ *       헤더를 기록한 뒤 이어서 기록. 레코드 쓰기 → 커밋 비트 쓰기가 끝나야 큐에서 제거한다.
+ *       모든 단계가 비동기이므로 호출자는 지우기/쓰기 완료를 기다리지 않는다.
+ */
+void MeterHistory_Task(void);
+
+/**
+ * @brief 저장된 레코드 읽기 시작 (비동기)
+ * @param index 가장 오래된 레코드부터의 번호 (0 ~ MeterHistory_GetCount() - 1)
+ * @param rec 수신 버퍼 (완료 통지까지 유지)
+ * @param count 요청 레코드 수
+ * @param done 완료 통지 (MeterNor_Task() 문맥)
+ * @return 읽기 시작한 레코드 수 (섹터 끝에서 잘림), 0: 범위 밖이거나 NOR 동작 중
+ * @note 자리를 그대로 읽으므로 커밋되지 않은 자리도 포함된다 (MeterHistory_Read()는 건너뜀)
+ */
+uint16_t MeterHistory_StartRead(uint32_t index, MeterRecord_t* rec, uint16_t count, MeterNorCallback_t done);
+
+/**
+ * @brief 저장된 레코드 읽기 (NOR 읽기 캐시를 거침, 완료 대기)
+ * @param index 가장 오래된 레코드부터의 자리 번호, 읽은(건너뛴) 자리만큼 증가
+ * @param rec 수신 버퍼 (커밋된 레코드만 빈틈없이 채움)
+ * @param count 요청 레코드 수 (섹터 경계를 넘어도 됨)
+ * @return 읽은 레코드 수 (범위 끝 또는 NOR 읽기 실패에서 멈춤, 실패하면 *index < MeterHistory_GetCount())
+ * @note 순차 조회 시 다음 페이지를 미리 읽으므로 이력 전체 조회에 사용 (meter_nor_cache.h)
+ */
+uint16_t MeterHistory_Read(uint32_t* index, MeterRecord_t* rec, uint16_t count);
+
+/**
+ * @brief 시각 이상인 첫 레코드 찾기 (시각 구간 조회)
+ * @param stamp 시각 (초)
+ * @return 시각 이상인 첫 커밋 레코드의 자리 번호, 없으면 MeterHistory_GetCount()
+ * @note 구간 [from, to]의 레코드 = MeterHistory_Find(from) ~ MeterHistory_Find(to + 1) - 1
+ * @note 레코드 시각이 기록 순서대로 감소하지 않는다고 가정한다 (Meter_RecordTime(), 시각이 되돌아간 구간은 결과가 정해지지 않음).
+ *       섹터 이진 탐색(인덱스 항목, 최신 섹터는 RAM) + 섹터 안 이진 탐색, 읽기 캐시를 거쳐 완료 대기
+ */
+uint32_t MeterHistory_Find(uint32_t stamp);
+
+/**
+ * @brief 가장 최근 저장된 레코드 시각 (레코드 시각 기준 복원용)
+ * @return 시각 (초), 저장된 레코드가 없거나 마운트되지 않았으면 0
+ * @note 커밋된 레코드만 본다 (Mount가 최신 섹터에서 구하고, 최신 섹터가 비어 있으면 직전 섹터의 값)
+ */
+uint32_t MeterHistory_GetLastStamp(void);
+
+/**
+ * @brief 저장된 레코드 자리 수 (커밋되지 않은 자리 포함)
+ */
+uint32_t MeterHistory_GetCount(void);
+
+/**
+ * @brief 기록 대기 레코드 수
+ */
+uint8_t MeterHistory_GetPending(void);
+
+/**
+ * @brief 기록 통계
+ */
+const MeterHistoryStats_t* MeterHistory_GetStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _METER_HISTORY_H_ */
@@ -0,0 +1,490 @@
+/**
+ *******************************************************************************
+ * @file        meter_log.c
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       내부 flash 검침 로그 (추가 전용, 웨어 레벨링)
+ * @details     페이지는 항상 0 → METER_LOG_PAGE_COUNT-1 순서로 순환 기록되므로
+ *              모든 페이지의 지우기 횟수가 같고, 페이지 순번은 위치와 정렬된다.
+ *              Mount는 순번이 끊기는 지점(최신 페이지)을 이진 탐색으로 찾는다.
+ *              레코드는 SRAM 유지 영역 큐(METER_RETAIN->queue)에 모아 페이지 단위로 기록하므로
+ *              파워다운과 웜 리셋 후에도 대기 레코드가 남는다.
+ *              페이지는 2단계로 기록한다: 1) 헤더 + 레코드, 2) CRC 봉인 커밋 표시.
+ *              기록 중 전원이 끊긴 페이지는 커밋 표시가 없으므로 Mount에서 버린다.
+ *******************************************************************************
+ */
+
+#include "meter_log.h"
+#include "meter_retain.h"
+#include "meter_flash.h"
+#include "meter_clock.h"
+#include "string.h"
+#include "stddef.h"
+
+//******************************************************************************
+// 전역 변수
+//******************************************************************************
+
+static bool g_log_mounted = false;
+static uint16_t g_log_head = METER_LOG_PAGE_COUNT - 1;  // 최신 페이지 위치
+static uint16_t g_log_count = 0;                        // 유효 페이지 수
+static uint32_t g_log_seq = 0;                          // 최신 페이지 순번 (0: 비어 있음)
+static MeterLogPage_t g_log_page;                       // 페이지 쓰기 버퍼 (MeterFlash_PageWrite 입력)
+static uint32_t g_log_pending_ms = 0;                   // 첫 대기 레코드 시각
+static MeterLogStats_t g_log_stats;
+static volatile bool g_log_busy = false;                // 큐/페이지 변경 중 (LVI 인터럽트 flush 보류)
+static volatile bool g_log_lvi_pending = false;         // 보류된 LVI flush
+
+#define LOG_PAGE_ADDR(i)    (METER_LOG_BASE_ADDR + (uint32_t)(i) * METER_LOG_PAGE_SIZE)
+#define LOG_PAGE(i)         ((const MeterLogPage_t*)LOG_PAGE_ADDR(i))
+#define LOG_PREV(i)         (((i) == 0) ? (uint16_t)(METER_LOG_PAGE_COUNT - 1) : (uint16_t)((i) - 1))
+
+// 커밋 표시: 하위 16비트 CRC, 상위 16비트 ~CRC (지워진 상태 0xFFFFFFFF, 일부만 기록된 값과 구분)
+#define LOG_COMMIT(crc)     ((uint32_t)(crc) | ((uint32_t)(uint16_t)~(crc) << 16))
+
+//******************************************************************************
+// 내부 함수 선언
+//******************************************************************************
+
+static uint32_t MeterLog_PageSeq(uint16_t index);
+static uint16_t MeterLog_PageCRC(const MeterLogPage_t* page);
+static bool MeterLog_PageCommitted(uint16_t index);
+static METER_LOG_ERROR_Type MeterLog_FlushPages(uint8_t pages);
+static METER_LOG_ERROR_Type MeterLog_ProgramPage(uint8_t count);
+
+//******************************************************************************
+// 함수 구현
+//******************************************************************************
+
+/**
+ * @brief 로그 영역을 검사하여 최신 페이지 위치 복원
+ * @return 유효 페이지 수
+ * @details 위치 i의 순번은 현재 바퀴(0~head)에서 s0 이상, 이전 바퀴(head+1~)에서는
+ *          s0 미만이거나 지워진 상태이므로 "유효 && seq >= s0"인 마지막 위치가 head.
+ *          head의 커밋 표시가 없으면(2단계 기록 중 전원 차단) 이전 페이지로 되돌아간다.
+ *          기록은 한 번에 한 페이지이므로 미완료 페이지는 끝의 1개뿐이며,
+ *          검사는 METER_LOG_RECOVER_PAGES로 제한한다 (영역 전체를 읽지 않음).
+ */
+uint16_t MeterLog_Mount(void)
+{
+    uint32_t s0;
+    uint32_t seq;
+    uint16_t lo;
+    uint16_t hi;
+    uint16_t mid;
+    uint8_t i;
+
+    s0 = MeterLog_PageSeq(0);
+
+    if (s0 == 0)
+    {
+        // 페이지 0이 비어 있음: 처음 사용하거나, 순환 직후 페이지 0 기록 중 전원 차단
+        lo = METER_LOG_PAGE_COUNT - 1;
+        seq = MeterLog_PageSeq(lo);
+    }
+    else
+    {
+        lo = 0;
+        hi = METER_LOG_PAGE_COUNT - 1;
+
+        while (lo < hi)
+        {
+            mid = (uint16_t)((lo + hi + 1) >> 1);
+            seq = MeterLog_PageSeq(mid);
+
+            if (seq != 0 && seq >= s0)
+            {
+                lo = mid;
+            }
+            else
+            {
+                hi = mid - 1;
+            }
+        }
+
+        seq = MeterLog_PageSeq(lo);
+    }
+
+    // 끝부분 복구: 순번이 이어지는 이전 페이지가 있을 때만 되돌아감 (순번은 감소하지 않음)
+    for (i = 0; seq != 0 && i < METER_LOG_RECOVER_PAGES && !MeterLog_PageCommitted(lo); i++)
+    {
+        if (MeterLog_PageSeq(LOG_PREV(lo)) != seq - 1 && seq != 1)
+        {
+            break;
+        }
+
+        lo = LOG_PREV(lo);
+        seq--;
+        g_log_stats.recovered++;
+    }
+
+    g_log_head = lo;
+    g_log_seq = seq;
+    g_log_count = (seq < METER_LOG_PAGE_COUNT) ? (uint16_t)seq : METER_LOG_PAGE_COUNT;
+    g_log_mounted = true;
+
+    // 유지 영역에서 복원된 대기 레코드는 지금부터 기한 계산
+    g_log_pending_ms = Meter_GetTickMs();
+
+    return g_log_count;
+}
+
+/**
+ * @brief 레코드 추가 (SRAM 유지 영역 큐에 대기, 가득 차면 페이지 기록)
+ * @param rec 레코드
+ * @return METER_LOG_OK 또는 에러 코드
+ */
+METER_LOG_ERROR_Type MeterLog_Write(const MeterRecord_t* rec)
+{
+    MeterRetainQueue_t* queue = &METER_RETAIN->queue;
+
+    if (!g_log_mounted)
+    {
+        return METER_LOG_ERR_NOT_MOUNTED;
+    }
+
+    // 이전 기록 실패로 큐가 가득 차 있으면 재시도, 실패 시 레코드 거부
+    if (queue->count == METER_RETAIN_QUEUE_SIZE && MeterLog_Flush() != METER_LOG_OK)
+    {
+        return METER_LOG_ERR_FLASH;
+    }
+
+    g_log_busy = true;
+
+    if (queue->count == 0)
+    {
+        g_log_pending_ms = Meter_GetTickMs();
+    }
+
+    queue->rec[queue->count++] = *rec;
+    MeterRetain_SealQueue();
+    g_log_stats.records++;
+
+    g_log_busy = false;
+
+    if (queue->count == METER_RETAIN_QUEUE_SIZE || g_log_lvi_pending)
+    {
+        return MeterLog_Flush();
+    }
+
+    return METER_LOG_OK;
+}
+
+/**
+ * @brief 대기 레코드를 페이지 단위로 기록
+ * @return METER_LOG_OK 또는 에러 코드
+ */
+METER_LOG_ERROR_Type MeterLog_Flush(void)
+{
+    METER_LOG_ERROR_Type result;
+
+    if (!g_log_mounted)
+    {
+        return METER_LOG_ERR_NOT_MOUNTED;
+    }
+
+    // CRC/검증 비교는 높은 클럭에서 (지우기/쓰기 시간은 FMC가 정함)
+    MeterClock_Boost();
+
+    g_log_busy = true;
+    result = MeterLog_FlushPages(METER_RETAIN_QUEUE_SIZE);
+    g_log_busy = false;
+
+    MeterClock_Release();
+
+    if (METER_RETAIN->queue.count == 0)
+    {
+        g_log_lvi_pending = false;
+    }
+
+    return result;
+}
+
+/**
+ * @brief LVI 저전압 경고 시 긴급 기록 (LVI 인터럽트에서 호출)
+ * @details 남은 에너지 안에서 끝나도록 최대 METER_LOG_EMERGENCY_PAGES 페이지만 기록한다.
+ *          메인 루프가 큐를 변경하는 중이면 표시만 하고, 변경이 끝나는 즉시 메인 루프가 기록한다.
+ */
+void MeterLog_EmergencyFlush(void)
+{
+    if (!g_log_mounted || METER_RETAIN->queue.count == 0)
+    {
+        return;
+    }
+
+    g_log_stats.lvi_flushes++;
+
+    if (g_log_busy)
+    {
+        g_log_lvi_pending = true;
+        return;
+    }
+
+    g_log_busy = true;
+    (void)MeterLog_FlushPages(METER_LOG_EMERGENCY_PAGES);
+    g_log_busy = false;
+}
+
+/**
+ * @brief 기한 경과 또는 보류된 LVI 긴급 기록 처리
+ * @return METER_LOG_OK 또는 에러 코드
+ */
+METER_LOG_ERROR_Type MeterLog_Task(void)
+{
+    uint16_t pending = METER_RETAIN->queue.count;
+
+    if (pending != 0 && g_log_lvi_pending)
+    {
+        return MeterLog_Flush();
+    }
+
+    if (pending != 0 && (Meter_GetTickMs() - g_log_pending_ms) >= METER_LOG_FLUSH_MS)
+    {
+        return MeterLog_Flush();
+    }
+
+    return METER_LOG_OK;
+}
+
+/**
+ * @brief 다음 MeterLog_Task() 처리까지 남은 시간 (저전력 대기 기한)
+ */
+uint32_t MeterLog_GetIdleMs(void)
+{
+    uint32_t elapsed;
+
+    if (METER_RETAIN->queue.count == 0)
+    {
+        return METER_TICK_NEVER;
+    }
+
+    elapsed = Meter_GetTickMs() - g_log_pending_ms;
+    if (g_log_lvi_pending || elapsed >= METER_LOG_FLUSH_MS)
+    {
+        return 0;
+    }
+
+    return METER_LOG_FLUSH_MS - elapsed;
+}
+
+/**
+ * @brief 아직 flash에 기록되지 않은 레코드 조회
+ * @param rec 대기 레코드 배열 (출력)
+ * @return 대기 레코드 수
+ */
+uint8_t MeterLog_GetPending(const MeterRecord_t** rec)
+{
+    *rec = METER_RETAIN->queue.rec;
+    return (uint8_t)METER_RETAIN->queue.count;
+}
+
+/**
+ * @brief 기록 통계
+ */
+const MeterLogStats_t* MeterLog_GetStats(void)
+{
+    return &g_log_stats;
+}
+
+/**
+ * @brief 저장된 페이지 조회
+ * @param age 0: 최신 페이지, 1: 그 이전, ...
+ * @return 페이지 (flash 직접 참조), 없거나 손상되었으면 NULL
+ */
+const MeterLogPage_t* MeterLog_GetPage(uint16_t age)
+{
+    uint16_t index;
+
+    if (age >= g_log_count)
+    {
+        return NULL;
+    }
+
+    index = (age <= g_log_head) ? (uint16_t)(g_log_head - age)
+                                : (uint16_t)(g_log_head + METER_LOG_PAGE_COUNT - age);
+
+    if (MeterLog_PageSeq(index) != g_log_seq - age || !MeterLog_PageCommitted(index))
+    {
+        return NULL;
+    }
+
+    return LOG_PAGE(index);
+}
+
+/**
+ * @brief 유효 페이지 수
+ */
+uint16_t MeterLog_GetPageCount(void)
+{
+    return g_log_count;
+}
+
+/**
+ * @brief 영역 전체 지우기 (로그 초기화)
+ * @return METER_LOG_OK 또는 METER_LOG_ERR_FLASH
+ */
+METER_LOG_ERROR_Type MeterLog_Format(void)
+{
+    uint16_t i;
+    METER_LOG_ERROR_Type result = METER_LOG_OK;
+
+    g_log_busy = true;
+
+    for (i = 0; i < METER_LOG_PAGE_COUNT; i++)
+    {
+        if (MeterFlash_PageErase(METER_LOG_FMC_ERASE_ID, LOG_PAGE_ADDR(i)) != FLASH_PGM_GOOD)
+        {
+            result = METER_LOG_ERR_FLASH;
+        }
+    }
+
+    g_log_head = METER_LOG_PAGE_COUNT - 1;
+    g_log_seq = 0;
+    g_log_count = 0;
+    g_log_mounted = true;
+
+    METER_RETAIN->queue.count = 0;
+    MeterRetain_SealQueue();
+
+    g_log_busy = false;
+    g_log_lvi_pending = false;
+
+    return result;
+}
+
+//******************************************************************************
+// 내부 함수 구현
+//******************************************************************************
+
+/**
+ * @brief 페이지 헤더 검사
+ * @param index 페이지 위치
+ * @return 페이지 순번, 지워졌거나 손상된 페이지는 0
+ */
+static uint32_t MeterLog_PageSeq(uint16_t index)
+{
+    const MeterLogHeader_t* hdr = &LOG_PAGE(index)->header;
+    uint32_t seq = hdr->seq;
+
+    if (hdr->magic != METER_LOG_PAGE_MAGIC || hdr->format != METER_LOG_FORMAT ||
+        hdr->seq_inv != ~seq || seq == 0 ||
+        hdr->count == 0 || hdr->count > METER_LOG_RECS_PER_PAGE)
+    {
+        return 0;
+    }
+
+    return seq;
+}
+
+/**
+ * @brief 페이지 CRC (커밋 표시 앞까지의 헤더 + 사용 중인 레코드)
+ * @param page 페이지 (헤더 count 검사 후)
+ */
+static uint16_t MeterLog_PageCRC(const MeterLogPage_t* page)
+{
+    uint16_t crc;
+
+    crc = Meter_CRC16(&page->header, (uint16_t)offsetof(MeterLogHeader_t, commit), 0xFFFF);
+    return Meter_CRC16(page->rec, (uint16_t)(page->header.count * sizeof(MeterRecord_t)), crc);
+}
+
+/**
+ * @brief 커밋 표시 검사 (헤더가 유효한 페이지)
+ * @param index 페이지 위치
+ * @return true: 2단계 기록 완료
+ */
+static bool MeterLog_PageCommitted(uint16_t index)
+{
+    const MeterLogPage_t* page = LOG_PAGE(index);
+
+    return page->header.commit == LOG_COMMIT(MeterLog_PageCRC(page));
+}
+
+/**
+ * @brief 대기 레코드를 페이지 단위로 기록
+ * @param pages 최대 기록 페이지 수
+ * @return METER_LOG_OK 또는 에러 코드
+ * @details 페이지 기록(커밋 포함) 후 큐에서 제거하므로, 그 사이 전원이 끊기면 해당 레코드는
+ *          재시작 후 한 번 더 기록될 수 있다 (유실 대신 중복).
+ * @note 호출자가 g_log_busy 설정
+ */
+static METER_LOG_ERROR_Type MeterLog_FlushPages(uint8_t pages)
+{
+    MeterRetainQueue_t* queue = &METER_RETAIN->queue;
+    METER_LOG_ERROR_Type result;
+    uint8_t count;
+
+    while (queue->count != 0 && pages-- != 0)
+    {
+        count = (queue->count < METER_LOG_RECS_PER_PAGE) ? (uint8_t)queue->count : METER_LOG_RECS_PER_PAGE;
+
+        memcpy(g_log_page.rec, queue->rec, count * sizeof(MeterRecord_t));
+        result = MeterLog_ProgramPage(count);
+        if (result != METER_LOG_OK)
+        {
+            return result;
+        }
+
+        queue->count -= count;
+        memmove(queue->rec, &queue->rec[count], queue->count * sizeof(MeterRecord_t));
+        MeterRetain_SealQueue();
+    }
+
+    return METER_LOG_OK;
+}
+
+/**
+ * @brief 페이지 버퍼의 레코드를 다음 페이지에 기록 (가장 오래된 페이지를 지우고 기록)
+ * @param count g_log_page.rec에 채운 레코드 수 (1~METER_LOG_RECS_PER_PAGE)
+ * @return METER_LOG_OK 또는 METER_LOG_ERR_FLASH
+ * @note 실패 시 head 유지, 다음 호출에서 같은 페이지 재시도
+ * @details 1단계: 헤더 + 레코드 (커밋 표시는 지워진 상태로 둠)
+ *          2단계: 커밋 표시만 기록 (나머지는 0xFF, 이미 기록된 셀은 변하지 않음)
+ */
+static METER_LOG_ERROR_Type MeterLog_ProgramPage(uint8_t count)
+{
+    uint16_t next;
+    uint32_t addr;
+    uint16_t crc;
+
+    next = (g_log_head + 1 == METER_LOG_PAGE_COUNT) ? 0 : (uint16_t)(g_log_head + 1);
+    addr = LOG_PAGE_ADDR(next);
+
+    // 빈 칸은 지워진 상태(0xFF)로 기록
+    memset(&g_log_page.rec[count], 0xFF, (METER_LOG_RECS_PER_PAGE - count) * sizeof(MeterRecord_t));
+    g_log_page.header.seq = g_log_seq + 1;
+    g_log_page.header.seq_inv = ~g_log_page.header.seq;
+    g_log_page.header.magic = METER_LOG_PAGE_MAGIC;
+    g_log_page.header.format = METER_LOG_FORMAT;
+    g_log_page.header.count = count;
+    g_log_page.header.commit = 0xFFFFFFFFUL;
+    crc = MeterLog_PageCRC(&g_log_page);
+
+    g_log_stats.programs++;
+
+    // 1단계: 헤더 + 레코드
+    if (MeterFlash_PageErase(METER_LOG_FMC_ERASE_ID, addr) != FLASH_PGM_GOOD ||
+        MeterFlash_PageWrite(METER_LOG_FMC_WRITE_ID, addr, (const uint32_t*)&g_log_page) != FLASH_PGM_GOOD ||
+        memcmp((const void*)addr, &g_log_page, sizeof(g_log_page)) != 0)
+    {
+        return METER_LOG_ERR_FLASH;
+    }
+
+    // 2단계: 커밋 표시
+    memset(&g_log_page, 0xFF, sizeof(g_log_page));
+    g_log_page.header.commit = LOG_COMMIT(crc);
+
+    if (MeterFlash_PageWrite(METER_LOG_FMC_WRITE_ID, addr, (const uint32_t*)&g_log_page) != FLASH_PGM_GOOD ||
+        !MeterLog_PageCommitted(next))
+    {
+        return METER_LOG_ERR_FLASH;
+    }
+
+    g_log_head = next;
+    g_log_seq++;
+    if (g_log_count < METER_LOG_PAGE_COUNT)
+    {
+        g_log_count++;
+    }
+
+    return METER_LOG_OK;
+}
@@ -0,0 +1,173 @@
+/**
+ *******************************************************************************
+ * @file        meter_log.h
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       내부 flash 검침 로그 (추가 전용, 웨어 레벨링)
+ * @details     예약 영역의 페이지를 순환 사용하는 링 로그.
+ *              페이지마다 순번 헤더 + 검침 레코드(MeterRecord_t) 최대 7개.
+ *              레코드는 SRAM 유지 영역 큐에 모았다가 가득 참/기한/저전압 시 페이지 단위로 기록
+ *              페이지 기록은 2단계 (헤더 + 레코드 → CRC 봉인 커밋 표시)
+ *******************************************************************************
+ */
+
+#ifndef _METER_LOG_H_
+#define _METER_LOG_H_
+
+#include "meter_record.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//******************************************************************************
+// 로그 상수 정의
+//******************************************************************************
+
+// 예약 영역 (flash 상위 8KB, 링커 IROM 범위에서 제외해야 함)
+#define METER_LOG_BASE_ADDR         0x0000E000UL
+#define METER_LOG_PAGE_SIZE         SECTOR_SIZE_BYTE    // 128바이트 (FMC 지우기/쓰기 단위)
+#define METER_LOG_PAGE_COUNT        64
+
+#define METER_LOG_PAGE_MAGIC        0x4C4DU     // "ML"
+#define METER_LOG_FORMAT            2           // 페이지 형식 버전 (2: 커밋 표시)
+#define METER_LOG_HEADER_SIZE       16
+#define METER_LOG_RECS_PER_PAGE     ((METER_LOG_PAGE_SIZE - METER_LOG_HEADER_SIZE) / METER_RECORD_SIZE)  // 7
+
+// 대기 레코드 (SRAM 유지 영역 큐, METER_RETAIN_QUEUE_SIZE) 기록 조건: 가득 참, 기한 경과, LVI 저전압 경고
+#define METER_LOG_FLUSH_MS          14400000    // 첫 대기 레코드 후 최대 대기 시간 (4시간)
+#define METER_LOG_LVI_LEVEL         LVIVS_2p65V // HAL_LVI_Init() 경고 전압 (LVR 2.28V보다 높게)
+
+// LVI 긴급 기록 페이지 수 (페이지당 지우기 + 쓰기 2회, 최대 10.5ms)
+// 2.65V → 2.28V 사이 남은 에너지로 끝낼 수 있는 양, 대기 큐 전체(14개)를 덮는다
+#define METER_LOG_EMERGENCY_PAGES   2
+
+// Mount 시 커밋 표시를 검사하는 최대 페이지 수 (끝부분 복구)
+#define METER_LOG_RECOVER_PAGES     2
+
+// FMC 사용자 ID (A31L12x_hal_fmc.c의 확인 값, MeterFlash_PageErase/PageWrite)
+#define METER_LOG_FMC_ERASE_ID      0xA901358FUL
+#define METER_LOG_FMC_WRITE_ID      0x4F17DC86UL
+
+//******************************************************************************
+// 로그 구조체
+//******************************************************************************
+
+// 로그 에러 코드
+typedef enum
+{
+    METER_LOG_OK = 0,
+    METER_LOG_ERR_NOT_MOUNTED,      // MeterLog_Mount() 미호출
+    METER_LOG_ERR_FLASH             // 지우기/쓰기/검증 실패
+} METER_LOG_ERROR_Type;
+
+// 페이지 헤더 (16바이트)
+typedef struct
+{
+    uint32_t    seq;                // 페이지 순번 (1부터, 페이지 위치 = (seq - 1) % METER_LOG_PAGE_COUNT)
+    uint32_t    seq_inv;            // ~seq (헤더 유효성)
+    uint16_t    magic;              // METER_LOG_PAGE_MAGIC
+    uint8_t     format;             // METER_LOG_FORMAT
+    uint8_t     count;              // 레코드 수 (1~METER_LOG_RECS_PER_PAGE)
+    uint32_t    commit;             // 커밋 표시 (CRC-16 | ~CRC-16 << 16, 2단계에서 기록)
+} MeterLogHeader_t;
+
+// 로그 페이지 (flash 페이지 1개와 동일한 배치)
+typedef struct
+{
+    MeterLogHeader_t    header;
+    MeterRecord_t       rec[METER_LOG_RECS_PER_PAGE];
+} MeterLogPage_t;
+
+typedef char MeterLogPage_SizeCheck_t[(sizeof(MeterLogPage_t) == METER_LOG_PAGE_SIZE) ? 1 : -1];
+
+// 기록 통계 (Mount 이후)
+typedef struct
+{
+    uint32_t    records;            // MeterLog_Write() 레코드 수
+    uint32_t    programs;           // 페이지 기록 수 (지우기 + 쓰기)
+    uint16_t    lvi_flushes;        // 저전압 경고로 기록한 횟수
+    uint16_t    recovered;          // Mount에서 버린 미완료 페이지 수
+} MeterLogStats_t;
+
+//******************************************************************************
+// 로그 함수 프로토타입
+//******************************************************************************
+
+/**
+ * @brief 로그 영역을 검사하여 최신 페이지 위치 복원
+ * @return 유효 페이지 수
+ * @note MeterRetain_Restore() 이후 호출 (대기 레코드 큐)
+ * @note 페이지 순번 이진 탐색 (페이지 헤더 log2(METER_LOG_PAGE_COUNT) + 2회 읽기)
+ *       + 커밋 표시 검사 최대 METER_LOG_RECOVER_PAGES + 1페이지
+ */
+uint16_t MeterLog_Mount(void);
+
+/**
+ * @brief 레코드 추가 (SRAM 유지 영역 큐에 대기, 가득 차면 페이지 기록)
+ * @param rec 레코드
+ * @return METER_LOG_OK 또는 에러 코드 (기록 실패 시 버퍼가 가득 차 있으면 레코드 거부)
+ */
+METER_LOG_ERROR_Type MeterLog_Write(const MeterRecord_t* rec);
+
+/**
+ * @brief 대기 레코드를 페이지 단위로 기록 (페이지마다 가장 오래된 페이지를 지우고 기록)
+ * @return METER_LOG_OK 또는 에러 코드 (대기 레코드가 없으면 METER_LOG_OK)
+ * @note 페이지당 지우기 1회 + 쓰기 2회 (RAM에서 각 최대 3.5ms 대기, 그동안 주변장치 인터럽트 보류)
+ */
+METER_LOG_ERROR_Type MeterLog_Flush(void);
+
+/**
+ * @brief LVI 저전압 경고 시 긴급 기록 (최대 METER_LOG_EMERGENCY_PAGES 페이지)
+ * @note LVI 인터럽트에서 호출. LVI는 HAL_LVI_Init(LVIEN_Enable, LVINTEN_Enable, METER_LOG_LVI_LEVEL)로 설정
+ * @note 메인 루프가 큐를 변경하는 중이면 보류하고, 변경이 끝나는 즉시 메인 루프에서 기록
+ */
+void MeterLog_EmergencyFlush(void);
+
+/**
+ * @brief 기한 경과 또는 보류된 LVI 긴급 기록 처리 (메인 루프에서 호출)
+ * @return METER_LOG_OK 또는 에러 코드
+ */
+METER_LOG_ERROR_Type MeterLog_Task(void);
+
+/**
+ * @brief 다음 MeterLog_Task() 처리까지 남은 시간 (저전력 대기 기한)
+ * @return ms, 0: 지금 처리 필요, METER_TICK_NEVER: 대기 레코드 없음
+ */
+uint32_t MeterLog_GetIdleMs(void);
+
+/**
+ * @brief 아직 flash에 기록되지 않은 레코드 조회
+ * @param rec 대기 레코드 배열 (출력)
+ * @return 대기 레코드 수
+ */
+uint8_t MeterLog_GetPending(const MeterRecord_t** rec);
+
+/**
+ * @brief 기록 통계
+ */
+const MeterLogStats_t* MeterLog_GetStats(void);
+
+/**
+ * @brief 저장된 페이지 조회
+ * @param age 0: 최신 페이지, 1: 그 이전, ...
+ * @return 페이지 (flash 직접 참조), 없거나 커밋되지 않았으면 NULL
+ */
+const MeterLogPage_t* MeterLog_GetPage(uint16_t age);
+
+/**
+ * @brief 유효 페이지 수
+ */
+uint16_t MeterLog_GetPageCount(void);
+
+/**
+ * @brief 영역 전체 지우기 (로그 초기화)
+ * @return METER_LOG_OK 또는 METER_LOG_ERR_FLASH
+ * @note 대기 레코드도 버림
+ */
+METER_LOG_ERROR_Type MeterLog_Format(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _METER_LOG_H_ */
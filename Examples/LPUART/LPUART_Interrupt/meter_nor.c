@@ -0,0 +1,518 @@
+/**
+ *******************************************************************************
+ * @file        meter_nor.c
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       외부 SPI NOR flash (P25Q16, 2MB) 드라이버
+ * @details     동작 하나를 다음 순서로 진행한다.
+ *              1) 시작 함수: deep power-down 해제, 명령/주소 바이트 폴링 송신, 데이터 DMA 시작
+ *              2) DMA 완료 인터럽트: CS# 해제 (읽기 완료, 쓰기는 WIP 확인 단계로)
+ *              3) MeterNor_Task(): 쓰기/지우기 WIP 확인, 완료 통지, 유휴 시 deep power-down
+ *              SPI는 전이중이므로 읽기 때도 TX DMA가 클럭을 만든다 (송신 데이터는 무시됨).
+ *              쓰기는 RX DMA를 쓰지 않으므로 TX DMA 완료 후 마지막 바이트 시간만큼 기다린다.
+ *******************************************************************************
+ */
+
+#include "meter_nor.h"
+#include "meter_protocol.h"
+
+//******************************************************************************
+// 전역 변수
+//******************************************************************************
+
+// 동작 단계
+#define NOR_STATE_IDLE      0
+#define NOR_STATE_DMA       1       // 데이터 DMA 전송 중 (CS# low)
+#define NOR_STATE_WIP       2       // 쓰기/지우기 진행 중 (RDSR 확인)
+#define NOR_STATE_DONE      3       // 완료 통지 대기
+
+// 동작 종류
+#define NOR_OP_READ         0
+#define NOR_OP_PROGRAM      1
+#define NOR_OP_ERASE        2
+
+// TX DMA 완료 후 시프트 레지스터에 남은 바이트(최대 2개) 전송 시간 + 여유
+#define NOR_TAIL_US         ((2 * 8 * 1000000UL) / METER_NOR_SPI_BAUD + 1)
+
+#define NOR_CS_LOW()        HAL_GPIO_ClearPin(METER_NOR_CS_PORT, (uint16_t)(1U << METER_NOR_CS_PIN))
+#define NOR_CS_HIGH()       HAL_GPIO_SetPin(METER_NOR_CS_PORT, (uint16_t)(1U << METER_NOR_CS_PIN))
+
+#define NOR_TX_DMA          ((DMACn_Type*)METER_NOR_TX_DMA_CHANNEL)
+#define NOR_RX_DMA          ((DMACn_Type*)METER_NOR_RX_DMA_CHANNEL)
+
+static bool g_nor_ready = false;                        // Init 성공
+static bool g_nor_dp = false;                           // deep power-down 상태
+static volatile uint8_t g_nor_state = NOR_STATE_IDLE;
+static uint8_t g_nor_op = NOR_OP_READ;
+static volatile METER_NOR_ERROR_Type g_nor_result = METER_NOR_OK;
+static volatile bool g_nor_dma_err = false;             // 쓰기 데이터 DMA 오류 (WIP 완료 후 오류로 통지)
+static MeterNorCallback_t g_nor_done = NULL;
+static uint32_t g_nor_wip_ms;                           // 쓰기/지우기 시작 시각
+static uint32_t g_nor_wip_limit;                        // 쓰기/지우기 최대 시간 (ms)
+static uint32_t g_nor_idle_ms;                          // 마지막 동작 완료 시각
+static MeterNorStats_t g_nor_stats;
+
+//******************************************************************************
+// 내부 함수 선언
+//******************************************************************************
+
+static METER_NOR_ERROR_Type MeterNor_Begin(MeterNorCallback_t done);
+static uint8_t MeterNor_Exchange(uint8_t data);
+static void MeterNor_Command(uint8_t cmd, uint32_t addr);
+static uint8_t MeterNor_ReadStatus(void);
+static void MeterNor_WriteEnable(void);
+static void MeterNor_Wake(void);
+static void MeterNor_Sleep(void);
+static void MeterNor_DelayUs(uint32_t us);
+
+//******************************************************************************
+// 함수 구현
+//******************************************************************************
+
+/**
+ * @brief SPI0/DMA/핀 설정, JEDEC ID 확인 후 deep power-down 진입
+ * @return METER_NOR_OK 또는 METER_NOR_ERR_ID
+ */
+METER_NOR_ERROR_Type MeterNor_Init(void)
+{
+    SPIn_CFG_Type cfg;
+    uint32_t id;
+
+    // CS# 먼저 high로 고정한 뒤 출력 설정
+    NOR_CS_HIGH();
+    HAL_GPIO_ConfigOutput(METER_NOR_CS_PORT, METER_NOR_CS_PIN, PUSH_PULL_OUTPUT);
+
+    HAL_GPIO_ConfigOutput((Pn_Type*)PB, 6, ALTERN_FUNC);     // SCK0
+    HAL_GPIO_ConfigFunction((Pn_Type*)PB, 6, AFSRx_AF3);
+    HAL_GPIO_ConfigOutput((Pn_Type*)PB, 7, ALTERN_FUNC);     // MISO0
+    HAL_GPIO_ConfigFunction((Pn_Type*)PB, 7, AFSRx_AF3);
+    HAL_GPIO_ConfigOutput((Pn_Type*)PB, 8, ALTERN_FUNC);     // MOSI0
+    HAL_GPIO_ConfigFunction((Pn_Type*)PB, 8, AFSRx_AF3);
+
+    // 모드 0 (CPOL 0, CPHA 0), MSB 먼저, CS#는 GPIO (SS0 자동 제어 끔)
+    cfg.Baudrate = METER_NOR_SPI_BAUD;
+    cfg.Order = SPIn_MSB_FIRST;
+    cfg.ACK = SPIn_TX_RISING;
+    cfg.Edge = SPIn_TX_LEADEDGE_SAMPLE;
+    HAL_SPIn_Init(METER_NOR_SPI, &cfg);
+    SPIn_DataControlConfig(METER_NOR_SPI, SPIn_CONTROL_SPInMS, ENABLE);
+    SPIn_DataControlConfig(METER_NOR_SPI, SPIn_CONTROL_SSnEN, DISABLE);
+    SPIn_Enable(METER_NOR_SPI, ENABLE);
+
+    // 데이터 DMA (완료 인터럽트 허가 + 플래그 정리)
+    HAL_DMAC_Init(NOR_TX_DMA, PERSEL_SPI0Tx, DIR_MemToPeri, SIZE_8bit, ERFGSTP_Disable);
+    HAL_DMAC_Init(NOR_RX_DMA, PERSEL_SPI0Rx, DIR_PeriToMem, SIZE_8bit, ERFGSTP_Disable);
+    NOR_TX_DMA->IESR = DMACn_IESR_TRCIENn_Msk | DMACn_IESR_TRCIFGn_Msk | DMACn_IESR_TRERIFGn_Msk;
+    NOR_RX_DMA->IESR = DMACn_IESR_TRCIENn_Msk | DMACn_IESR_TRCIFGn_Msk | DMACn_IESR_TRERIFGn_Msk;
+    NVIC_ClearPendingIRQ(METER_NOR_TX_DMA_IRQn);
+    NVIC_ClearPendingIRQ(METER_NOR_RX_DMA_IRQn);
+    NVIC_EnableIRQ(METER_NOR_TX_DMA_IRQn);
+    NVIC_EnableIRQ(METER_NOR_RX_DMA_IRQn);
+
+    // 웜 리셋이면 deep power-down 상태로 남아 있으므로 먼저 해제
+    g_nor_dp = true;
+    MeterNor_Wake();
+
+    NOR_CS_LOW();
+    MeterNor_Exchange(METER_NOR_CMD_RDID);
+    id = (uint32_t)MeterNor_Exchange(0) << 16;
+    id |= (uint32_t)MeterNor_Exchange(0) << 8;
+    id |= MeterNor_Exchange(0);
+    NOR_CS_HIGH();
+
+    MeterNor_Sleep();
+    g_nor_state = NOR_STATE_IDLE;
+    g_nor_ready = (id == METER_NOR_JEDEC_ID);
+
+    return g_nor_ready ? METER_NOR_OK : METER_NOR_ERR_ID;
+}
+
+/**
+ * @brief 빠른 읽기 시작 (DMA, 완료를 기다리지 않음)
+ */
+METER_NOR_ERROR_Type MeterNor_StartRead(uint32_t addr, uint8_t* buf, uint16_t len, MeterNorCallback_t done)
+{
+    METER_NOR_ERROR_Type err;
+
+    if (buf == NULL || len == 0 || len > METER_NOR_DMA_MAX || addr >= METER_NOR_SIZE || len > METER_NOR_SIZE - addr)
+    {
+        return METER_NOR_ERR_PARAM;
+    }
+
+    err = MeterNor_Begin(done);
+    if (err != METER_NOR_OK)
+    {
+        return err;
+    }
+
+    NOR_CS_LOW();
+    MeterNor_Command(METER_NOR_CMD_FAST_READ, addr);
+    MeterNor_Exchange(0);           // 더미 바이트
+
+    g_nor_op = NOR_OP_READ;
+    g_nor_state = NOR_STATE_DMA;
+    g_nor_stats.reads++;
+    g_nor_stats.read_bytes += len;
+
+    // RX 채널을 먼저 준비한 뒤 TX 채널이 클럭 시작 (송신 데이터는 buf의 현재 내용)
+    SPIn_ClearStatus(METER_NOR_SPI, SPIn_STATUS_SPInIFLAG);
+    HAL_DMAC_Setup(NOR_RX_DMA, (uint32_t)buf, len);
+    HAL_DMAC_Setup(NOR_TX_DMA, (uint32_t)buf, len);
+
+    return METER_NOR_OK;
+}
+
+/**
+ * @brief 페이지 쓰기 시작 (DMA, 완료를 기다리지 않음)
+ */
+METER_NOR_ERROR_Type MeterNor_StartProgram(uint32_t addr, const uint8_t* buf, uint16_t len, MeterNorCallback_t done)
+{
+    METER_NOR_ERROR_Type err;
+
+    if (buf == NULL || len == 0 || addr >= METER_NOR_SIZE ||
+        (addr % METER_NOR_PAGE_SIZE) + len > METER_NOR_PAGE_SIZE)
+    {
+        return METER_NOR_ERR_PARAM;
+    }
+
+    err = MeterNor_Begin(done);
+    if (err != METER_NOR_OK)
+    {
+        return err;
+    }
+
+    MeterNor_WriteEnable();
+
+    NOR_CS_LOW();
+    MeterNor_Command(METER_NOR_CMD_PP, addr);
+
+    g_nor_op = NOR_OP_PROGRAM;
+    g_nor_state = NOR_STATE_DMA;
+    g_nor_wip_limit = METER_NOR_TPP_MAX_MS + 1;
+    g_nor_stats.programs++;
+
+    SPIn_ClearStatus(METER_NOR_SPI, SPIn_STATUS_SPInIFLAG);
+    HAL_DMAC_Setup(NOR_TX_DMA, (uint32_t)buf, len);
+
+    return METER_NOR_OK;
+}
+
+/**
+ * @brief 섹터(4KB) 지우기 시작 (완료를 기다리지 않음)
+ */
+METER_NOR_ERROR_Type MeterNor_StartErase(uint32_t addr, MeterNorCallback_t done)
+{
+    METER_NOR_ERROR_Type err;
+
+    if (addr >= METER_NOR_SIZE)
+    {
+        return METER_NOR_ERR_PARAM;
+    }
+
+    err = MeterNor_Begin(done);
+    if (err != METER_NOR_OK)
+    {
+        return err;
+    }
+
+    MeterNor_WriteEnable();
+
+    NOR_CS_LOW();
+    MeterNor_Command(METER_NOR_CMD_SE, addr);
+    NOR_CS_HIGH();
+
+    g_nor_op = NOR_OP_ERASE;
+    g_nor_wip_limit = METER_NOR_TSE_MAX_MS + 1;
+    g_nor_wip_ms = Meter_GetTickMs();
+    g_nor_state = NOR_STATE_WIP;
+    g_nor_stats.erases++;
+
+    return METER_NOR_OK;
+}
+
+/**
+ * @brief 진행 중인 동작 완료 대기
+ */
+METER_NOR_ERROR_Type MeterNor_Wait(void)
+{
+    while (g_nor_state != NOR_STATE_IDLE)
+    {
+        MeterNor_Task();
+    }
+
+    return g_nor_result;
+}
+
+/**
+ * @brief 쓰기/지우기 완료 확인, 완료 통지, 유휴 시 deep power-down
+ */
+void MeterNor_Task(void)
+{
+    MeterNorCallback_t done;
+
+    if (g_nor_state == NOR_STATE_WIP)
+    {
+        if (!(MeterNor_ReadStatus() & METER_NOR_SR_WIP))
+        {
+            g_nor_result = g_nor_dma_err ? METER_NOR_ERR_DMA : METER_NOR_OK;
+            g_nor_state = NOR_STATE_DONE;
+        }
+        else if (Meter_GetTickMs() - g_nor_wip_ms > g_nor_wip_limit)
+        {
+            g_nor_stats.timeouts++;
+            g_nor_result = METER_NOR_ERR_TIMEOUT;
+            g_nor_state = NOR_STATE_DONE;
+        }
+    }
+
+    if (g_nor_state == NOR_STATE_DONE)
+    {
+        // 유휴로 돌린 뒤 통지 (통지 함수에서 다음 동작을 바로 시작할 수 있음)
+        done = g_nor_done;
+        g_nor_done = NULL;
+        g_nor_idle_ms = Meter_GetTickMs();
+        g_nor_state = NOR_STATE_IDLE;
+
+        if (done != NULL)
+        {
+            done(g_nor_result);
+        }
+    }
+    else if (g_nor_state == NOR_STATE_IDLE && !g_nor_dp && g_nor_ready &&
+             Meter_GetTickMs() - g_nor_idle_ms >= METER_NOR_IDLE_DP_MS)
+    {
+        MeterNor_Sleep();
+    }
+}
+
+/**
+ * @brief 즉시 deep power-down 진입
+ */
+bool MeterNor_PowerDown(void)
+{
+    if (g_nor_state != NOR_STATE_IDLE)
+    {
+        return false;
+    }
+
+    if (g_nor_ready && !g_nor_dp)
+    {
+        MeterNor_Sleep();
+    }
+
+    return true;
+}
+
+/**
+ * @brief 동작 중 여부
+ */
+bool MeterNor_IsBusy(void)
+{
+    return g_nor_state != NOR_STATE_IDLE;
+}
+
+/**
+ * @brief 통계
+ */
+const MeterNorStats_t* MeterNor_GetStats(void)
+{
+    return &g_nor_stats;
+}
+
+/**
+ * @brief DMA 전송 완료/오류 처리
+ * @details 읽기: RX 완료 = 마지막 바이트 수신 완료, CS# 해제 후 완료 통지 대기
+ *          쓰기: TX 완료 후 시프트 중인 바이트를 기다려 CS# 해제 (여기서 페이지 쓰기 시작)
+ *          전송 오류: 두 채널을 멈추고 METER_NOR_ERR_DMA로 끝낸다.
+ *          쓰기는 CS# 해제 시 받은 바이트만큼 페이지 쓰기가 시작되므로 WIP가 끝난 뒤 오류를 통지한다.
+ */
+void MeterNor_DmaHandler(void)
+{
+    uint32_t tx = NOR_TX_DMA->IESR & (DMACn_IESR_TRCIFGn_Msk | DMACn_IESR_TRERIFGn_Msk);
+    uint32_t rx = NOR_RX_DMA->IESR & (DMACn_IESR_TRCIFGn_Msk | DMACn_IESR_TRERIFGn_Msk);
+
+    if (tx != 0)
+    {
+        NOR_TX_DMA->IESR |= DMACn_IESR_TRCIFGn_Msk | DMACn_IESR_TRERIFGn_Msk;
+    }
+    if (rx != 0)
+    {
+        NOR_RX_DMA->IESR |= DMACn_IESR_TRCIFGn_Msk | DMACn_IESR_TRERIFGn_Msk;
+    }
+
+    if (g_nor_state != NOR_STATE_DMA)
+    {
+        return;
+    }
+
+    if ((tx | rx) & DMACn_IESR_TRERIFGn_Msk)
+    {
+        HAL_DMAC_Stop(NOR_TX_DMA);
+        HAL_DMAC_Stop(NOR_RX_DMA);
+        g_nor_stats.dma_errors++;
+
+        if (g_nor_op == NOR_OP_PROGRAM)
+        {
+            MeterNor_DelayUs(NOR_TAIL_US);
+            NOR_CS_HIGH();
+
+            g_nor_dma_err = true;
+            g_nor_wip_ms = Meter_GetTickMs();
+            g_nor_state = NOR_STATE_WIP;
+        }
+        else
+        {
+            NOR_CS_HIGH();
+
+            g_nor_result = METER_NOR_ERR_DMA;
+            g_nor_state = NOR_STATE_DONE;
+        }
+    }
+    else if ((tx & DMACn_IESR_TRCIFGn_Msk) && g_nor_op == NOR_OP_PROGRAM)
+    {
+        MeterNor_DelayUs(NOR_TAIL_US);
+        NOR_CS_HIGH();
+
+        g_nor_wip_ms = Meter_GetTickMs();
+        g_nor_state = NOR_STATE_WIP;
+    }
+    else if ((rx & DMACn_IESR_TRCIFGn_Msk) && g_nor_op == NOR_OP_READ)
+    {
+        NOR_CS_HIGH();
+
+        g_nor_result = METER_NOR_OK;
+        g_nor_state = NOR_STATE_DONE;
+    }
+}
+
+//******************************************************************************
+// 내부 함수 구현
+//******************************************************************************
+
+/**
+ * @brief 동작 시작 공통 확인 (초기화, 동작 중, 이전 쓰기/지우기 시간 초과 후 WIP)
+ * @param done 완료 통지
+ * @return METER_NOR_OK: 시작 가능 (깨어 있음)
+ */
+static METER_NOR_ERROR_Type MeterNor_Begin(MeterNorCallback_t done)
+{
+    if (!g_nor_ready)
+    {
+        return METER_NOR_ERR_NOT_INIT;
+    }
+
+    if (g_nor_state != NOR_STATE_IDLE)
+    {
+        return METER_NOR_ERR_BUSY;
+    }
+
+    MeterNor_Wake();
+
+    // 시간 초과로 끝낸 동작이 아직 진행 중이면 명령이 무시되므로 시작하지 않음
+    if (MeterNor_ReadStatus() & METER_NOR_SR_WIP)
+    {
+        return METER_NOR_ERR_BUSY;
+    }
+
+    g_nor_done = done;
+    g_nor_dma_err = false;
+
+    return METER_NOR_OK;
+}
+
+/**
+ * @brief 1바이트 송수신 (폴링)
+ */
+static uint8_t MeterNor_Exchange(uint8_t data)
+{
+    uint32_t timeout = SPIn_BLOCKING_TIMEOUT;
+
+    SPIn_SendByte(METER_NOR_SPI, data);
+
+    while (!(SPIn_GetStatus(METER_NOR_SPI) & SPIn_SR_SPInIFLAG_Msk) && --timeout != 0)
+    {
+    }
+
+    SPIn_ClearStatus(METER_NOR_SPI, SPIn_STATUS_SPInIFLAG);
+
+    return SPIn_ReceiveByte(METER_NOR_SPI);
+}
+
+/**
+ * @brief 명령 + 주소 3바이트 송신 (CS#는 호출자가 제어)
+ */
+static void MeterNor_Command(uint8_t cmd, uint32_t addr)
+{
+    MeterNor_Exchange(cmd);
+    MeterNor_Exchange((uint8_t)(addr >> 16));
+    MeterNor_Exchange((uint8_t)(addr >> 8));
+    MeterNor_Exchange((uint8_t)addr);
+}
+
+/**
+ * @brief 상태 레지스터 읽기
+ */
+static uint8_t MeterNor_ReadStatus(void)
+{
+    uint8_t sr;
+
+    NOR_CS_LOW();
+    MeterNor_Exchange(METER_NOR_CMD_RDSR);
+    sr = MeterNor_Exchange(0);
+    NOR_CS_HIGH();
+
+    return sr;
+}
+
+/**
+ * @brief 쓰기 허가 (페이지 쓰기/섹터 지우기 직전)
+ */
+static void MeterNor_WriteEnable(void)
+{
+    NOR_CS_LOW();
+    MeterNor_Exchange(METER_NOR_CMD_WREN);
+    NOR_CS_HIGH();
+}
+
+/**
+ * @brief deep power-down 해제 (tRES1 대기)
+ */
+static void MeterNor_Wake(void)
+{
+    if (!g_nor_dp)
+    {
+        return;
+    }
+
+    NOR_CS_LOW();
+    MeterNor_Exchange(METER_NOR_CMD_RDP);
+    NOR_CS_HIGH();
+    MeterNor_DelayUs(METER_NOR_TRES1_US);
+
+    g_nor_dp = false;
+    g_nor_stats.wakeups++;
+}
+
+/**
+ * @brief deep power-down 진입 (tDP 대기)
+ */
+static void MeterNor_Sleep(void)
+{
+    NOR_CS_LOW();
+    MeterNor_Exchange(METER_NOR_CMD_DP);
+    NOR_CS_HIGH();
+    MeterNor_DelayUs(METER_NOR_TDP_US);
+
+    g_nor_dp = true;
+}
+
+/**
+ * @brief 짧은 대기 (최소 us 마이크로초, 반복 1회 4사이클 이상)
+ */
+static void MeterNor_DelayUs(uint32_t us)
+{
+    volatile uint32_t n = us * (SystemCoreClock / 4000000UL + 1);
+
+    while (n-- != 0)
+    {
+    }
+}
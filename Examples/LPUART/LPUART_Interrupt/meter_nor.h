@@ -0,0 +1,179 @@
+/**
+ *******************************************************************************
+ * @file        meter_nor.h
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       외부 SPI NOR flash (P25Q16, 2MB) 드라이버
+ * @details     SPI0 마스터 + DMA(PERSEL_SPI0Tx/PERSEL_SPI0Rx)로 256바이트 페이지 쓰기와
+ *              빠른 읽기(0Bh) 버스트를 수행한다. 명령/주소 바이트만 폴링으로 보내고
+ *              데이터는 DMA로 전송하며, 쓰기/지우기 완료(WIP)는 메인 루프에서 확인한다.
+ *              동작 사이에는 deep power-down(0.5uA)으로 두고 다음 동작 직전에 깨운다.
+ *******************************************************************************
+ */
+
+#ifndef _METER_NOR_H_
+#define _METER_NOR_H_
+
+#include "main_conf.h"
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//******************************************************************************
+// NOR 상수 정의
+//******************************************************************************
+
+// 연결 (SPI0: PB6 SCK0, PB7 MISO0, PB8 MOSI0 = AF3, CS#: PB5 GPIO)
+// PB3/PB4(LPTXD/LPRXD)는 계량기 LPUART가 사용하므로 SCK0은 PB6을 사용
+#define METER_NOR_SPI               ((SPIn_Type*)SPI0)
+#define METER_NOR_SPI_BAUD          4000000UL   // SCK (fR 55MHz 이하, PCLK / 2 / (PREDR + 1))
+#define METER_NOR_CS_PORT           ((Pn_Type*)PB)
+#define METER_NOR_CS_PIN            5
+
+// DMA 채널 (DMAC0: 계량기 LPUART 수신, DMAC1: 디버그 출력)
+#define METER_NOR_TX_DMA_CHANNEL    DMAC2       // 메모리 → TDR (PERSEL_SPI0Tx)
+#define METER_NOR_RX_DMA_CHANNEL    DMAC3       // RDR → 메모리 (PERSEL_SPI0Rx)
+#define METER_NOR_TX_DMA_IRQn       DMAC2_IRQn  // 쓰기 데이터 전송 완료
+#define METER_NOR_RX_DMA_IRQn       DMAC3_IRQn  // 읽기 데이터 수신 완료
+#define METER_NOR_DMA_MAX           4095        // DMA TRANSCNT 12비트 (읽기 1회 최대 길이)
+
+// P25Q16 구성
+#define METER_NOR_SIZE              0x200000UL  // 2MB
+#define METER_NOR_PAGE_SIZE         256         // 페이지 쓰기 단위 (페이지 경계를 넘으면 처음으로 되돌아감)
+#define METER_NOR_SECTOR_SIZE       4096        // 섹터 지우기 단위
+#define METER_NOR_JEDEC_ID          0x856015UL  // 9Fh: 제조사 0x85, 메모리 종류 0x60, 용량 0x15 (16Mbit)
+
+// P25Q16 명령 (단일 SPI)
+#define METER_NOR_CMD_WREN          0x06        // Write Enable
+#define METER_NOR_CMD_RDSR          0x05        // Read Status Register
+#define METER_NOR_CMD_PP            0x02        // Page Program (주소 3바이트, 데이터 1~256)
+#define METER_NOR_CMD_FAST_READ     0x0B        // Fast Read (주소 3바이트 + 더미 1바이트)
+#define METER_NOR_CMD_SE            0x20        // Sector Erase 4KB
+#define METER_NOR_CMD_RDID          0x9F        // Read Identification
+#define METER_NOR_CMD_DP            0xB9        // Deep Power-down
+#define METER_NOR_CMD_RDP           0xAB        // Release from Deep Power-down
+
+#define METER_NOR_SR_WIP            0x01        // 쓰기/지우기 진행 중
+#define METER_NOR_SR_WEL            0x02        // 쓰기 허가 상태
+
+// 타이밍 (데이터시트 5.3/5.4, 최대값)
+#define METER_NOR_TDP_US            3           // deep power-down 진입 (CS# high 후)
+#define METER_NOR_TRES1_US          8           // deep power-down 해제 후 대기
+#define METER_NOR_TPP_MAX_MS        3           // 페이지 쓰기 (typ 1.5ms)
+#define METER_NOR_TSE_MAX_MS        30          // 섹터 지우기 (typ 16ms)
+
+// 마지막 동작 후 deep power-down 진입까지의 유휴 시간 (연속 읽기 사이에 깨우기를 반복하지 않음)
+#define METER_NOR_IDLE_DP_MS        5
+
+//******************************************************************************
+// NOR 구조체
+//******************************************************************************
+
+// NOR 에러 코드
+typedef enum
+{
+    METER_NOR_OK = 0,
+    METER_NOR_ERR_NOT_INIT,         // MeterNor_Init() 미호출 또는 실패
+    METER_NOR_ERR_BUSY,             // 다른 동작 진행 중
+    METER_NOR_ERR_PARAM,            // 주소/길이 오류 (영역 초과, 페이지 경계 넘김)
+    METER_NOR_ERR_ID,               // JEDEC ID 불일치 (연결 없음)
+    METER_NOR_ERR_TIMEOUT,          // 쓰기/지우기가 최대 시간 내에 끝나지 않음
+    METER_NOR_ERR_DMA               // DMA 전송 오류 (읽은 데이터/쓴 페이지 무효)
+} METER_NOR_ERROR_Type;
+
+// 완료 통지 (MeterNor_Task() 문맥, 메인 루프)
+typedef void (*MeterNorCallback_t)(METER_NOR_ERROR_Type result);
+
+// 통계 (Init 이후)
+typedef struct
+{
+    uint32_t    reads;              // 읽기 횟수
+    uint32_t    read_bytes;         // 읽은 바이트 수
+    uint32_t    programs;           // 페이지 쓰기 횟수
+    uint32_t    erases;             // 섹터 지우기 횟수
+    uint32_t    wakeups;            // deep power-down 해제 횟수
+    uint16_t    timeouts;           // 쓰기/지우기 시간 초과
+    uint16_t    dma_errors;         // DMA 전송 오류
+} MeterNorStats_t;
+
+//******************************************************************************
+// NOR 함수 프로토타입
+//******************************************************************************
+
+/**
+ * @brief SPI0/DMA/핀 설정, JEDEC ID 확인 후 deep power-down 진입
+ * @return METER_NOR_OK 또는 METER_NOR_ERR_ID
+ * @note 실패하면 이후 모든 동작이 METER_NOR_ERR_NOT_INIT을 반환한다
+ */
+METER_NOR_ERROR_Type MeterNor_Init(void);
+
+/**
+ * @brief 빠른 읽기 시작 (DMA, 완료를 기다리지 않음)
+ * @param addr NOR 주소
+ * @param buf 수신 버퍼 (완료 통지까지 유지)
+ * @param len 길이 (1~METER_NOR_DMA_MAX)
+ * @param done 완료 통지 (NULL: 없음)
+ * @return METER_NOR_OK: 시작됨, 그 외: 시작하지 않음
+ * @note buf 내용은 전송 중 더미 송신 데이터로도 사용된다 (DMA 메모리 주소는 항상 증가)
+ */
+METER_NOR_ERROR_Type MeterNor_StartRead(uint32_t addr, uint8_t* buf, uint16_t len, MeterNorCallback_t done);
+
+/**
+ * @brief 페이지 쓰기 시작 (DMA, 완료를 기다리지 않음)
+ * @param addr NOR 주소
+ * @param buf 쓰기 데이터 (완료 통지까지 유지)
+ * @param len 길이 (1~METER_NOR_PAGE_SIZE, 페이지 경계를 넘을 수 없음)
+ * @param done 완료 통지 (NULL: 없음)
+ * @return METER_NOR_OK: 시작됨, 그 외: 시작하지 않음
+ * @note 지워진(0xFF) 바이트에만 쓸 수 있다 (1 → 0)
+ */
+METER_NOR_ERROR_Type MeterNor_StartProgram(uint32_t addr, const uint8_t* buf, uint16_t len, MeterNorCallback_t done);
+
+/**
+ * @brief 섹터(4KB) 지우기 시작 (완료를 기다리지 않음)
+ * @param addr 섹터 안의 주소
+ * @param done 완료 통지 (NULL: 없음)
+ * @return METER_NOR_OK: 시작됨, 그 외: 시작하지 않음
+ */
+METER_NOR_ERROR_Type MeterNor_StartErase(uint32_t addr, MeterNorCallback_t done);
+
+/**
+ * @brief 진행 중인 동작 완료 대기 (MeterNor_Task() 반복)
+ * @return 마지막 동작 결과
+ * @note 완료 통지 함수 안에서 호출하지 않는다
+ */
+METER_NOR_ERROR_Type MeterNor_Wait(void);
+
+/**
+ * @brief 쓰기/지우기 완료 확인, 완료 통지, 유휴 시 deep power-down (메인 루프에서 호출)
+ */
+void MeterNor_Task(void);
+
+/**
+ * @brief 즉시 deep power-down 진입 (MCU 파워다운 전)
+ * @return true: 진입함, false: 동작 중
+ */
+bool MeterNor_PowerDown(void);
+
+/**
+ * @brief 동작 중 여부 (완료 통지 전까지 동작 중)
+ */
+bool MeterNor_IsBusy(void);
+
+/**
+ * @brief 통계
+ */
+const MeterNorStats_t* MeterNor_GetStats(void);
+
+/**
+ * @brief DMA 전송 완료 처리
+ * @note DMAC2_Handler(), DMAC3_Handler()에서 호출
+ */
+void MeterNor_DmaHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _METER_NOR_H_ */
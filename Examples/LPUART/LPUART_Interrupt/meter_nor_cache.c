@@ -0,0 +1,393 @@
+/**
+ *******************************************************************************
+ * @file        meter_nor_cache.c
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       외부 NOR 페이지 읽기 캐시 (LRU + 순차 미리 읽기)
+ * @details     캐시 페이지는 비어 있음 → 읽는 중(DMA) → 유효 순서로 바뀐다.
+ *              NOR 동작은 한 번에 하나이므로 읽는 중인 페이지도 최대 1개이며,
+ *              미리 읽기 완료 통지에서 다음 미리 읽기를 이어서 시작한다.
+ *              교체 대상은 가장 오래 사용하지 않은 페이지 중
+ *              현재 페이지 ~ 미리 읽기 범위 밖의 페이지이다.
+ *******************************************************************************
+ */
+
+#include "meter_nor_cache.h"
+#include "string.h"
+
+//******************************************************************************
+// 전역 변수
+//******************************************************************************
+
+// 캐시 페이지 상태
+#define CACHE_SLOT_EMPTY    0
+#define CACHE_SLOT_LOADING  1       // NOR 읽기 DMA 진행 중
+#define CACHE_SLOT_VALID    2
+
+#define CACHE_NONE          0xFF    // 캐시 페이지 번호 없음
+#define CACHE_NO_PAGE       0xFFFF  // NOR 페이지 번호 없음
+
+typedef struct
+{
+    uint8_t     data[METER_NOR_PAGE_SIZE];  // 페이지 내용 (읽기 DMA 수신 버퍼)
+    uint32_t    used;                       // 마지막 사용 시점 (LRU)
+    uint16_t    page;                       // NOR 페이지 번호
+    uint8_t     state;                      // CACHE_SLOT_*
+    uint8_t     ahead;                      // 미리 읽은 뒤 아직 사용하지 않음
+} CacheSlot_t;
+
+static CacheSlot_t g_cache_slot[METER_NOR_CACHE_PAGES];
+static uint32_t g_cache_clock = 0;                  // 접근마다 증가 (LRU 기준)
+static uint8_t g_cache_loading = CACHE_NONE;        // 읽는 중인 캐시 페이지
+static bool g_cache_stale = false;                  // 읽는 중에 무효화됨
+static uint16_t g_cache_last = CACHE_NO_PAGE;       // 마지막 접근 NOR 페이지
+static bool g_cache_seq = false;                    // 마지막 접근이 순차 접근
+static METER_NOR_ERROR_Type g_cache_result = METER_NOR_OK;  // 마지막 읽기 실패 원인
+static MeterNorCacheStats_t g_cache_stats;
+
+//******************************************************************************
+// 내부 함수 선언
+//******************************************************************************
+
+static uint8_t MeterNorCache_Fetch(uint16_t page);
+static uint8_t MeterNorCache_Find(uint16_t page);
+static uint8_t MeterNorCache_Victim(void);
+static bool MeterNorCache_Load(uint8_t slot, uint16_t page, bool ahead);
+static void MeterNorCache_Readahead(void);
+static void MeterNorCache_OnLoad(METER_NOR_ERROR_Type result);
+
+//******************************************************************************
+// 함수 구현
+//******************************************************************************
+
+/**
+ * @brief 캐시를 거쳐 NOR 읽기 (완료 대기)
+ * @details 페이지마다 캐시에서 찾고(없으면 읽어 오고) 복사한 뒤 미리 읽기를 시작한다.
+ *          호출자가 복사한 레코드를 처리하는 동안 다음 페이지가 DMA로 들어온다.
+ */
+METER_NOR_ERROR_Type MeterNorCache_Read(uint32_t addr, uint8_t* buf, uint16_t len)
+{
+    uint16_t off;
+    uint16_t n;
+    uint8_t slot;
+
+    if (buf == NULL || addr >= METER_NOR_SIZE || len > METER_NOR_SIZE - addr)
+    {
+        return METER_NOR_ERR_PARAM;
+    }
+
+    while (len > 0)
+    {
+        off = (uint16_t)(addr % METER_NOR_PAGE_SIZE);
+        n = (uint16_t)(METER_NOR_PAGE_SIZE - off);
+        if (n > len)
+        {
+            n = len;
+        }
+
+        slot = MeterNorCache_Fetch((uint16_t)(addr / METER_NOR_PAGE_SIZE));
+        if (slot == CACHE_NONE)
+        {
+            return g_cache_result;
+        }
+
+        memcpy(buf, &g_cache_slot[slot].data[off], n);
+        buf += n;
+        addr += n;
+        len -= n;
+
+        MeterNorCache_Readahead();
+    }
+
+    return METER_NOR_OK;
+}
+
+/**
+ * @brief NOR 내용 변경 전 캐시 무효화
+ */
+void MeterNorCache_Invalidate(uint32_t addr, uint32_t len)
+{
+    uint32_t first;
+    uint32_t last;
+    uint8_t i;
+
+    if (len == 0)
+    {
+        return;
+    }
+
+    first = addr / METER_NOR_PAGE_SIZE;
+    last = (addr + len - 1) / METER_NOR_PAGE_SIZE;
+
+    for (i = 0; i < METER_NOR_CACHE_PAGES; i++)
+    {
+        if (g_cache_slot[i].state == CACHE_SLOT_EMPTY ||
+            g_cache_slot[i].page < first || g_cache_slot[i].page > last)
+        {
+            continue;
+        }
+
+        if (g_cache_slot[i].state == CACHE_SLOT_LOADING)
+        {
+            // 완료 통지에서 버림
+            g_cache_stale = true;
+        }
+        else
+        {
+            g_cache_slot[i].state = CACHE_SLOT_EMPTY;
+        }
+    }
+}
+
+/**
+ * @brief 캐시 통계
+ */
+const MeterNorCacheStats_t* MeterNorCache_GetStats(void)
+{
+    return &g_cache_stats;
+}
+
+/**
+ * @brief 캐시 통계 초기화
+ */
+void MeterNorCache_ResetStats(void)
+{
+    memset(&g_cache_stats, 0, sizeof(g_cache_stats));
+}
+
+//******************************************************************************
+// 내부 함수 구현
+//******************************************************************************
+
+/**
+ * @brief NOR 페이지를 캐시에 확보 (완료 대기)
+ * @param page NOR 페이지 번호
+ * @return 캐시 페이지 번호, 읽기 실패 시 CACHE_NONE (g_cache_result)
+ */
+static uint8_t MeterNorCache_Fetch(uint16_t page)
+{
+    uint8_t slot;
+
+    // 같은 페이지 또는 다음 페이지 접근이면 순차 접근 (미리 읽기 대상)
+    g_cache_seq = (g_cache_last != CACHE_NO_PAGE) &&
+                  (page == g_cache_last || page == (uint16_t)((g_cache_last + 1) % METER_NOR_PAGE_COUNT));
+    g_cache_last = page;
+
+    // 쓰기/미리 읽기 완료 통지를 먼저 처리
+    MeterNor_Task();
+
+    slot = MeterNorCache_Find(page);
+
+    if (slot != CACHE_NONE && g_cache_slot[slot].state == CACHE_SLOT_LOADING)
+    {
+        // 미리 읽기가 아직 진행 중: 처음부터 다시 읽는 것보다 짧음
+        g_cache_stats.waits++;
+        while (g_cache_slot[slot].state == CACHE_SLOT_LOADING)
+        {
+            MeterNor_Task();
+        }
+
+        slot = MeterNorCache_Find(page);
+    }
+
+    if (slot != CACHE_NONE)
+    {
+        g_cache_stats.hits++;
+        if (g_cache_slot[slot].ahead)
+        {
+            g_cache_slot[slot].ahead = false;
+            g_cache_stats.readahead_used++;
+        }
+        g_cache_slot[slot].used = ++g_cache_clock;
+
+        return slot;
+    }
+
+    g_cache_stats.misses++;
+
+    // 진행 중인 이력 쓰기/미리 읽기가 끝나야 읽기를 시작할 수 있음
+    while (MeterNor_IsBusy())
+    {
+        MeterNor_Task();
+    }
+
+    slot = MeterNorCache_Victim();
+    if (slot == CACHE_NONE || !MeterNorCache_Load(slot, page, false))
+    {
+        return CACHE_NONE;
+    }
+
+    while (g_cache_slot[slot].state == CACHE_SLOT_LOADING)
+    {
+        MeterNor_Task();
+    }
+
+    if (g_cache_slot[slot].state != CACHE_SLOT_VALID)
+    {
+        return CACHE_NONE;
+    }
+
+    g_cache_slot[slot].used = ++g_cache_clock;
+
+    return slot;
+}
+
+/**
+ * @brief 캐시에서 NOR 페이지 찾기 (읽는 중 포함)
+ * @return 캐시 페이지 번호 또는 CACHE_NONE
+ */
+static uint8_t MeterNorCache_Find(uint16_t page)
+{
+    uint8_t i;
+
+    for (i = 0; i < METER_NOR_CACHE_PAGES; i++)
+    {
+        if (g_cache_slot[i].state != CACHE_SLOT_EMPTY && g_cache_slot[i].page == page)
+        {
+            return i;
+        }
+    }
+
+    return CACHE_NONE;
+}
+
+/**
+ * @brief 교체할 캐시 페이지 선택
+ * @return 빈 페이지, 없으면 범위(현재 페이지 ~ 미리 읽기) 밖에서 가장 오래 사용하지 않은 페이지
+ */
+static uint8_t MeterNorCache_Victim(void)
+{
+    uint8_t victim = CACHE_NONE;
+    uint16_t ahead;
+    uint8_t i;
+
+    for (i = 0; i < METER_NOR_CACHE_PAGES; i++)
+    {
+        if (g_cache_slot[i].state == CACHE_SLOT_EMPTY)
+        {
+            return i;
+        }
+
+        if (g_cache_slot[i].state == CACHE_SLOT_LOADING)
+        {
+            continue;
+        }
+
+        ahead = (uint16_t)((g_cache_slot[i].page + METER_NOR_PAGE_COUNT - g_cache_last) % METER_NOR_PAGE_COUNT);
+        if (ahead <= METER_NOR_CACHE_READAHEAD)
+        {
+            continue;
+        }
+
+        if (victim == CACHE_NONE || (int32_t)(g_cache_slot[i].used - g_cache_slot[victim].used) < 0)
+        {
+            victim = i;
+        }
+    }
+
+    if (victim != CACHE_NONE)
+    {
+        g_cache_stats.evictions++;
+    }
+
+    return victim;
+}
+
+/**
+ * @brief NOR 페이지 읽기 시작 (DMA)
+ * @param slot 캐시 페이지
+ * @param page NOR 페이지 번호
+ * @param ahead 미리 읽기 여부
+ * @return true: 시작됨
+ */
+static bool MeterNorCache_Load(uint8_t slot, uint16_t page, bool ahead)
+{
+    METER_NOR_ERROR_Type err;
+
+    g_cache_slot[slot].state = CACHE_SLOT_EMPTY;
+
+    err = MeterNor_StartRead((uint32_t)page * METER_NOR_PAGE_SIZE, g_cache_slot[slot].data, METER_NOR_PAGE_SIZE,
+                             MeterNorCache_OnLoad);
+    if (err != METER_NOR_OK)
+    {
+        g_cache_result = err;
+        g_cache_stats.errors++;
+        return false;
+    }
+
+    g_cache_slot[slot].page = page;
+    g_cache_slot[slot].ahead = ahead;
+    g_cache_slot[slot].used = g_cache_clock;
+    g_cache_slot[slot].state = CACHE_SLOT_LOADING;
+    g_cache_loading = slot;
+    g_cache_stale = false;
+
+    return true;
+}
+
+/**
+ * @brief 순차 접근이면 다음 페이지 중 캐시에 없는 첫 페이지 읽기 시작
+ * @note NOR가 동작 중이면 시작하지 않음 (다음 접근 또는 읽기 완료 통지에서 다시 시도)
+ */
+static void MeterNorCache_Readahead(void)
+{
+    uint16_t page;
+    uint8_t slot;
+    uint8_t k;
+
+    if (!g_cache_seq || g_cache_loading != CACHE_NONE || MeterNor_IsBusy())
+    {
+        return;
+    }
+
+    for (k = 1; k <= METER_NOR_CACHE_READAHEAD; k++)
+    {
+        page = (uint16_t)((g_cache_last + k) % METER_NOR_PAGE_COUNT);
+
+        if (MeterNorCache_Find(page) != CACHE_NONE)
+        {
+            continue;
+        }
+
+        slot = MeterNorCache_Victim();
+        if (slot != CACHE_NONE && MeterNorCache_Load(slot, page, true))
+        {
+            g_cache_stats.readaheads++;
+        }
+        return;
+    }
+}
+
+/**
+ * @brief 페이지 읽기 완료 (MeterNor_Task() 문맥) → 다음 미리 읽기
+ */
+static void MeterNorCache_OnLoad(METER_NOR_ERROR_Type result)
+{
+    uint8_t slot = g_cache_loading;
+
+    g_cache_loading = CACHE_NONE;
+
+    if (slot == CACHE_NONE)
+    {
+        return;
+    }
+
+    if (result != METER_NOR_OK)
+    {
+        g_cache_result = result;
+        g_cache_stats.errors++;
+        g_cache_slot[slot].state = CACHE_SLOT_EMPTY;
+        return;
+    }
+
+    if (g_cache_stale)
+    {
+        g_cache_stale = false;
+        g_cache_result = METER_NOR_ERR_BUSY;
+        g_cache_slot[slot].state = CACHE_SLOT_EMPTY;
+        return;
+    }
+
+    g_cache_slot[slot].state = CACHE_SLOT_VALID;
+
+    MeterNorCache_Readahead();
+}
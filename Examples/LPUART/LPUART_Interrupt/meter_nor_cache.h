@@ -0,0 +1,86 @@
+/**
+ *******************************************************************************
+ * @file        meter_nor_cache.h
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       외부 NOR 페이지 읽기 캐시 (LRU + 순차 미리 읽기)
+ * @details     NOR 256바이트 페이지 몇 개를 SRAM에 보관한다.
+ *              순차 접근이 감지되면 호출자가 현재 페이지를 처리하는 동안
+ *              다음 페이지를 DMA로 미리 읽어, 이력 전체 조회가 레코드마다
+ *              명령/주소/깨우기 지연을 치르지 않고 SPI 대역폭으로 진행된다.
+ *******************************************************************************
+ */
+
+#ifndef _METER_NOR_CACHE_H_
+#define _METER_NOR_CACHE_H_
+
+#include "meter_nor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//******************************************************************************
+// 캐시 상수 정의
+//******************************************************************************
+
+#define METER_NOR_CACHE_PAGES       4           // 캐시 페이지 수 (SRAM 1KB)
+#define METER_NOR_CACHE_READAHEAD   2           // 순차 접근 시 미리 읽는 페이지 수 (METER_NOR_CACHE_PAGES - 2 이하)
+
+#define METER_NOR_PAGE_COUNT        (METER_NOR_SIZE / METER_NOR_PAGE_SIZE)      // 8192
+
+typedef char MeterNorCache_ReadaheadCheck_t[(METER_NOR_CACHE_READAHEAD <= METER_NOR_CACHE_PAGES - 2) ? 1 : -1];
+
+//******************************************************************************
+// 캐시 구조체
+//******************************************************************************
+
+// 캐시 통계 (MeterNorCache_ResetStats() 이후)
+typedef struct
+{
+    uint32_t    hits;               // 캐시에 있던 페이지 접근 (미리 읽기 완료 포함)
+    uint32_t    misses;             // NOR에서 읽어 온 페이지 접근
+    uint32_t    readaheads;         // 미리 읽기 시작 횟수
+    uint32_t    readahead_used;     // 미리 읽은 페이지가 실제로 사용된 횟수
+    uint32_t    waits;              // 미리 읽기 중인 페이지 완료를 기다린 횟수
+    uint16_t    evictions;          // 유효 페이지 교체 횟수
+    uint16_t    errors;             // NOR 읽기 실패
+} MeterNorCacheStats_t;
+
+//******************************************************************************
+// 캐시 함수 프로토타입
+//******************************************************************************
+
+/**
+ * @brief 캐시를 거쳐 NOR 읽기 (완료 대기)
+ * @param addr NOR 주소
+ * @param buf 수신 버퍼
+ * @param len 길이 (페이지 경계를 넘어도 됨)
+ * @return METER_NOR_OK 또는 에러 코드
+ * @note 캐시에 없으면 페이지 전체를 읽는다. 순차 접근이면 다음 페이지 읽기를 시작한 뒤 반환한다.
+ *       MeterNor_Task()를 반복하며 기다리므로 완료 통지 함수 안에서 호출하지 않는다.
+ */
+METER_NOR_ERROR_Type MeterNorCache_Read(uint32_t addr, uint8_t* buf, uint16_t len);
+
+/**
+ * @brief NOR 내용 변경 전 캐시 무효화
+ * @param addr 시작 주소
+ * @param len 길이
+ * @note NOR에 쓰거나 지우는 쪽(MeterHistory_Task())이 동작 시작 전에 호출
+ */
+void MeterNorCache_Invalidate(uint32_t addr, uint32_t len);
+
+/**
+ * @brief 캐시 통계
+ */
+const MeterNorCacheStats_t* MeterNorCache_GetStats(void);
+
+/**
+ * @brief 캐시 통계 초기화
+ */
+void MeterNorCache_ResetStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _METER_NOR_CACHE_H_ */
@@ -0,0 +1,261 @@
+/**
+ *******************************************************************************
+ * @file        meter_power.c
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       tickless 저전력 스케줄러
+ * @details     파워다운은 인터럽트를 금지한 상태에서 유휴 조건을 다시 확인하고 WFI로 들어간다.
+ *              WFI는 PRIMASK와 관계없이 보류 인터럽트로 깨어나므로, 확인과 진입 사이에
+ *              들어온 수신/LVI 인터럽트를 놓치지 않는다. 핸들러는 시간 보정 후 실행된다.
+ *******************************************************************************
+ */
+
+#include "meter_power.h"
+#include "meter_protocol.h"
+#include "meter_log.h"
+#include "meter_retain.h"
+#include "meter_nor.h"
+#include "meter_history.h"
+#include "meter_event.h"
+#include "meter_clock.h"
+#include <string.h>
+
+//******************************************************************************
+// 내부 변수
+//******************************************************************************
+
+static uint32_t g_power_hold_ms = 0;            // 이 시각까지 파워다운 금지
+static bool g_power_xsosc = false;              // true: TIMER50 ← XSOSC (1024Hz), false: WDTRC (1ms)
+static uint32_t g_power_frac = 0;               // XSOSC 카운트를 ms로 환산하고 남은 나머지 (1/1024ms 단위)
+static MeterPowerStats_t g_power_stats;
+
+//******************************************************************************
+// 내부 함수 선언
+//******************************************************************************
+
+static bool MeterPower_NeedsTick(void);
+static uint32_t MeterPower_Down(uint32_t ms);
+
+//******************************************************************************
+// 함수 구현
+//******************************************************************************
+
+/**
+ * @brief 깨움 타이머 초기화
+ */
+void MeterPower_Init(bool xsosc)
+{
+    TIMER5n_CFG_Type cfg;
+
+    memset(&cfg, 0, sizeof(cfg));
+    memset(&g_power_stats, 0, sizeof(g_power_stats));
+
+    g_power_xsosc = xsosc;
+    g_power_frac = 0;
+
+    // XSOSC/WDTRC는 파워다운에서도 동작 (SystemClock_Config에서 켜 둠, XSOSC는 발진 확인 후에만 사용)
+    if (xsosc)
+    {
+        HAL_SCU_Peripheral_ClockSelection(PPCLKSR_T50CLK, T50CLK_XSOSC);
+        cfg.Prescaler = METER_POWER_XSOSC_PRESCALE;
+    }
+    else
+    {
+        HAL_SCU_Peripheral_ClockSelection(PPCLKSR_T50CLK, T50CLK_WDTRC);
+        cfg.Prescaler = METER_POWER_WDTRC_PRESCALE;
+    }
+
+    cfg.T5nMS = TIMER5n_CR_T5nMS_IntervalMode;
+    cfg.T5nCLK = TIMER5n_CR_T5nCLK_IntPrescaledClock;
+    cfg.ADR = 0xFFFF;
+    HAL_TIMER5n_Init(METER_POWER_TIMER, &cfg);
+    HAL_TIMER5n_ConfigInterrupt(METER_POWER_TIMER, TIMER5n_CR_MATCH_INTR, ENABLE);
+
+    NVIC_EnableIRQ(METER_POWER_TIMER_IRQn);
+
+    // 시작 직후에는 디버그 키 입력을 받을 수 있게 깨어 있음
+    MeterPower_Hold(METER_POWER_CONSOLE_MS);
+}
+
+/**
+ * @brief 지정 시간 동안 파워다운 금지
+ */
+void MeterPower_Hold(uint32_t ms)
+{
+    uint32_t until = Meter_GetTickMs() + ms;
+
+    if ((int32_t)(until - g_power_hold_ms) > 0)
+    {
+        g_power_hold_ms = until;
+    }
+}
+
+/**
+ * @brief 다음 기한까지 저전력 대기
+ */
+METER_POWER_MODE_Type MeterPower_Idle(uint32_t wait_ms)
+{
+    uint32_t wait = wait_ms;
+    uint32_t log_ms = MeterLog_GetIdleMs();
+    uint32_t proto_ms = Meter_GetIdleMs();
+
+    // 통신/NOR 동작 중이라 미룬 낮은 단계 복귀 (sleep 전류도 HCLK에 비례)
+    MeterClock_Update();
+
+    if (log_ms < wait)
+    {
+        wait = log_ms;
+    }
+
+    // 응답 대기 중 수신 깨움 포트: 응답 기한에 깨어나 타임아웃 처리 (0이면 아래에서 sleep 모드)
+    if (proto_ms != 0 && proto_ms < wait)
+    {
+        wait = proto_ms;
+    }
+
+    if (wait == 0)
+    {
+        return METER_POWER_RUN;
+    }
+
+    if (wait > METER_POWER_MAX_MS)
+    {
+        wait = METER_POWER_MAX_MS;
+    }
+
+    if (wait >= METER_POWER_MIN_MS && !MeterPower_NeedsTick())
+    {
+        // 파워다운 중에는 UART1/DMA가 멈추므로 디버그 출력을 먼저 내보냄
+#ifdef _DEBUG_MSG_BUFFERED
+        debug_frmwrk_flush();
+#endif
+        while (!(HAL_UART_GetLineStatus((UARTn_Type*)UART1) & UARTn_LSR_TEMT))
+        {
+        }
+
+        // NOR deep power-down (유휴 지연 METER_NOR_IDLE_DP_MS를 기다리지 않음)
+        if (MeterNor_PowerDown())
+        {
+            __disable_irq();
+
+            // 확인 후 들어온 인터럽트가 일을 만들었으면 자지 않음
+            if (MeterPower_NeedsTick())
+            {
+                __enable_irq();
+                return METER_POWER_RUN;
+            }
+
+            if (MeterPower_Down(wait) < wait)
+            {
+                g_power_stats.early_wakes++;
+            }
+
+            __enable_irq();
+            return METER_POWER_DOWN;
+        }
+    }
+
+    // SysTick(1ms)이나 주변장치 인터럽트까지 sleep
+    __disable_irq();
+
+    // 큐가 빈 것을 확인한 뒤 인터럽트가 이벤트를 게시했으면 자지 않음
+    if (MeterEvent_IsPending())
+    {
+        __enable_irq();
+        return METER_POWER_RUN;
+    }
+
+    g_power_stats.sleeps++;
+    HAL_PWR_EnterSleepMode();
+    __enable_irq();
+
+    return METER_POWER_SLEEP;
+}
+
+/**
+ * @brief 통계 조회
+ */
+const MeterPowerStats_t* MeterPower_GetStats(void)
+{
+    return &g_power_stats;
+}
+
+/**
+ * @brief TIMER50 인터럽트 핸들러에서 호출
+ * @note 깨움은 MeterPower_Down()에서 처리하므로 플래그만 지운다 (늦게 도착한 일치 등)
+ */
+void MeterPower_TimerHandler(void)
+{
+    HAL_TIMER5n_ClearStatus(METER_POWER_TIMER, TIMER5n_CR_MATCH_FLAG);
+}
+
+//******************************************************************************
+// 내부 함수 구현
+//******************************************************************************
+
+/**
+ * @brief SysTick 밀리초 타이밍이 필요한 동작 여부
+ * @return true: 프로토콜 진행 중 (수신 깨움 포트의 응답 대기 제외), NOR 동작/이력 기록 대기, 디버그 키 입력 유지 중, 이벤트 대기
+ */
+static bool MeterPower_NeedsTick(void)
+{
+    return MeterEvent_IsPending() || Meter_GetIdleMs() == 0 || MeterNor_IsBusy() || MeterHistory_GetPending() != 0 ||
+           (int32_t)(g_power_hold_ms - Meter_GetTickMs()) > 0;
+}
+
+/**
+ * @brief SysTick을 멈추고 파워다운 (인터럽트 금지 상태에서 호출)
+ * @param ms 최대 대기 시간 (1 ~ METER_POWER_MAX_MS)
+ * @return 실제로 잔 시간 (ms), Meter_GetTickMs()에 반영됨
+ * @details XSOSC: 기한을 1024Hz 카운트로 올림해 맞추고, 지난 카운트를 ms로 환산한 나머지는
+ *          g_power_frac에 남겨 다음 환산에 더한다 (파워다운을 반복해도 누적 오차 없음).
+ */
+static uint32_t MeterPower_Down(uint32_t ms)
+{
+    uint32_t ticks;
+    uint32_t slept;
+
+    // ms → 카운트 (XSOSC: 올림이므로 기한 도달 시 환산 결과는 ms 이상)
+    ticks = g_power_xsosc ? (ms * 1024 + 999) / 1000 : ms;
+
+    // 기한에 일치 인터럽트 (interval 모드: ADR + 1 카운트)
+    TIMER5n_SetAData(METER_POWER_TIMER, ticks - 1);
+    HAL_TIMER5n_ClearCounter(METER_POWER_TIMER);
+    HAL_TIMER5n_ClearStatus(METER_POWER_TIMER, TIMER5n_CR_MATCH_FLAG);
+    NVIC_ClearPendingIRQ(METER_POWER_TIMER_IRQn);
+    HAL_TIMER5n_Cmd(METER_POWER_TIMER, ENABLE);
+
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+
+    g_power_stats.powerdowns++;
+    MeterRetain_EnterPowerDown();
+
+    // 기한 도달이면 설정한 카운트, 다른 인터럽트로 깼으면 지난 카운트
+    if (HAL_TIMER5n_GetStatus(METER_POWER_TIMER) & TIMER5n_CR_MATCH_FLAG)
+    {
+        slept = ticks;
+    }
+    else
+    {
+        slept = METER_POWER_TIMER->CNT;
+    }
+
+    if (g_power_xsosc)
+    {
+        slept = slept * 1000 + g_power_frac;
+        g_power_frac = slept & 1023;
+        slept >>= 10;
+    }
+
+    HAL_TIMER5n_Cmd(METER_POWER_TIMER, DISABLE);
+    HAL_TIMER5n_ClearStatus(METER_POWER_TIMER, TIMER5n_CR_MATCH_FLAG);
+    NVIC_ClearPendingIRQ(METER_POWER_TIMER_IRQn);
+
+    // 시간 보정 후 SysTick 재시작 (보정 전에 SysTick 핸들러가 돌지 않도록 인터럽트 금지 중)
+    Meter_SysTick_Advance(slept);
+    g_power_stats.powerdown_ms += slept;
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+    return slept;
+}
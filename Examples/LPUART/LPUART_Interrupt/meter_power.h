@@ -0,0 +1,110 @@
+/**
+ *******************************************************************************
+ * @file        meter_power.h
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       tickless 저전력 스케줄러
+ * @details     이벤트 큐가 비면 다음 기한(타이머 이벤트, 로그 기록 기한)을 모아 그때까지 잔다.
+ *              - 송신/수신/NOR 동작 등 밀리초 타이밍이 필요한 동안: sleep 모드
+ *                (SysTick 1ms 인터럽트와 주변장치 인터럽트로 깨어남)
+ *              - 응답 대기: LPUART 수신 깨움(METER_LPUART_WAKE)이면 응답 기한까지 파워다운, 아니면 sleep 모드
+ *              - 모두 유휴: SysTick을 멈추고 TIMER50(XSOSC, 없으면 WDTRC) 일치 인터럽트를 기한에 맞춘 뒤
+ *                파워다운 모드 (SRAM 유지 영역 봉인, 외부 NOR deep power-down)
+ *              깨어나면 파워다운 동안 지난 시간을 Meter_GetTickMs()에 더한다.
+ *******************************************************************************
+ */
+
+#ifndef _METER_POWER_H_
+#define _METER_POWER_H_
+
+#include "main_conf.h"
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//******************************************************************************
+// 저전력 상수 정의
+//******************************************************************************
+
+// 깨움 타이머 (TIMER50, 파워다운 중에도 동작)
+// - XSOSC 32.768kHz (크리스탈 오차 수십 ppm) → 1024Hz 카운트, MeterPower_Down()에서 ms로 환산
+// - XSOSC가 없을 때만 WDTRC 40kHz → 1ms 카운트. 공칭 ±10%라 파워다운 중 틱이 하루 최대 약 2.4시간 틀어짐
+#define METER_POWER_TIMER           ((TIMER5n_Type*)TIMER50)
+#define METER_POWER_TIMER_IRQn      TIMER50_IRQn
+#define METER_POWER_XSOSC_HZ        32768UL
+#define METER_POWER_XSOSC_PRESCALE  ((METER_POWER_XSOSC_HZ / 1024) - 1)    // PREDR: 1/1024s 카운트
+#define METER_POWER_WDTRC_HZ        40000UL
+#define METER_POWER_WDTRC_PRESCALE  ((METER_POWER_WDTRC_HZ / 1000) - 1)    // PREDR: 1ms 카운트
+#define METER_POWER_MAX_MS          60000       // 파워다운 1회 최대 시간 (16비트 카운터, XSOSC 61440카운트)
+
+// 이보다 짧은 기한은 파워다운 대신 sleep 모드 (HIRC 재시작, 봉인 비용이 이득보다 큼)
+#define METER_POWER_MIN_MS          10
+
+// 디버그 키 입력 후 깨어 있는 시간 (UART1 디버그 포트는 파워다운에서 깨울 수 없음)
+#define METER_POWER_CONSOLE_MS      30000
+
+//******************************************************************************
+// 저전력 구조체
+//******************************************************************************
+
+// MeterPower_Idle() 결과
+typedef enum
+{
+    METER_POWER_RUN = 0,            // 기한 도달, 자지 않음
+    METER_POWER_SLEEP,              // sleep 모드 (SysTick 유지)
+    METER_POWER_DOWN                // 파워다운 (tickless)
+} METER_POWER_MODE_Type;
+
+// 통계
+typedef struct
+{
+    uint32_t    sleeps;             // sleep 모드 진입
+    uint32_t    powerdowns;         // 파워다운 진입
+    uint32_t    powerdown_ms;       // 파워다운 누적 시간 (ms)
+    uint32_t    early_wakes;        // 기한 전에 다른 인터럽트로 깸
+} MeterPowerStats_t;
+
+//******************************************************************************
+// 저전력 함수 프로토타입
+//******************************************************************************
+
+/**
+ * @brief 깨움 타이머 초기화
+ * @param xsosc true: XSOSC 발진 확인됨 (TIMER50 ← XSOSC, 1024Hz 카운트)
+ *              false: TIMER50 ← WDTRC, 1ms 카운트 (±10%)
+ * @note SysTick 설정 후 1회 호출
+ */
+void MeterPower_Init(bool xsosc);
+
+/**
+ * @brief 지정 시간 동안 파워다운 금지 (sleep 모드만 사용)
+ * @param ms 지금부터 유지할 시간, 이미 더 길게 유지 중이면 변경 없음
+ */
+void MeterPower_Hold(uint32_t ms);
+
+/**
+ * @brief 다음 기한까지 저전력 대기 (이벤트 큐가 비었을 때 MeterEvent_Run()에서 호출)
+ * @param wait_ms 다음 타이머 이벤트까지 남은 시간 (METER_TICK_NEVER: 없음)
+ * @return 대기 방식
+ * @details 프로토콜(응답 기한), flash 로그, NOR 이력의 기한을 함께 고려한다.
+ *          인터럽트 하나로 깨어나 반환하므로 호출자는 게시된 이벤트를 처리한 뒤 다시 호출한다.
+ *          확인 후 진입 전에 이벤트가 게시되면 자지 않고 METER_POWER_RUN을 반환한다.
+ */
+METER_POWER_MODE_Type MeterPower_Idle(uint32_t wait_ms);
+
+/**
+ * @brief 통계 조회
+ */
+const MeterPowerStats_t* MeterPower_GetStats(void);
+
+/**
+ * @brief TIMER50 인터럽트 핸들러에서 호출
+ */
+void MeterPower_TimerHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _METER_POWER_H_ */
@@ -4,25 +4,79 @@
  * @author      Seoul Digital Water Meter Protocol Implementation
  * @brief       서울시 디지털계량기 프로토콜 V1.3 구현
  * @details     1200bps, 8-N-1 통신 프로토콜
+ *              포트(LPUART, UART0/1, USART10)별 독립 인스턴스, 동시 검침 지원
  *******************************************************************************
  */
 
 #include "meter_protocol.h"
+#include "meter_trace.h"
 #include "string.h"
 
 //******************************************************************************
 // 전역 변수
 //******************************************************************************
 
-static METER_CONTEXT_Type g_meter_ctx;
+// 포트별 프로토콜 인스턴스 (METER_PORT_Type으로 인덱스)
+static METER_CONTEXT_Type g_meter_ctx[METER_PORT_MAX];
+
+#ifdef METER_RX_HW_DELIMIT
+// LPUART 하드웨어 수신 상태 (RCD/DMA/RTO, METER_PORT_LPUART 전용)
+// 0: 대기, 1: 0x68 감지 후 데이터 수신 중, 2: 빈 프레임 버퍼 없음
+static volatile uint8_t g_rx_state = 0;
+
+// 핑퐁 프레임 버퍼 (DMA가 직접 기록, 콜백에 참조로 전달)
+#define RX_BUF_FREE         0       // 비어 있음
+#define RX_BUF_FILLING      1       // DMA 수신 중
+#define RX_BUF_READY        2       // 수신 완료, Meter_Task() 전달 대기
+#define RX_BUF_HELD         3       // 애플리케이션 보유 (Meter_ReleaseFrame() 전까지)
+
+static uint8_t g_rx_frame[METER_RX_BUF_COUNT][METER_MAX_FRAME_SIZE];
+static volatile uint16_t g_rx_frame_len[METER_RX_BUF_COUNT];
+static volatile uint8_t g_rx_frame_state[METER_RX_BUF_COUNT];
+static METER_RX_FRAME_Type g_rx_desc[METER_RX_BUF_COUNT];
+static uint8_t g_rx_fill = 0;       // DMA 수신 대상 버퍼 (LPUART 인터럽트에서 갱신)
+static uint8_t g_rx_deliver = 0;    // 다음 전달 버퍼 (Meter_Task에서 갱신)
+static METER_STATE_Type g_rx_resume_state;  // 프레임 시작 전 상태 (프레임 폐기 시 복귀)
+#endif
+
+// 스트리밍 프레임 조립기 상태 (68 L L 68 [C A CI DATA] CS 16)
+#define ASM_WAIT_START      0       // 0x68 대기
+#define ASM_LEN1            1       // L
+#define ASM_LEN2            2       // L 반복
+#define ASM_START2          3       // 0x68 반복
+#define ASM_BODY            4       // C A CI DATA (L 바이트)
+#define ASM_CS              5       // 체크섬
+#define ASM_STOP            6       // 0x16
+
+// Meter_AsmFeed() 결과
+#define ASM_BUSY            0       // 조립 중
+#define ASM_FRAME           1       // 프레임 완성
+#define ASM_RESYNC          2       // 구조 불일치, 재동기화 필요
+
+// 송신 준비 단계 (METER_STATE_TX, tx_index == 0)
+#define TX_STEP_FIFO_CLEAR  0       // 포트 비활성화로 TX FIFO 클리어 중
+#define TX_STEP_STABILIZE   1       // 포트 재활성화 후 안정화 대기
+
+// 전송 중인 큐 커맨드 없음 (METER_CONTEXT_Type.cmd_active)
+#define METER_CMD_NONE      0xFF
+
+// 커맨드별 기본 전송 정책 (표에 없는 커맨드는 METER_RESPONSE_TIMEOUT_MS/METER_MAX_RETRY/METER_RETRY_BACKOFF_MS)
+static const METER_CMD_POLICY_Type g_cmd_policy[] =
+{
+    //  커맨드                   우선순위            타임아웃  재전송  백오프
+    { CMD_SET_TIME,          METER_PRIO_HIGH,     1000,     5,      50  },
+    { CMD_READ_STATUS,       METER_PRIO_NORMAL,   1000,     3,      100 },
+    { CMD_READ_CURRENT_DATA, METER_PRIO_NORMAL,   1000,     3,      100 },
+    { CMD_READ_HISTORY_DATA, METER_PRIO_LOW,      2000,     2,      200 },
+};
+
+// SysTick 기반 밀리초 카운터 (SysTick 인터럽트에서 증가)
+static volatile uint32_t g_systick_ms = 0;
 
-// 수신 상태 관리 변수 (정적 변수 문제 해결)
-// 0: 대기, 1: 0x68 감지 후 데이터 수신 중
-static uint8_t g_rx_state = 0;
+// 링크 통계 저장 위치 (Meter_SetLinkStats, 예: SRAM 유지 영역)
+static METER_LINK_STATS_Type* g_link_stats = NULL;
 
-// 외부 함수 참조 (main.c에서 정의)
-extern uint32_t rbSend(uint8_t* txbuf, uint8_t buflen);
-extern uint32_t rbReceive(uint8_t* rxbuf, uint8_t buflen);
+#define LINK_STAT_INC(ctx, field)   do { if (g_link_stats != NULL) { g_link_stats[(ctx)->port].field++; } } while (0)
 
 //******************************************************************************
 // 내부 함수 선언
@@ -30,35 +84,103 @@ extern uint32_t rbReceive(uint8_t* rxbuf, uint8_t buflen);
 
 //static void Meter_StateMachine(void);
 static uint32_t Meter_GetTick(void);  // 시스템 틱 가져오기 (구현 필요)
+static bool Meter_PortUsesHwRx(METER_PORT_Type port);
+static void Meter_PortEnable(METER_CONTEXT_Type* ctx, FunctionalState NewState);
+static void Meter_PortTxInterrupt(METER_CONTEXT_Type* ctx, FunctionalState NewState);
+static void Meter_PortRxInterrupt(METER_CONTEXT_Type* ctx, FunctionalState NewState);
+static void Meter_PortTransmitByte(METER_CONTEXT_Type* ctx, uint8_t byte);
+static void Meter_PortClearTxFlag(METER_CONTEXT_Type* ctx);
+static void Meter_StartTransfer(METER_CONTEXT_Type* ctx);
+static void Meter_TxTimerService(METER_CONTEXT_Type* ctx);
+static void Meter_PortTask(METER_CONTEXT_Type* ctx);
+static void Meter_BuildFrame(METER_CONTEXT_Type* ctx, uint8_t cmd, uint8_t* data, uint8_t length);
+static void Meter_CmdDispatch(METER_CONTEXT_Type* ctx);
+static void Meter_CmdComplete(METER_CONTEXT_Type* ctx, METER_ERROR_Type result, uint8_t* data, uint16_t length);
+#ifdef METER_RX_HW_DELIMIT
+static bool Meter_ScanFrame(uint8_t* frame, uint16_t length, METER_RX_FRAME_Type* rx);
+static void Meter_DeliverFrame(METER_CONTEXT_Type* ctx);
+static void Meter_RxArm(void);
+static void Meter_RxAbort(void);
+#endif
+static uint8_t Meter_AsmFeed(METER_CONTEXT_Type* ctx, uint8_t byte);
+static void Meter_AsmPush(METER_CONTEXT_Type* ctx, uint8_t byte);
+static void Meter_AsmDeliver(METER_CONTEXT_Type* ctx);
+static void Meter_AsmCheckTimeout(METER_CONTEXT_Type* ctx);
+static bool Meter_AcceptFrame(METER_CONTEXT_Type* ctx, const METER_RX_FRAME_Type* rx);
+static void Meter_ResetRxState(METER_CONTEXT_Type* ctx);
 
 //******************************************************************************
 // 공용 함수 구현
 //******************************************************************************
 
 /**
- * @brief 계량기 프로토콜 초기화
+ * @brief 계량기 프로토콜 초기화 (포트 인스턴스 바인딩)
+ * @param port 계량기가 연결된 포트
+ * @details 포트의 보레이트(1200bps 8-N-1), 핀, NVIC 설정은 애플리케이션에서 먼저 완료해야 한다.
+ *          초기화된 포트는 Meter_Task()/Meter_SysTick_Increment()에서 함께 처리된다.
  */
-void Meter_Init(void)
+void Meter_Init(METER_PORT_Type port)
 {
-    memset(&g_meter_ctx, 0, sizeof(METER_CONTEXT_Type));
-    g_meter_ctx.state = METER_STATE_IDLE;
-    g_meter_ctx.last_error = METER_ERR_NONE;
+    METER_CONTEXT_Type* ctx;
+
+    if (port >= METER_PORT_MAX)
+    {
+        return;
+    }
+
+    ctx = &g_meter_ctx[port];
+    memset(ctx, 0, sizeof(METER_CONTEXT_Type));
+    ctx->port = port;
+    ctx->state = METER_STATE_IDLE;
+    ctx->last_error = METER_ERR_NONE;
+    ctx->cmd_active = METER_CMD_NONE;
+
+#ifdef METER_RX_HW_DELIMIT
+    if (Meter_PortUsesHwRx(port))
+    {
+        memset((void*)g_rx_frame_state, RX_BUF_FREE, sizeof(g_rx_frame_state));
+        g_rx_fill = 0;
+        g_rx_deliver = 0;
+
+        // LPUART 수신 데이터 → 프레임 버퍼 (8bit, 주변장치 에러 시 정지)
+        HAL_DMAC_Init((DMACn_Type*)METER_RX_DMA_CHANNEL, PERSEL_LPUARTRx, DIR_PeriToMem, SIZE_8bit, ERFGSTP_Enable);
+
+        // RCD: 프레임 시작 문자(0x68), RTO: 프레임 종료 판단 무수신 시간
+        HAL_LPUART_SetCharacterDetect(METER_FRAME_START_RX);
+        HAL_LPUART_SetReceiveTimeOut(METER_RX_TIMEOUT_BITS);
+        Meter_RxArm();
+    }
+    else
+#endif
+    {
+        // 바이트 수신 인터럽트 → 포트별 링 버퍼 → Meter_Task()에서 조립
+        Meter_PortRxInterrupt(ctx, ENABLE);
+    }
+
+    // 설정 완료 후 활성화 (SysTick/스케줄러가 이 포트를 처리하기 시작)
+    ctx->active = true;
 }
 
 /**
  * @brief 응답 수신 콜백 함수 설정
  */
-void Meter_SetResponseCallback(void (*callback)(uint8_t* data, uint16_t length))
+void Meter_SetResponseCallback(METER_PORT_Type port, void (*callback)(METER_PORT_Type port, uint8_t* data, uint16_t length))
 {
-    g_meter_ctx.on_response_received = callback;
+    if (port < METER_PORT_MAX)
+    {
+        g_meter_ctx[port].on_response_received = callback;
+    }
 }
 
 /**
  * @brief 에러 콜백 함수 설정
  */
-void Meter_SetErrorCallback(void (*callback)(METER_ERROR_Type error))
+void Meter_SetErrorCallback(METER_PORT_Type port, void (*callback)(METER_PORT_Type port, METER_ERROR_Type error))
 {
-    g_meter_ctx.on_error = callback;
+    if (port < METER_PORT_MAX)
+    {
+        g_meter_ctx[port].on_error = callback;
+    }
 }
 
 /**
@@ -80,11 +202,39 @@ uint8_t Meter_CalculateChecksum(uint8_t* data, uint16_t length)
     return checksum;
 }
 
+/**
+ * @brief CRC-16/CCITT 계산 (다항식 0x1021, 니블 테이블)
+ * @param data 데이터 포인터
+ * @param length 데이터 길이
+ * @param crc 초기값 (처음 0xFFFF, 이어서 계산 시 이전 결과)
+ * @return CRC 값
+ */
+uint16_t Meter_CRC16(const void* data, uint16_t length, uint16_t crc)
+{
+    static const uint16_t nibble_table[16] =
+    {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+    };
+    const uint8_t* p = (const uint8_t*)data;
+
+    while (length--)
+    {
+        crc = (uint16_t)((crc << 4) ^ nibble_table[(crc >> 12) ^ (*p >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ nibble_table[(crc >> 12) ^ (*p & 0x0F)]);
+        p++;
+    }
+
+    return crc;
+}
+
 /**
  * @brief Preamble 전송 (20ms High Level)
  * @details TTL High Level을 20ms 동안 유지하여 통신 시작 신호 전송
  * @note 서울시 디지털계량기 프로토콜 요구사항:
  *       통신 시작 전 TX 라인을 High로 20ms 유지
+ * @note 블로킹 함수. Meter_SendCommand()는 이 함수 대신
+ *       SysTick 기반 비동기 Preamble 단계를 사용한다.
  */
 void Meter_SendPreamble(void)
 {
@@ -97,7 +247,8 @@ void Meter_SendPreamble(void)
     // SystemCoreClock = 32MHz 기준
     // 32,000,000 Hz / 1000 * 20 = 640,000 사이클
     // 실제로는 루프 오버헤드 고려하여 조정
-    for (delay = 0; delay < METER_PREAMBLE_DELAY_CYCLES; delay++)
+    // 클럭 단계가 낮으면(meter_clock.h) 같은 비율로 줄임
+    for (delay = 0; delay < METER_PREAMBLE_DELAY_CYCLES / (32000000UL / SystemCoreClock); delay++)
     {
         __NOP();
     }
@@ -136,490 +287,1609 @@ uint8_t Meter_ValidateFrame(METER_FRAME_Type* frame)
 
 /**
  * @brief 커맨드 전송
+ * @param port 계량기 포트
  * @param addr 계량기 주소 (사용 안 함)
  * @param cmd 커맨드 코드
  * @param data 전송할 데이터
  * @param length 데이터 길이
  * @return 에러 코드
  */
-METER_ERROR_Type Meter_SendCommand(uint8_t addr, uint8_t cmd, uint8_t* data, uint8_t length)
+METER_ERROR_Type Meter_SendCommand(METER_PORT_Type port, uint8_t addr, uint8_t cmd, uint8_t* data, uint8_t length)
 {
-    uint16_t frame_length = 0;
-    uint16_t i;
+    METER_CONTEXT_Type* ctx;
 
     // 파라미터 검사
-    if (length > (METER_MAX_FRAME_SIZE - 4))
+    if (port >= METER_PORT_MAX || !g_meter_ctx[port].active || length > (METER_MAX_FRAME_SIZE - 4))
     {
         return METER_ERR_INVALID_PARAM;
     }
 
+    ctx = &g_meter_ctx[port];
+
     // 프로토콜이 IDLE 상태인지 확인
-    if (g_meter_ctx.state != METER_STATE_IDLE)
+    if (ctx->state != METER_STATE_IDLE)
     {
         return METER_ERR_INVALID_PARAM;
     }
 
+    Meter_BuildFrame(ctx, cmd, data, length);
+
+    // 큐를 거치지 않은 커맨드는 기본 정책 사용
+    ctx->response_timeout_ms = METER_RESPONSE_TIMEOUT_MS;
+    ctx->max_retry = METER_MAX_RETRY;
+    ctx->backoff_ms = METER_RETRY_BACKOFF_MS;
+
+    // 비동기 전송 시작: Preamble → TX → WAIT_RESPONSE 단계는
+    // SysTick 및 포트 TX 인터럽트에서 진행되며 호출자는 즉시 반환
+    Meter_StartTransfer(ctx);
+
+    return METER_ERR_NONE;
+}
+
+/**
+ * @brief 송신 프레임 생성 (tx_buffer/tx_length)
+ * @param ctx 포트 인스턴스
+ * @param cmd 커맨드 코드
+ * @param data 전송할 데이터
+ * @param length 데이터 길이
+ */
+static void Meter_BuildFrame(METER_CONTEXT_Type* ctx, uint8_t cmd, uint8_t* data, uint8_t length)
+{
+    uint16_t frame_length = 0;
+    uint16_t i;
+
     // 프레임 생성: [HEADER] [CMD] [LEN] [DATA...] [CHECKSUM]
     // 예시: 10-5B-01-5C-16
-    g_meter_ctx.tx_buffer[frame_length++] = METER_FRAME_HEADER_TX;  // 0x10
-    g_meter_ctx.tx_buffer[frame_length++] = cmd;                    // 0x5B
-    g_meter_ctx.tx_buffer[frame_length++] = length;                 // 0x01
+    ctx->tx_buffer[frame_length++] = METER_FRAME_HEADER_TX;  // 0x10
+    ctx->tx_buffer[frame_length++] = cmd;                    // 0x5B
+    ctx->tx_buffer[frame_length++] = length;                 // 0x01
 
     // 데이터 복사
     if (data != NULL && length > 0)
     {
         for (i = 0; i < length; i++)
         {
-            g_meter_ctx.tx_buffer[frame_length++] = data[i];    // 0x5C
+            ctx->tx_buffer[frame_length++] = data[i];    // 0x5C
         }
     }
 
     // 체크섬 계산 (HEADER + CMD + LEN + DATA의 XOR)
     // 예: 0x10 ^ 0x5B ^ 0x01 ^ 0x5C = 0x16
-    g_meter_ctx.tx_buffer[frame_length] = Meter_CalculateChecksum(g_meter_ctx.tx_buffer, frame_length);
+    ctx->tx_buffer[frame_length] = Meter_CalculateChecksum(ctx->tx_buffer, frame_length);
     frame_length++;
 
-    g_meter_ctx.tx_length = frame_length;
-    g_meter_ctx.tx_index = 0;
+    ctx->tx_length = frame_length;
+    ctx->retry_count = 0;
+
+    // 디버그: 전송 프레임 출력 (주석 처리 - 필요시 활성화)
+    /*
+    {
+        uint16_t i;
+        _DBG("TX Frame: ");
+        for (i = 0; i < ctx->tx_length; i++)
+        {
+            _DBH(ctx->tx_buffer[i]);
+            _DBG(" ");
+        }
+        _DBG("\n\r");
+    }
+    */
+}
+
+/**
+ * @brief 커맨드 큐 등록 (커맨드별 기본 정책)
+ * @param port 계량기 포트
+ * @param cmd 커맨드 코드 (CMD_READ_CURRENT_DATA, CMD_READ_HISTORY_DATA, CMD_SET_TIME, CMD_READ_STATUS 등)
+ * @param data 전송할 데이터 (큐에 복사됨)
+ * @param length 데이터 길이 (METER_CMD_DATA_MAX 이하)
+ * @param on_complete 완료 콜백 (NULL 가능)
+ * @return METER_ERR_NONE, 큐가 가득 차면 METER_ERR_BUFFER_OVERFLOW
+ */
+METER_ERROR_Type Meter_QueueCommand(METER_PORT_Type port, uint8_t cmd, uint8_t* data, uint8_t length, METER_CMD_DONE_Type on_complete)
+{
+    METER_CMD_POLICY_Type policy;
+    uint8_t i;
+
+    // 기본 정책
+    policy.cmd = cmd;
+    policy.priority = METER_PRIO_NORMAL;
+    policy.timeout_ms = METER_RESPONSE_TIMEOUT_MS;
+    policy.max_retry = METER_MAX_RETRY;
+    policy.backoff_ms = METER_RETRY_BACKOFF_MS;
+
+    for (i = 0; i < sizeof(g_cmd_policy) / sizeof(g_cmd_policy[0]); i++)
+    {
+        if (g_cmd_policy[i].cmd == cmd)
+        {
+            policy = g_cmd_policy[i];
+            break;
+        }
+    }
 
-    // Preamble 전송 전 LPUART TX 인터럽트 비활성화
-    HAL_LPUART_ConfigInterrupt(LPUART_INTCFG_TXCIEN, DISABLE);
+    return Meter_QueueCommandPolicy(port, &policy, data, length, on_complete);
+}
 
-    // Preamble 전송
-    g_meter_ctx.state = METER_STATE_PREAMBLE;
-    Meter_SendPreamble();
+/**
+ * @brief 커맨드 큐 등록 (정책 지정)
+ * @param port 계량기 포트
+ * @param policy 커맨드 코드 및 우선순위/타임아웃/재전송/백오프 정책 (큐에 복사됨)
+ * @param data 전송할 데이터 (큐에 복사됨)
+ * @param length 데이터 길이 (METER_CMD_DATA_MAX 이하)
+ * @param on_complete 완료 콜백 (NULL 가능)
+ * @return METER_ERR_NONE, 큐가 가득 차면 METER_ERR_BUFFER_OVERFLOW
+ * @details 포트가 IDLE이면 즉시 전송을 시작하고, 아니면 현재 커맨드의 응답 수신 또는
+ *          재전송 소진 시점에 Meter_Task()가 우선순위가 가장 높은 커맨드를 바로 이어서 전송한다.
+ * @note 메인 루프(Meter_Task()와 같은 문맥)에서 호출
+ */
+METER_ERROR_Type Meter_QueueCommandPolicy(METER_PORT_Type port, const METER_CMD_POLICY_Type* policy, uint8_t* data, uint8_t length, METER_CMD_DONE_Type on_complete)
+{
+    METER_CONTEXT_Type* ctx;
+    METER_CMD_ENTRY_Type* entry = NULL;
+    uint8_t i;
 
-    // LPUART TX FIFO 클리어 및 안정화
+    if (port >= METER_PORT_MAX || !g_meter_ctx[port].active || policy == NULL ||
+        length > METER_CMD_DATA_MAX || (length > 0 && data == NULL))
     {
-        volatile uint32_t delay;
+        return METER_ERR_INVALID_PARAM;
+    }
 
-        // TX 인터럽트 완전 비활성화
-        HAL_LPUART_ConfigInterrupt(LPUART_INTCFG_TXCIEN, DISABLE);
+    ctx = &g_meter_ctx[port];
 
-        // LPUART를 일시적으로 비활성화 후 재활성화 (FIFO 클리어)
-        HAL_LPUART_Enable(DISABLE);
-        for (delay = 0; delay < METER_FIFO_CLEAR_DELAY; delay++) { __NOP(); }
-        HAL_LPUART_Enable(ENABLE);
+    for (i = 0; i < METER_CMD_QUEUE_SIZE; i++)
+    {
+        if (!ctx->cmd_queue[i].used)
+        {
+            entry = &ctx->cmd_queue[i];
+            break;
+        }
+    }
 
-        // 추가 안정화 딜레이 (첫 바이트 손실 방지)
-        for (delay = 0; delay < METER_TX_STABILIZE_DELAY; delay++) { __NOP(); }
+    if (entry == NULL)
+    {
+        return METER_ERR_BUFFER_OVERFLOW;
     }
 
-    // 디버그: 전송 프레임 출력 (주석 처리 - 필요시 활성화)
-    /*
+    entry->seq = ctx->cmd_seq++;
+    entry->length = length;
+    if (length > 0)
     {
-        uint16_t i;
-        _DBG("TX Frame: ");
-        for (i = 0; i < g_meter_ctx.tx_length; i++)
+        memcpy(entry->data, data, length);
+    }
+    entry->policy = *policy;
+    entry->on_complete = on_complete;
+    entry->used = true;
+
+    Meter_CmdDispatch(ctx);
+
+    return METER_ERR_NONE;
+}
+
+/**
+ * @brief 대기 + 전송 중 커맨드 수
+ */
+uint8_t Meter_GetQueueCount(METER_PORT_Type port)
+{
+    uint8_t count = 0;
+    uint8_t i;
+
+    if (port >= METER_PORT_MAX)
+    {
+        return 0;
+    }
+
+    for (i = 0; i < METER_CMD_QUEUE_SIZE; i++)
+    {
+        if (g_meter_ctx[port].cmd_queue[i].used)
         {
-            _DBH(g_meter_ctx.tx_buffer[i]);
-            _DBG(" ");
+            count++;
         }
-        _DBG("\n\r");
     }
-    */
-
-    // 데이터 전송 (BLOCKING 모드로 한 번에 전송)
-    // 계량기가 프레임을 인식하려면 바이트 간 간격 없이 연속으로 전송해야 함
-    g_meter_ctx.state = METER_STATE_TX;
-    HAL_LPUART_Transmit(g_meter_ctx.tx_buffer, g_meter_ctx.tx_length, BLOCKING);
 
-    // 전송 완료 대기 (추가 딜레이로 안정성 확보)
+    return count;
+}
+
+/**
+ * @brief 다음 큐 커맨드 전송 시작
+ * @param ctx 포트 인스턴스
+ * @details 포트가 IDLE이고 전송 중인 큐 커맨드가 없으면 우선순위가 가장 높은
+ *          (같은 우선순위는 먼저 등록된) 커맨드의 프레임을 생성하여 전송한다.
+ */
+static void Meter_CmdDispatch(METER_CONTEXT_Type* ctx)
+{
+    METER_CMD_ENTRY_Type* entry;
+    uint8_t best = METER_CMD_NONE;
+    uint8_t i;
+
+    if (ctx->state != METER_STATE_IDLE || ctx->cmd_active != METER_CMD_NONE)
+    {
+        return;
+    }
+
+    for (i = 0; i < METER_CMD_QUEUE_SIZE; i++)
+    {
+        entry = &ctx->cmd_queue[i];
+        if (!entry->used)
+        {
+            continue;
+        }
+
+        // seq 차이를 부호 있는 값으로 비교 (순환 카운터)
+        if (best == METER_CMD_NONE ||
+            entry->policy.priority < ctx->cmd_queue[best].policy.priority ||
+            (entry->policy.priority == ctx->cmd_queue[best].policy.priority &&
+             (int8_t)(entry->seq - ctx->cmd_queue[best].seq) < 0))
+        {
+            best = i;
+        }
+    }
+
+    if (best == METER_CMD_NONE)
+    {
+        return;
+    }
+
+    entry = &ctx->cmd_queue[best];
+    ctx->cmd_active = best;
+
+    Meter_BuildFrame(ctx, entry->policy.cmd, entry->data, entry->length);
+    ctx->response_timeout_ms = entry->policy.timeout_ms;
+    ctx->max_retry = entry->policy.max_retry;
+    ctx->backoff_ms = entry->policy.backoff_ms;
+
+    Meter_StartTransfer(ctx);
+}
+
+/**
+ * @brief 전송 중인 큐 커맨드 완료 처리
+ * @param ctx 포트 인스턴스
+ * @param result METER_ERR_NONE: 응답 수신, METER_ERR_TIMEOUT: 재전송 소진
+ * @param data 응답 프레임 (타임아웃 시 NULL)
+ * @param length 응답 프레임 길이
+ * @details 항목을 먼저 해제한 후 콜백을 호출하므로 콜백 안에서 다시 등록할 수 있다.
+ */
+static void Meter_CmdComplete(METER_CONTEXT_Type* ctx, METER_ERROR_Type result, uint8_t* data, uint16_t length)
+{
+    METER_CMD_ENTRY_Type* entry;
+    METER_CMD_DONE_Type on_complete;
+    uint8_t cmd;
+
+    if (ctx->cmd_active == METER_CMD_NONE)
+    {
+        return;
+    }
+
+    entry = &ctx->cmd_queue[ctx->cmd_active];
+    on_complete = entry->on_complete;
+    cmd = entry->policy.cmd;
+
+    entry->used = false;
+    ctx->cmd_active = METER_CMD_NONE;
+
+    if (on_complete != NULL)
+    {
+        on_complete(ctx->port, cmd, result, data, length);
+    }
+}
+
+/**
+ * @brief 활성화된 모든 포트에 같은 커맨드 동시 전송
+ * @param cmd 커맨드 코드
+ * @param data 전송할 데이터
+ * @param length 데이터 길이
+ * @return 전송을 시작한 포트 비트마스크 (bit n = METER_PORT_Type n)
+ * @details 각 포트의 Preamble/송신/응답 대기가 인터럽트에서 병렬로 진행되므로
+ *          전체 검침 시간은 포트 수의 합이 아니라 가장 느린 계량기 1대의 시간이 된다.
+ *          완료 여부는 Meter_PollDone()으로 확인한다.
+ */
+uint8_t Meter_PollAll(uint8_t cmd, uint8_t* data, uint8_t length)
+{
+    uint8_t started = 0;
+    uint8_t port;
+
+    for (port = 0; port < METER_PORT_MAX; port++)
+    {
+        if (g_meter_ctx[port].active &&
+            Meter_SendCommand((METER_PORT_Type)port, 0, cmd, data, length) == METER_ERR_NONE)
+        {
+            started |= (uint8_t)(1 << port);
+        }
+    }
+
+    return started;
+}
+
+/**
+ * @brief 동시 검침 완료 확인
+ * @return true: 활성화된 모든 포트가 응답 수신 또는 재전송 소진으로 IDLE
+ */
+bool Meter_PollDone(void)
+{
+    uint8_t port;
+
+    for (port = 0; port < METER_PORT_MAX; port++)
+    {
+        if (g_meter_ctx[port].active && g_meter_ctx[port].state != METER_STATE_IDLE)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief ACK 전송
+ * @param port 계량기 포트
+ * @note 커맨드 송신 중에는 전송하지 않음 (응답 수신 후 송신기가 비어 있을 때 사용)
+ */
+METER_ERROR_Type Meter_SendACK(METER_PORT_Type port)
+{
+    if (port >= METER_PORT_MAX || !g_meter_ctx[port].active ||
+        g_meter_ctx[port].state == METER_STATE_PREAMBLE || g_meter_ctx[port].state == METER_STATE_TX)
+    {
+        return METER_ERR_INVALID_PARAM;
+    }
+
+    Meter_PortTransmitByte(&g_meter_ctx[port], METER_ACK);
+    return METER_ERR_NONE;
+}
+
+/**
+ * @brief NAK 전송
+ * @param port 계량기 포트
+ * @note 커맨드 송신 중에는 전송하지 않음 (응답 수신 후 송신기가 비어 있을 때 사용)
+ */
+METER_ERROR_Type Meter_SendNAK(METER_PORT_Type port)
+{
+    if (port >= METER_PORT_MAX || !g_meter_ctx[port].active ||
+        g_meter_ctx[port].state == METER_STATE_PREAMBLE || g_meter_ctx[port].state == METER_STATE_TX)
+    {
+        return METER_ERR_INVALID_PARAM;
+    }
+
+    Meter_PortTransmitByte(&g_meter_ctx[port], METER_NAK);
+    return METER_ERR_NONE;
+}
+
+/**
+ * @brief 수신 데이터 처리 (L 필드 기반 스트리밍 조립)
+ * @param port 계량기 포트
+ * @param data 수신 데이터
+ * @param length 데이터 길이
+ *
+ * @details 프레임 구조: 68 L L 68 [C A CI DATA] CS 16
+ *          - 0x68을 트리거로 프레임 시작 감지
+ *          - 반복된 L/0x68을 헤더 수신 즉시 검증
+ *          - L 바이트 수신 후 CS, 0x16 위치로 프레임 종료 확정
+ *            (데이터/체크섬 내 0x16에 의해 프레임이 잘리지 않음)
+ *          - 헤더/종료 불일치 시 수신된 바이트에서 다음 0x68부터 재조립
+ */
+void Meter_ProcessReceive(METER_PORT_Type port, uint8_t* data, uint16_t length)
+{
+    uint16_t i;
+
+    if (port >= METER_PORT_MAX)
+    {
+        return;
+    }
+
+    for (i = 0; i < length; i++)
+    {
+        Meter_AsmPush(&g_meter_ctx[port], data[i]);
+    }
+}
+
+/**
+ * @brief 프레임 조립기에 1바이트 입력
+ * @param ctx 포트 인스턴스
+ * @param byte 수신 바이트
+ * @return ASM_BUSY: 조립 중, ASM_FRAME: 프레임 완성, ASM_RESYNC: 프레임 구조 불일치
+ * @details 0x68 대기 중이 아니면 바이트를 rx_buffer에 저장한 뒤 검사하므로,
+ *          불일치가 발생한 바이트도 재조립 대상에 포함된다.
+ */
+static uint8_t Meter_AsmFeed(METER_CONTEXT_Type* ctx, uint8_t byte)
+{
+    METER_ASM_Type* as = &ctx->rx_asm;
+
+    if (as->state == ASM_WAIT_START)
+    {
+        if (byte != METER_FRAME_START_RX)
+        {
+            return ASM_BUSY;        // 프레임 밖 잡음 무시
+        }
+        ctx->rx_index = 0;
+        as->resume_state = ctx->state;
+        ctx->state = METER_STATE_RX;
+    }
+
+    // L <= METER_MAX_FRAME_SIZE - 6 검사로 버퍼 범위 보장
+    ctx->rx_buffer[ctx->rx_index++] = byte;
+
+    switch (as->state)
+    {
+        case ASM_WAIT_START:
+            as->state = ASM_LEN1;
+            break;
+
+        case ASM_LEN1:
+            if (byte < 3 || byte > METER_MAX_FRAME_SIZE - 6)
+            {
+                return ASM_RESYNC;  // C, A, CI 최소 3바이트
+            }
+            as->len = byte;
+            as->state = ASM_LEN2;
+            break;
+
+        case ASM_LEN2:
+            if (byte != as->len)
+            {
+                return ASM_RESYNC;
+            }
+            as->state = ASM_START2;
+            break;
+
+        case ASM_START2:
+            if (byte != METER_FRAME_START_RX)
+            {
+                return ASM_RESYNC;
+            }
+            as->remain = as->len;
+            as->sum = 0;
+            as->xor_sum = 0;
+            as->state = ASM_BODY;
+            break;
+
+        case ASM_BODY:
+            as->sum += byte;        // 체크섬: C + A + CI + UserData 합
+            as->xor_sum ^= byte;
+            if (--as->remain == 0)
+            {
+                as->state = ASM_CS;
+            }
+            break;
+
+        case ASM_CS:
+            as->state = ASM_STOP;
+            break;
+
+        case ASM_STOP:
+            if (byte != METER_FRAME_END_RX)
+            {
+                return ASM_RESYNC;
+            }
+            as->state = ASM_WAIT_START;
+            return ASM_FRAME;
+
+        default:
+            return ASM_RESYNC;
+    }
+
+    return ASM_BUSY;
+}
+
+/**
+ * @brief 프레임 조립기 입력 및 재동기화
+ * @param ctx 포트 인스턴스
+ * @param byte 수신 바이트
+ * @details 구조 불일치 시 버퍼 첫 바이트(0x68)만 버리고 나머지를 다시 조립한다.
+ *          재조립 중 다시 불일치하면 미처리 바이트를 조립 중인 바이트 뒤로 옮겨 반복한다.
+ *          매 반복마다 최소 1바이트가 버려지므로 루프는 유한하며, 재전송 없이 다음 프레임을 찾는다.
+ *          바이트마다 바이트간 기한(METER_BYTE_TIMEOUT_MS)을 다시 잡는다.
+ */
+static void Meter_AsmPush(METER_CONTEXT_Type* ctx, uint8_t byte)
+{
+    uint16_t i;
+    uint16_t n;
+    uint8_t result;
+
+    ctx->rx_asm.byte_deadline_ms = Meter_GetTick() + METER_BYTE_TIMEOUT_MS;
+    result = Meter_AsmFeed(ctx, byte);
+
+    while (result != ASM_BUSY)
+    {
+        if (result == ASM_FRAME)
+        {
+            Meter_AsmDeliver(ctx);
+            return;
+        }
+
+        // ASM_RESYNC: rx_buffer[1..n) 재조립 (저장 위치는 항상 읽기 위치보다 앞)
+        n = ctx->rx_index;
+        ctx->rx_asm.state = ASM_WAIT_START;
+        ctx->rx_index = 0;
+        ctx->state = ctx->rx_asm.resume_state;
+        result = ASM_BUSY;
+
+        for (i = 1; i < n; i++)
+        {
+            result = Meter_AsmFeed(ctx, ctx->rx_buffer[i]);
+
+            if (result == ASM_FRAME)
+            {
+                Meter_AsmDeliver(ctx);
+                result = ASM_BUSY;
+            }
+            else if (result == ASM_RESYNC)
+            {
+                // 미처리 바이트를 현재 조립 바이트 뒤에 이어 붙인 후 다시 재조립
+                memmove(&ctx->rx_buffer[ctx->rx_index], &ctx->rx_buffer[i + 1], n - i - 1);
+                ctx->rx_index += n - i - 1;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief 수신 프레임 체크섬 판정
+ * @param ctx 포트 인스턴스
+ * @param rx 수신 프레임 디스크립터
+ * @return true: 응답 콜백으로 전달, false: 체크섬 오류 (디코딩 없이 폐기)
+ * @details 체크섬 오류 시 에러 콜백 호출 후 NAK를 전송하여 재송신을 요청한다.
+ *          응답 대기 상태는 유지되므로 재송신이 없으면 기존 타임아웃/재전송이 동작한다.
+ */
+static bool Meter_AcceptFrame(METER_CONTEXT_Type* ctx, const METER_RX_FRAME_Type* rx)
+{
+    if (rx->checksum_valid)
+    {
+        TRACE2("port %u rx frame %u bytes", ctx->port, rx->length);
+        LINK_STAT_INC(ctx, rx_frames);
+        return true;
+    }
+
+    TRACE3("port %u rx checksum error recv 0x%02X calc 0x%02X", ctx->port, rx->checksum_received, rx->sum);
+    LINK_STAT_INC(ctx, checksum_errors);
+
+    ctx->last_error = METER_ERR_CHECKSUM;
+    if (ctx->on_error != NULL)
+    {
+        ctx->on_error(ctx->port, METER_ERR_CHECKSUM);
+    }
+    Meter_SendNAK(ctx->port);
+
+    return false;
+}
+
+/**
+ * @brief 조립 완료된 수신 프레임 전달 및 수신 상태 초기화
+ * @param ctx 포트 인스턴스
+ * @details 조립 중 누적한 체크섬으로 디스크립터를 작성하고 (프레임 재순회 없음),
+ *          체크섬이 맞으면 rx_buffer/rx_index의 프레임을 응답 콜백으로 전달한다.
+ */
+static void Meter_AsmDeliver(METER_CONTEXT_Type* ctx)
+{
+    METER_RX_FRAME_Type* rx = &ctx->rx_desc;
+
+    ctx->rx_length = ctx->rx_index;
+
+    rx->frame = ctx->rx_buffer;
+    rx->length = ctx->rx_length;
+    rx->sum = ctx->rx_asm.sum;
+    rx->xor_sum = ctx->rx_asm.xor_sum;
+    rx->checksum_received = ctx->rx_buffer[ctx->rx_length - 2];
+    rx->checksum_valid = (rx->sum == rx->checksum_received);
+
+    if (Meter_AcceptFrame(ctx, rx))
+    {
+        ctx->state = METER_STATE_COMPLETE;
+        Meter_CmdComplete(ctx, METER_ERR_NONE, ctx->rx_buffer, ctx->rx_length);
+
+        // 콜백 호출 (전체 프레임 전달)
+        if (ctx->on_response_received != NULL)
+        {
+            ctx->on_response_received(ctx->port, ctx->rx_buffer, ctx->rx_length);
+        }
+
+        ctx->state = METER_STATE_IDLE;
+    }
+    else
+    {
+        ctx->state = ctx->rx_asm.resume_state;
+    }
+
+    // 상태 초기화
+    ctx->rx_asm.state = ASM_WAIT_START;
+    ctx->rx_index = 0;
+}
+
+/**
+ * @brief 바이트간 타임아웃 처리
+ * @param ctx 포트 인스턴스
+ * @details 0x68 이후 METER_BYTE_TIMEOUT_MS 동안 다음 바이트가 없으면 (잡음 0x68, 잘린 프레임)
+ *          조립 중 바이트를 버리고 프레임 시작 전 상태로 돌아간다.
+ *          응답 대기 중이었으면 이후 응답 타임아웃/재전송이 그대로 동작한다.
+ */
+static void Meter_AsmCheckTimeout(METER_CONTEXT_Type* ctx)
+{
+    if (ctx->rx_asm.state == ASM_WAIT_START ||
+        (int32_t)(Meter_GetTick() - ctx->rx_asm.byte_deadline_ms) < 0)
+    {
+        return;
+    }
+
+    TRACE2("port %u rx byte timeout %u bytes", ctx->port, ctx->rx_index);
+    LINK_STAT_INC(ctx, invalid_frames);
+
+    ctx->rx_asm.state = ASM_WAIT_START;
+    ctx->rx_index = 0;
+    ctx->state = ctx->rx_asm.resume_state;
+}
+
+#ifdef METER_RX_HW_DELIMIT
+/**
+ * @brief DMA 수신 프레임 구조 확인 및 디스크립터 작성
+ * @param frame 프레임 버퍼
+ * @param length RTO까지 수신된 바이트 수
+ * @param rx 작성할 디스크립터
+ * @return true: 구조 정상, false: 잘못된 프레임
+ * @details 바이트 단위 인터럽트가 없는 DMA 경로에서는 프레임 종료 후 BODY를 1회 순회하여
+ *          체크섬을 누적한다. L 필드로 프레임 끝을 정하므로 0x16 뒤 잡음은 제외된다.
+ */
+static bool Meter_ScanFrame(uint8_t* frame, uint16_t length, METER_RX_FRAME_Type* rx)
+{
+    uint8_t L;
+    uint16_t i;
+
+    if (length < 9 || frame[1] != frame[2] || frame[3] != METER_FRAME_START_RX)
+    {
+        return false;
+    }
+
+    L = frame[1];
+    if (L < 3 || length < (uint16_t)(L + 6) || frame[L + 5] != METER_FRAME_END_RX)
+    {
+        return false;
+    }
+
+    rx->frame = frame;
+    rx->length = L + 6;
+    rx->sum = 0;
+    rx->xor_sum = 0;
+    for (i = 4; i < 4 + L; i++)
+    {
+        rx->sum += frame[i];
+        rx->xor_sum ^= frame[i];
+    }
+    rx->checksum_received = frame[4 + L];
+    rx->checksum_valid = (rx->sum == rx->checksum_received);
+
+    return true;
+}
+
+/**
+ * @brief 완성된 핑퐁 버퍼 프레임 전달 (METER_PORT_LPUART)
+ * @param ctx LPUART 포트 인스턴스
+ * @details 다음 완성 버퍼를 복사 없이 응답 콜백에 전달하며,
+ *          버퍼는 Meter_ReleaseFrame() 호출까지 애플리케이션이 보유한다.
+ *          구조/체크섬 오류 프레임은 디코딩 없이 즉시 반환한다.
+ */
+static void Meter_DeliverFrame(METER_CONTEXT_Type* ctx)
+{
+    uint8_t idx = g_rx_deliver;
+    METER_RX_FRAME_Type* rx = &g_rx_desc[idx];
+
+    g_rx_deliver = (uint8_t)((idx + 1) % METER_RX_BUF_COUNT);
+    g_rx_frame_state[idx] = RX_BUF_HELD;
+
+    if (!Meter_ScanFrame(g_rx_frame[idx], g_rx_frame_len[idx], rx))
+    {
+        TRACE2("port %u rx invalid frame %u bytes", ctx->port, g_rx_frame_len[idx]);
+        LINK_STAT_INC(ctx, invalid_frames);
+
+        ctx->last_error = METER_ERR_INVALID_FRAME;
+        if (ctx->on_error != NULL)
+        {
+            ctx->on_error(ctx->port, METER_ERR_INVALID_FRAME);
+        }
+        ctx->state = g_rx_resume_state;
+        Meter_ReleaseFrame(g_rx_frame[idx]);
+        return;
+    }
+
+    if (!Meter_AcceptFrame(ctx, rx))
+    {
+        ctx->state = g_rx_resume_state;
+        Meter_ReleaseFrame(g_rx_frame[idx]);
+        return;
+    }
+
+    ctx->state = METER_STATE_COMPLETE;
+    Meter_CmdComplete(ctx, METER_ERR_NONE, rx->frame, rx->length);
+
+    // 콜백 호출 (프레임 버퍼 참조 전달)
+    if (ctx->on_response_received != NULL)
+    {
+        ctx->on_response_received(ctx->port, rx->frame, rx->length);
+    }
+    else
+    {
+        Meter_ReleaseFrame(g_rx_frame[idx]);
+    }
+
+    ctx->state = METER_STATE_IDLE;
+}
+#endif
+
+/**
+ * @brief 응답 콜백으로 전달된 프레임 버퍼 반환
+ * @param frame 콜백의 data 포인터
+ * @details 콜백 내부 또는 이후 처리 완료 시점에 호출한다. 반환 전까지 버퍼 내용은 유지되며,
+ *          두 버퍼가 모두 보유 중이면 다음 프레임 수신은 반환 시점까지 보류된다.
+ *          LPUART 하드웨어 수신(METER_RX_HW_DELIMIT) 프레임이 아니면 동작 없음.
+ */
+void Meter_ReleaseFrame(uint8_t* frame)
+{
+#ifdef METER_RX_HW_DELIMIT
+    uint8_t i;
+
+    for (i = 0; i < METER_RX_BUF_COUNT; i++)
+    {
+        if (frame == g_rx_frame[i] && g_rx_frame_state[i] == RX_BUF_HELD)
+        {
+            g_rx_frame_state[i] = RX_BUF_FREE;
+
+            // 빈 버퍼가 없어 수신이 보류된 경우 재개 (이때 RCD/RTO 인터럽트는 꺼져 있음)
+            if (g_rx_state == 2 && i == g_rx_fill)
+            {
+                Meter_RxArm();
+            }
+            return;
+        }
+    }
+#else
+    (void)frame;
+#endif
+}
+
+/**
+ * @brief 응답 콜백 프레임이 보유 중인 핑퐁 버퍼인지 확인
+ * @param frame 콜백의 data 포인터
+ * @return true: Meter_ReleaseFrame() 전까지 유지되는 버퍼 (콜백 이후 처리 가능)
+ *         false: 소프트웨어 조립 버퍼 (콜백 반환 후 다음 수신에 재사용됨)
+ */
+bool Meter_FrameIsHeld(const uint8_t* frame)
+{
+#ifdef METER_RX_HW_DELIMIT
+    uint8_t i;
+
+    for (i = 0; i < METER_RX_BUF_COUNT; i++)
+    {
+        if (frame == g_rx_frame[i])
+        {
+            return g_rx_frame_state[i] == RX_BUF_HELD;
+        }
+    }
+#else
+    (void)frame;
+#endif
+
+    return false;
+}
+
+/**
+ * @brief 응답 콜백으로 전달된 프레임의 디스크립터 조회
+ * @param frame 콜백의 data 포인터
+ * @return 디스크립터 (수신 중 누적한 체크섬 포함), 수신 프레임이 아니면 NULL
+ * @note 반환값은 프레임 버퍼 반환(Meter_ReleaseFrame) 또는 다음 조립 전까지 유효
+ */
+const METER_RX_FRAME_Type* Meter_GetFrameInfo(uint8_t* frame)
+{
+    uint8_t i;
+
+#ifdef METER_RX_HW_DELIMIT
+    for (i = 0; i < METER_RX_BUF_COUNT; i++)
+    {
+        if (frame == g_rx_frame[i])
+        {
+            return &g_rx_desc[i];
+        }
+    }
+#endif
+
+    for (i = 0; i < METER_PORT_MAX; i++)
+    {
+        if (frame == g_meter_ctx[i].rx_buffer)
+        {
+            return &g_meter_ctx[i].rx_desc;
+        }
+    }
+
+    return NULL;
+}
+
+#ifdef METER_RX_HW_DELIMIT
+/**
+ * @brief RCD 기반 프레임 시작 대기 상태로 전환
+ * @details RTO 인터럽트를 끄고 RCD(0x68)만 활성화한다.
+ *          프레임 시작 전 잡음 바이트는 인터럽트를 발생시키지 않는다.
+ *          DMA 수신 대상 버퍼가 아직 보유 중이면 Meter_ReleaseFrame()까지 보류한다.
+ */
+static void Meter_RxArm(void)
+{
+    HAL_LPUART_ConfigInterrupt(LPUART_INTCFG_RTOIEN, DISABLE);
+    HAL_LPUART_DataControlConfig(LPUART_CONTROL_RTOEN, DISABLE);
+
+    if (g_rx_frame_state[g_rx_fill] != RX_BUF_FREE)
+    {
+        g_rx_state = 2;
+        return;
+    }
+
+    g_rx_state = 0;
+
+    HAL_LPUART_ClearStatus(LPUART_STATUS_RCDIFLAG);
+    HAL_LPUART_DataControlConfig(LPUART_CONTROL_RCDEN, ENABLE);
+    HAL_LPUART_ConfigInterrupt(LPUART_INTCFG_RCDIEN, ENABLE);
+}
+
+/**
+ * @brief 진행 중인 DMA 수신 중단 후 RCD 대기로 복귀
+ */
+static void Meter_RxAbort(void)
+{
+    HAL_LPUART_ConfigInterrupt(LPUART_INTCFG_RCDIEN, DISABLE);
+    HAL_LPUART_DataControlConfig(LPUART_CONTROL_RCDEN, DISABLE);
+    HAL_DMAC_Stop((DMACn_Type*)METER_RX_DMA_CHANNEL);
+
+    if (g_rx_frame_state[g_rx_fill] == RX_BUF_FILLING)
+    {
+        g_rx_frame_state[g_rx_fill] = RX_BUF_FREE;
+    }
+
+    Meter_RxArm();
+}
+
+/**
+ * @brief LPUART 수신 인터럽트 처리 (RCD/RTO 하드웨어 프레임 구분)
+ * @param intsrc HAL_LPUART_GetStatus() 값
+ * @details RCD(0x68): 프레임 시작, 시작 바이트 저장 후 나머지는 DMA로 수신
+ *          RTO: 프레임 종료, DMA 잔여 카운트로 길이 확정 후 다음 버퍼로 재대기
+ *          프레임당 인터럽트 2회, 전달은 Meter_Task()에서 수행
+ * @note main.c의 LPUART_IRQHandler_IT()에서 호출, 플래그 클리어는 호출자가 수행
+ */
+void Meter_RxIRQHandler(uint8_t intsrc)
+{
+    METER_CONTEXT_Type* ctx = &g_meter_ctx[METER_PORT_LPUART];
+    uint8_t* buf = g_rx_frame[g_rx_fill];
+
+    if (g_rx_state == 0)
+    {
+        if (intsrc & LPUART_IFSR_RCDIFLAG_Msk)
+        {
+            // 0x68 감지: 프레임 시작 (데이터 중 0x68에 의한 재시작 방지를 위해 RCD 비활성화)
+            HAL_LPUART_ConfigInterrupt(LPUART_INTCFG_RCDIEN, DISABLE);
+            HAL_LPUART_DataControlConfig(LPUART_CONTROL_RCDEN, DISABLE);
+
+            buf[0] = HAL_LPUART_ReceiveByte();
+            g_rx_frame_state[g_rx_fill] = RX_BUF_FILLING;
+            HAL_DMAC_Setup((DMACn_Type*)METER_RX_DMA_CHANNEL, (uint32_t)&buf[1], METER_MAX_FRAME_SIZE - 1);
+
+            g_rx_state = 1;
+            g_rx_resume_state = ctx->state;
+            ctx->state = METER_STATE_RX;
+
+            HAL_LPUART_DataControlConfig(LPUART_CONTROL_RTOEN, ENABLE);
+            HAL_LPUART_ConfigInterrupt(LPUART_INTCFG_RTOIEN, ENABLE);
+        }
+        return;
+    }
+
+    if (g_rx_state == 1 && (intsrc & LPUART_IFSR_RTOIFLAG_Msk))
+    {
+        // 무수신 타임아웃: 프레임 종료 (버퍼가 가득 찬 경우 DMA는 이미 정지 상태)
+        HAL_DMAC_Stop((DMACn_Type*)METER_RX_DMA_CHANNEL);
+
+        g_rx_frame_len[g_rx_fill] = (uint16_t)(METER_MAX_FRAME_SIZE
+                                  - HAL_DMAC_GetTransferCount((DMACn_Type*)METER_RX_DMA_CHANNEL));
+        g_rx_frame_state[g_rx_fill] = RX_BUF_READY;
+
+        // 다음 버퍼로 전환 후 프레임 시작 대기
+        g_rx_fill = (uint8_t)((g_rx_fill + 1) % METER_RX_BUF_COUNT);
+        Meter_RxArm();
+    }
+}
+#endif
+
+/**
+ * @brief 바이트 수신 인터럽트 처리 (포트별 링 버퍼에 저장)
+ * @param port 계량기 포트
+ * @param byte 수신 바이트
+ * @details 프레임 조립은 Meter_Task()에서 수행한다. 링 버퍼가 가득 차면 바이트를 버리며,
+ *          조립기 재동기화로 다음 프레임을 찾는다.
+ */
+void Meter_RxByteIRQHandler(METER_PORT_Type port, uint8_t byte)
+{
+    METER_CONTEXT_Type* ctx = &g_meter_ctx[port];
+    uint8_t next = (uint8_t)((ctx->rx_ring_head + 1) % METER_RX_RING_SIZE);
+
+    if (next != ctx->rx_ring_tail)
+    {
+        ctx->rx_ring[ctx->rx_ring_head] = byte;
+        ctx->rx_ring_head = next;
+    }
+}
+
+/**
+ * @brief UART0/UART1/USART10 포트 인터럽트 처리
+ * @param port METER_PORT_UART0, METER_PORT_UART1, METER_PORT_USART10
+ * @note A31L12x_it.c의 해당 포트 인터럽트 핸들러에서 호출
+ *       (LPUART는 main.c의 LPUART_IRQHandler_IT()에서 처리)
+ */
+void Meter_PortIRQHandler(METER_PORT_Type port)
+{
+    uint8_t status;
+
+    if (port == METER_PORT_UART0 || port == METER_PORT_UART1)
+    {
+        UARTn_Type* UARTx = (port == METER_PORT_UART0) ? (UARTn_Type*)UART0 : (UARTn_Type*)UART1;
+
+        status = HAL_UART_GetLineStatus(UARTx);
+
+        // 수신 데이터 (RBR)
+        if (status & UARTn_LSR_RDR)
+        {
+            Meter_RxByteIRQHandler(port, HAL_UART_ReceiveByte(UARTx));
+        }
+
+        // 송신 버퍼 비어 있음 (THRE, 다음 바이트 쓰기로 클리어)
+        if (status & UARTn_LSR_THRE)
+        {
+            Meter_TxIRQHandler(port);
+        }
+    }
+    else if (port == METER_PORT_USART10)
+    {
+        status = HAL_USART_GetStatus((USART1n_Type*)USART10);
+
+        if (status & USART1n_SR_RXC)
+        {
+            Meter_RxByteIRQHandler(port, HAL_USART_ReceiveByte((USART1n_Type*)USART10));
+        }
+
+        if (status & USART1n_SR_TXC)
+        {
+            HAL_USART_ClearStatus((USART1n_Type*)USART10, USART1n_STATUS_TXC);
+            Meter_TxIRQHandler(port);
+        }
+    }
+}
+
+/**
+ * @brief 수신 상태 리셋
+ * @param ctx 포트 인스턴스
+ */
+static void Meter_ResetRxState(METER_CONTEXT_Type* ctx)
+{
+#ifdef METER_RX_HW_DELIMIT
+    if (Meter_PortUsesHwRx(ctx->port))
+    {
+        // RTO 완료 처리와의 경쟁 방지
+        NVIC_DisableIRQ(LPUART_IRQn);
+        Meter_RxAbort();
+        NVIC_EnableIRQ(LPUART_IRQn);
+        return;
+    }
+#endif
+
+    ctx->rx_asm.state = ASM_WAIT_START;
+    ctx->rx_ring_tail = ctx->rx_ring_head;
+}
+
+/**
+ * @brief 주기적으로 호출해야 하는 타스크 함수 (포트 스케줄러)
+ * @details 활성화된 모든 포트의 수신 프레임 전달과 응답 타임아웃/재전송을 처리한다.
+ *          각 포트는 서로를 기다리지 않으므로 여러 계량기의 1200bps 대기 시간이 겹친다.
+ */
+void Meter_Task(void)
+{
+    uint8_t port;
+
+    for (port = 0; port < METER_PORT_MAX; port++)
+    {
+        if (g_meter_ctx[port].active)
+        {
+            Meter_PortTask(&g_meter_ctx[port]);
+        }
+    }
+}
+
+/**
+ * @brief 포트 1개의 수신 처리 및 타임아웃 체크
+ * @param ctx 포트 인스턴스
+ */
+static void Meter_PortTask(METER_CONTEXT_Type* ctx)
+{
+#ifdef METER_RX_HW_DELIMIT
+    if (Meter_PortUsesHwRx(ctx->port))
+    {
+        // RTO로 완성된 프레임 전달 (수신 순서대로, 프레임당 1회)
+        while (g_rx_frame_state[g_rx_deliver] == RX_BUF_READY)
+        {
+            Meter_DeliverFrame(ctx);
+        }
+    }
+    else
+#endif
+    {
+        // 링 버퍼 수신 데이터를 조립기로 전달
+        while (ctx->rx_ring_tail != ctx->rx_ring_head)
+        {
+            uint8_t byte = ctx->rx_ring[ctx->rx_ring_tail];
+
+            ctx->rx_ring_tail = (uint8_t)((ctx->rx_ring_tail + 1) % METER_RX_RING_SIZE);
+            Meter_AsmPush(ctx, byte);
+        }
+
+        // 나머지 바이트가 오지 않는 프레임 폐기 (RX에 머물러 큐/저전력이 멈추지 않도록)
+        Meter_AsmCheckTimeout(ctx);
+    }
+
+    // 타임아웃 체크 (틱 랩어라운드에 안전한 부호 있는 차이 비교)
+    if (ctx->state == METER_STATE_WAIT_RESPONSE)
+    {
+        if ((int32_t)(Meter_GetTick() - ctx->timeout_ms) >= 0)
+        {
+            TRACE2("port %u response timeout retry %u", ctx->port, ctx->retry_count);
+            LINK_STAT_INC(ctx, timeouts);
+
+            ctx->last_error = METER_ERR_TIMEOUT;
+            ctx->state = METER_STATE_ERROR;
+
+            if (ctx->on_error != NULL)
+            {
+                ctx->on_error(ctx->port, METER_ERR_TIMEOUT);
+            }
+
+            // 재전송 시도
+            if (ctx->retry_count < ctx->max_retry && ctx->tx_length > 0)
+            {
+                uint32_t backoff;
+
+                ctx->retry_count++;
+
+                // 지수 백오프: backoff_ms, 2배, 4배, ... (상한 METER_RETRY_BACKOFF_MAX_MS)
+                backoff = (uint32_t)ctx->backoff_ms << ((ctx->retry_count - 1) & 0x0F);
+                if (backoff > METER_RETRY_BACKOFF_MAX_MS)
+                {
+                    backoff = METER_RETRY_BACKOFF_MAX_MS;
+                }
+
+                // 대기 후 마지막 전송 프레임을 다시 전송 (SysTick에서 비동기 진행)
+                ctx->phase_deadline_ms = Meter_GetTick() + backoff;
+                ctx->state = METER_STATE_BACKOFF;
+            }
+            else
+            {
+                // 최대 재전송 횟수 초과
+                ctx->state = METER_STATE_IDLE;
+                ctx->retry_count = 0;
+                Meter_CmdComplete(ctx, METER_ERR_TIMEOUT, NULL, 0);
+            }
+        }
+    }
+
+    // 응답 수신 또는 재전송 소진 즉시 다음 큐 커맨드 전송
+    Meter_CmdDispatch(ctx);
+}
+
+/**
+ * @brief 현재 상태 조회
+ */
+METER_STATE_Type Meter_GetState(METER_PORT_Type port)
+{
+    if (port >= METER_PORT_MAX)
+    {
+        return METER_STATE_IDLE;
+    }
+
+    return g_meter_ctx[port].state;
+}
+
+/**
+ * @brief 마지막 에러 조회
+ */
+METER_ERROR_Type Meter_GetLastError(METER_PORT_Type port)
+{
+    if (port >= METER_PORT_MAX)
+    {
+        return METER_ERR_INVALID_PARAM;
+    }
+
+    return g_meter_ctx[port].last_error;
+}
+
+/**
+ * @brief 링크 통계 저장 위치 지정
+ * @param stats 포트별 통계 배열 [METER_PORT_MAX] (NULL: 집계 안 함)
+ * @note 배열 내용은 초기화하지 않음 (SRAM 유지 영역의 누적 값 유지)
+ */
+void Meter_SetLinkStats(METER_LINK_STATS_Type* stats)
+{
+    g_link_stats = stats;
+}
+
+/**
+ * @brief 링크 통계 조회
+ * @return 포트 통계, 저장 위치 미지정 시 NULL
+ */
+const METER_LINK_STATS_Type* Meter_GetLinkStats(METER_PORT_Type port)
+{
+    if (g_link_stats == NULL || port >= METER_PORT_MAX)
+    {
+        return NULL;
+    }
+
+    return &g_link_stats[port];
+}
+
+/**
+ * @brief 프로토콜 리셋
+ */
+void Meter_Reset(METER_PORT_Type port)
+{
+    METER_CONTEXT_Type* ctx;
+
+    if (port >= METER_PORT_MAX)
+    {
+        return;
+    }
+
+    ctx = &g_meter_ctx[port];
+    if (!ctx->active)
     {
-        volatile uint32_t delay;
-        // 5바이트 전송 시간: 5 * 10 bits / 1200 bps = ~41.7ms
-        // 여유를 두고 50ms 대기
-        for (delay = 0; delay < METER_TX_COMPLETE_DELAY; delay++)  // 약 50ms
-        {
-            __NOP();
-        }
+        return;
     }
 
-    // RX 인터럽트 재활성화 (응답 수신 준비)
-    HAL_LPUART_ConfigInterrupt(LPUART_INTCFG_RXCIEN, ENABLE);
+    // 진행 중인 비동기 송신 중단 (FIFO 클리어 단계였다면 포트 복구)
+    Meter_PortTxInterrupt(ctx, DISABLE);
+    Meter_PortEnable(ctx, ENABLE);
 
-    // 응답 대기 상태로 전환
-    g_meter_ctx.state = METER_STATE_WAIT_RESPONSE;
-    g_meter_ctx.timeout_ms = Meter_GetTick() + METER_RESPONSE_TIMEOUT_MS;
-    g_meter_ctx.rx_index = 0;
-    g_meter_ctx.rx_length = 0;
+    ctx->state = METER_STATE_IDLE;
+    ctx->rx_index = 0;
+    ctx->rx_length = 0;
+    ctx->tx_index = 0;
+    ctx->tx_length = 0;
+    ctx->retry_count = 0;
+    ctx->last_error = METER_ERR_NONE;
 
-    return METER_ERR_NONE;
-}
+    // 대기 중인 큐 커맨드 폐기 (완료 콜백 없음)
+    memset(ctx->cmd_queue, 0, sizeof(ctx->cmd_queue));
+    ctx->cmd_active = METER_CMD_NONE;
 
-/**
- * @brief ACK 전송
- */
-METER_ERROR_Type Meter_SendACK(void)
-{
-    uint8_t ack = METER_ACK;
-    rbSend(&ack, 1);
-    return METER_ERR_NONE;
+    // 수신 상태도 리셋
+    Meter_ResetRxState(ctx);
 }
 
 /**
- * @brief NAK 전송
+ * @brief 파워다운 중 수신 시작으로 깨어날 수 있는 포트 지정
+ * @param port 포트
+ * @param enable true: 응답 대기 중에도 파워다운 허용 (포트 클럭이 파워다운에서 동작하고 WAKEN 설정됨)
+ * @note Meter_Init() 후 호출, METER_RX_HW_DELIMIT의 LPUART만 지원 (RCD 일치로 깨어남)
  */
-METER_ERROR_Type Meter_SendNAK(void)
+void Meter_SetRxWake(METER_PORT_Type port, bool enable)
 {
-    uint8_t nak = METER_NAK;
-    rbSend(&nak, 1);
-    return METER_ERR_NONE;
+    if (port >= METER_PORT_MAX)
+    {
+        return;
+    }
+
+    g_meter_ctx[port].rx_wake = enable && Meter_PortUsesHwRx(port);
 }
 
+//******************************************************************************
+// 내부 함수 구현
+//******************************************************************************
+
 /**
- * @brief 수신 데이터 처리 (0x68 트리거 기반)
- * @param data 수신 데이터
- * @param length 데이터 길이
- *
- * @details 프레임 구조: 68 L L 68 [DATA] CS 16
- *          - 0x68을 트리거로 프레임 시작 감지
- *          - L 바이트 만큼 데이터 수신
- *          - 0x16으로 프레임 종료
+ * @brief SysTick 인터럽트 핸들러에서 호출 (1ms마다)
+ * @note A31L12x_it.c의 SysTick_Handler()에서 이 함수를 호출해야 함
  */
-void Meter_ProcessReceive(uint8_t* data, uint16_t length)
+void Meter_SysTick_Increment(void)
 {
-    uint16_t i;
-
-    for (i = 0; i < length; i++)
-    {
-        uint8_t byte = data[i];
+    uint8_t port;
 
-        // 0x68 트리거 감지 (프레임 시작)
-        if (byte == METER_FRAME_START_RX && g_rx_state == 0)
-        {
-            // 프레임 시작
-            g_meter_ctx.rx_index = 0;
-            g_meter_ctx.rx_buffer[g_meter_ctx.rx_index++] = byte;
-            g_rx_state = 1;
-            g_meter_ctx.state = METER_STATE_RX;
-            continue;
-        }
+    g_systick_ms++;
 
-        // 수신 중 상태
-        if (g_rx_state > 0)
+    // 비동기 송신 단계 진행 (Preamble, FIFO 클리어, TX 안정화), 포트별 독립 진행
+    for (port = 0; port < METER_PORT_MAX; port++)
+    {
+        if (g_meter_ctx[port].active)
         {
-            // 버퍼 오버플로우 체크
-            if (g_meter_ctx.rx_index >= METER_MAX_FRAME_SIZE)
-            {
-                g_meter_ctx.last_error = METER_ERR_BUFFER_OVERFLOW;
-                g_meter_ctx.state = METER_STATE_ERROR;
-                if (g_meter_ctx.on_error != NULL)
-                {
-                    g_meter_ctx.on_error(METER_ERR_BUFFER_OVERFLOW);
-                }
-                g_rx_state = 0;  // 상태 초기화
-                g_meter_ctx.rx_index = 0;
-                return;
-            }
-
-            g_meter_ctx.rx_buffer[g_meter_ctx.rx_index++] = byte;
-
-            // 0x16 종료 바이트 감지
-            if (byte == METER_FRAME_END_RX && g_meter_ctx.rx_index > 6)
-            {
-                // 프레임 완성
-                g_meter_ctx.rx_length = g_meter_ctx.rx_index;
-                g_meter_ctx.state = METER_STATE_COMPLETE;
-
-                // 콜백 호출 (전체 프레임 전달)
-                if (g_meter_ctx.on_response_received != NULL)
-                {
-                    g_meter_ctx.on_response_received(g_meter_ctx.rx_buffer, g_meter_ctx.rx_length);
-                }
-
-                // 상태 초기화
-                g_rx_state = 0;
-                g_meter_ctx.state = METER_STATE_IDLE;
-                g_meter_ctx.rx_index = 0;
-                return;
-            }
+            Meter_TxTimerService(&g_meter_ctx[port]);
         }
     }
 }
 
 /**
- * @brief 수신 상태 리셋
+ * @brief 저전력 대기 동안 멈춘 SysTick 시간 반영
+ * @param ms SysTick을 멈춘 시간 (ms)
+ * @note 모든 포트가 유휴이거나 수신 깨움 포트가 응답 대기 중일 때만 호출되므로
+ *       송신 단계 진행(Meter_TxTimerService)은 필요 없다. 응답 기한은 다음 Meter_Task()에서 확인한다.
  */
-static void Meter_ResetRxState(void)
+void Meter_SysTick_Advance(uint32_t ms)
 {
-    g_rx_state = 0;
+    g_systick_ms += ms;
 }
 
 /**
- * @brief 주기적으로 호출해야 하는 타스크 함수
+ * @brief 저전력 대기 가능 시간 (tickless 스케줄러용)
+ * @return 0: 송신/수신/재전송 대기 중이거나 처리할 수신 데이터, 큐 커맨드가 있음 (SysTick 유지)
+ *         그 외: 수신 깨움 포트(Meter_SetRxWake)의 응답 기한까지 남은 시간 (ms)
+ *         METER_TICK_NEVER: 활성화된 모든 포트 유휴
  */
-void Meter_Task(void)
+uint32_t Meter_GetIdleMs(void)
 {
-    uint8_t rx_buf[32];
-    uint32_t len;
+    METER_CONTEXT_Type* ctx;
+    uint32_t idle = METER_TICK_NEVER;
+    uint8_t port;
 
-    // 수신 데이터 확인
-    len = rbReceive(rx_buf, sizeof(rx_buf));
-    if (len > 0)
+#ifdef METER_RX_HW_DELIMIT
+    if (g_rx_frame_state[g_rx_deliver] == RX_BUF_READY)
     {
-        Meter_ProcessReceive(rx_buf, len);
+        return 0;
     }
+#endif
 
-    // 타임아웃 체크
-    if (g_meter_ctx.state == METER_STATE_WAIT_RESPONSE)
+    for (port = 0; port < METER_PORT_MAX; port++)
     {
-        if (Meter_GetTick() >= g_meter_ctx.timeout_ms)
+        ctx = &g_meter_ctx[port];
+        if (!ctx->active)
         {
-            g_meter_ctx.last_error = METER_ERR_TIMEOUT;
-            g_meter_ctx.state = METER_STATE_ERROR;
+            continue;
+        }
+
+        if (ctx->rx_ring_tail != ctx->rx_ring_head)
+        {
+            return 0;
+        }
 
-            if (g_meter_ctx.on_error != NULL)
+        if (ctx->state == METER_STATE_IDLE)
+        {
+            if (Meter_GetQueueCount((METER_PORT_Type)port) != 0)
             {
-                g_meter_ctx.on_error(METER_ERR_TIMEOUT);
+                return 0;
             }
+        }
+#ifdef METER_RX_HW_DELIMIT
+        else if (ctx->state == METER_STATE_WAIT_RESPONSE && ctx->rx_wake && g_rx_state == 0)
+        {
+            // RCD가 대기 중이면 수신 시작이 깨우므로 응답 기한까지 SysTick 불필요
+            int32_t left;
 
-            // 재전송 시도
-            if (g_meter_ctx.retry_count < METER_MAX_RETRY)
+            left = (int32_t)(ctx->timeout_ms - g_systick_ms);
+            if (left <= 0)
             {
-                g_meter_ctx.retry_count++;
-                g_meter_ctx.state = METER_STATE_IDLE;
-
-                // 재전송 로직: 마지막 전송 프레임을 다시 전송
-                if (g_meter_ctx.tx_length > 0)
-                {
-                    // Preamble 전송
-                    Meter_SendPreamble();
-
-                    // FIFO 클리어
-                    HAL_LPUART_ConfigInterrupt(LPUART_INTCFG_TXCIEN, DISABLE);
-                    HAL_LPUART_Enable(DISABLE);
-                    {
-                        volatile uint32_t delay;
-                        for (delay = 0; delay < METER_FIFO_CLEAR_DELAY; delay++) { __NOP(); }
-                    }
-                    HAL_LPUART_Enable(ENABLE);
-
-                    // 재전송
-                    g_meter_ctx.state = METER_STATE_TX;
-                    HAL_LPUART_Transmit(g_meter_ctx.tx_buffer, g_meter_ctx.tx_length, BLOCKING);
-
-                    // 전송 완료 대기
-                    {
-                        volatile uint32_t delay;
-                        for (delay = 0; delay < METER_TX_COMPLETE_DELAY; delay++) { __NOP(); }
-                    }
-
-                    // 응답 대기 상태로 전환
-                    g_meter_ctx.state = METER_STATE_WAIT_RESPONSE;
-                    g_meter_ctx.timeout_ms = Meter_GetTick() + METER_RESPONSE_TIMEOUT_MS;
-                    HAL_LPUART_ConfigInterrupt(LPUART_INTCFG_RXCIEN, ENABLE);
-                }
+                return 0;
             }
-            else
+            if ((uint32_t)left < idle)
             {
-                // 최대 재전송 횟수 초과
-                g_meter_ctx.state = METER_STATE_IDLE;
-                g_meter_ctx.retry_count = 0;
+                idle = (uint32_t)left;
             }
         }
+#endif
+        else
+        {
+            return 0;
+        }
     }
+
+    return idle;
 }
 
 /**
- * @brief 현재 상태 조회
+ * @brief LPUART 하드웨어 프레임 수신(RCD/DMA/RTO) 사용 여부
  */
-METER_STATE_Type Meter_GetState(void)
+static bool Meter_PortUsesHwRx(METER_PORT_Type port)
 {
-    return g_meter_ctx.state;
+#ifdef METER_RX_HW_DELIMIT
+    return (port == METER_PORT_LPUART);
+#else
+    (void)port;
+    return false;
+#endif
 }
 
 /**
- * @brief 마지막 에러 조회
+ * @brief 포트 활성화/비활성화 (TX FIFO 클리어용)
+ * @note UART0/1은 활성화 비트가 없으므로 동작 없음
  */
-METER_ERROR_Type Meter_GetLastError(void)
+static void Meter_PortEnable(METER_CONTEXT_Type* ctx, FunctionalState NewState)
 {
-    return g_meter_ctx.last_error;
+    switch (ctx->port)
+    {
+        case METER_PORT_LPUART:
+            HAL_LPUART_Enable(NewState);
+            break;
+
+        case METER_PORT_USART10:
+            HAL_USART_Enable((USART1n_Type*)USART10, NewState);
+            break;
+
+        default:
+            break;
+    }
 }
 
 /**
- * @brief 프로토콜 리셋
+ * @brief 포트 송신 인터럽트 설정 (LPUART/USART10: TXC, UART0/1: THRE)
  */
-void Meter_Reset(void)
+static void Meter_PortTxInterrupt(METER_CONTEXT_Type* ctx, FunctionalState NewState)
 {
-    g_meter_ctx.state = METER_STATE_IDLE;
-    g_meter_ctx.rx_index = 0;
-    g_meter_ctx.rx_length = 0;
-    g_meter_ctx.tx_index = 0;
-    g_meter_ctx.tx_length = 0;
-    g_meter_ctx.retry_count = 0;
-    g_meter_ctx.last_error = METER_ERR_NONE;
+    switch (ctx->port)
+    {
+        case METER_PORT_LPUART:
+            HAL_LPUART_ConfigInterrupt(LPUART_INTCFG_TXCIEN, NewState);
+            break;
 
-    // 수신 상태도 리셋
-    Meter_ResetRxState();
+        case METER_PORT_UART0:
+            HAL_UART_ConfigInterrupt((UARTn_Type*)UART0, UARTn_INTCFG_THRE, NewState);
+            break;
+
+        case METER_PORT_UART1:
+            HAL_UART_ConfigInterrupt((UARTn_Type*)UART1, UARTn_INTCFG_THRE, NewState);
+            break;
+
+        case METER_PORT_USART10:
+            HAL_USART_ConfigInterrupt((USART1n_Type*)USART10, USART1n_INTCFG_TXC, NewState);
+            break;
+
+        default:
+            break;
+    }
 }
 
 /**
- * @brief 수신 상태 리셋 (내부 함수)
+ * @brief 포트 수신 인터럽트 설정 (LPUART/USART10: RXC, UART0/1: RBR)
  */
-static void Meter_ResetRxState(void);  // Forward declaration
+static void Meter_PortRxInterrupt(METER_CONTEXT_Type* ctx, FunctionalState NewState)
+{
+    switch (ctx->port)
+    {
+        case METER_PORT_LPUART:
+            HAL_LPUART_ConfigInterrupt(LPUART_INTCFG_RXCIEN, NewState);
+            break;
 
-//******************************************************************************
-// 내부 함수 구현
-//******************************************************************************
+        case METER_PORT_UART0:
+            HAL_UART_ConfigInterrupt((UARTn_Type*)UART0, UARTn_INTCFG_RBR, NewState);
+            break;
 
-// SysTick 기반 밀리초 카운터 (전역 변수)
-static volatile uint32_t g_systick_ms = 0;
+        case METER_PORT_UART1:
+            HAL_UART_ConfigInterrupt((UARTn_Type*)UART1, UARTn_INTCFG_RBR, NewState);
+            break;
+
+        case METER_PORT_USART10:
+            HAL_USART_ConfigInterrupt((USART1n_Type*)USART10, USART1n_INTCFG_RXC, NewState);
+            break;
+
+        default:
+            break;
+    }
+}
 
 /**
- * @brief SysTick 인터럽트 핸들러에서 호출 (1ms마다)
- * @note A31L12x_it.c의 SysTick_Handler()에서 이 함수를 호출해야 함
+ * @brief 포트로 1바이트 송신
  */
-void Meter_SysTick_Increment(void)
+static void Meter_PortTransmitByte(METER_CONTEXT_Type* ctx, uint8_t byte)
 {
-    g_systick_ms++;
+    switch (ctx->port)
+    {
+        case METER_PORT_LPUART:
+            HAL_LPUART_TransmitByte(byte);
+            break;
+
+        case METER_PORT_UART0:
+            HAL_UART_TransmitByte((UARTn_Type*)UART0, byte);
+            break;
+
+        case METER_PORT_UART1:
+            HAL_UART_TransmitByte((UARTn_Type*)UART1, byte);
+            break;
+
+        case METER_PORT_USART10:
+            HAL_USART_TransmitByte((USART1n_Type*)USART10, byte);
+            break;
+
+        default:
+            break;
+    }
 }
 
 /**
- * @brief 시스템 틱 가져오기 (밀리초 단위)
- * @return 시스템 시작 후 경과 시간 (ms)
+ * @brief 첫 바이트 송신 전 송신 완료 플래그 클리어
+ * @note UART0/1의 THRE는 상태 비트이므로 클리어 불필요
  */
-static uint32_t Meter_GetTick(void)
+static void Meter_PortClearTxFlag(METER_CONTEXT_Type* ctx)
 {
-    return g_systick_ms;
-}
+    switch (ctx->port)
+    {
+        case METER_PORT_LPUART:
+            HAL_LPUART_ClearStatus(LPUART_STATUS_TXCIFLAG);
+            break;
 
-//******************************************************************************
-// 범용 프로토콜 파서 구현 (V1.1~V1.4 지원)
-//******************************************************************************
+        case METER_PORT_USART10:
+            HAL_USART_ClearStatus((USART1n_Type*)USART10, USART1n_STATUS_TXC);
+            break;
+
+        default:
+            break;
+    }
+}
 
 /**
- * @brief 프로토콜 버전 자동 감지 (하이브리드 방식)
- * @param frame 원본 프레임 (68 L L 68 C A CI [UserData] CS 16)
- * @param length 프레임 길이
- * @return 감지된 프로토콜 버전
- *
- * @details 감지 알고리즘:
- *   1단계: L Field 확인 (프레임 유효성 검증)
- *   2단계: UserData 길이 계산
- *   3단계: UDF 유무 확인
- *   4단계: UDF 프로토콜 버전 필드 확인
- *   5단계: Status2 존재 확인 (V1.4 특징)
+ * @brief 비동기 전송 시작 (PREAMBLE 단계 진입)
+ * @param ctx 포트 인스턴스
+ * @details tx_buffer/tx_length에 준비된 프레임을 전송한다.
+ *          PREAMBLE(20ms, TX Idle High) → TX(FIFO 클리어 → 안정화 → 바이트 송신)
+ *          → WAIT_RESPONSE 순으로 인터럽트에서 진행되며, 그동안 CPU는 대기(Sleep) 가능
  */
-ProtocolVersion_t Meter_DetectVersion(uint8_t* frame, uint16_t length)
+static void Meter_StartTransfer(METER_CONTEXT_Type* ctx)
 {
-    // 최소 프레임 길이 검증
-    // 68 L L 68 C A CI [최소 UserData] CS 16
-    //  0 1 2  3 4 5  6       ...        -2 -1
-    if (length < 12)  // 최소: 6(헤더) + 최소UserData(4) + 2(CS+END)
-    {
-        return PROTOCOL_UNKNOWN;
-    }
+    Meter_PortTxInterrupt(ctx, DISABLE);
+
+    ctx->tx_index = 0;
+    ctx->tx_step = TX_STEP_FIFO_CLEAR;
+    ctx->rx_index = 0;
+    ctx->rx_length = 0;
+    ctx->phase_deadline_ms = Meter_GetTick() + METER_PREAMBLE_TIME_MS;
 
-    // 프레임 시작/종료 바이트 확인
-    if (frame[0] != 0x68 || frame[3] != 0x68 || frame[length - 1] != 0x16)
+    TRACE3("port %u tx cmd 0x%02X try %u", ctx->port, ctx->tx_buffer[1], ctx->retry_count);
+    LINK_STAT_INC(ctx, tx_frames);
+    if (ctx->retry_count != 0)
     {
-        return PROTOCOL_UNKNOWN;
+        LINK_STAT_INC(ctx, retries);
     }
 
-    // L Field 추출
-    uint8_t L = frame[1];
+    // 마감 시각을 먼저 기록한 후 상태 전환 (SysTick 인터럽트와의 경쟁 방지)
+    ctx->state = METER_STATE_PREAMBLE;
+}
+
+/**
+ * @brief 송신 단계 타이머 처리 (SysTick 인터럽트, 1ms마다)
+ * @param ctx 포트 인스턴스
+ * @details BACKOFF 만료 시 재전송을 시작한다.
+ *          PREAMBLE 만료 시 포트를 비활성화하여 TX FIFO를 클리어하고,
+ *          METER_FIFO_CLEAR_MS 후 재활성화, METER_TX_STABILIZE_MS 후 첫 바이트를 송신한다.
+ *          나머지 바이트는 Meter_TxIRQHandler()가 TX 인터럽트마다 송신한다.
+ *          기한은 부호 있는 차이로 비교한다 (49.7일 틱 랩어라운드, 파워다운 후 틱 건너뜀).
+ */
+static void Meter_TxTimerService(METER_CONTEXT_Type* ctx)
+{
+    uint32_t now = g_systick_ms;
 
-    // L Field 일치성 확인
-    if (L != frame[2])
+    if (ctx->state == METER_STATE_BACKOFF)
     {
-        return PROTOCOL_UNKNOWN;
+        if ((int32_t)(now - ctx->phase_deadline_ms) >= 0)
+        {
+            // 재전송 대기 종료: Preamble부터 다시 전송
+            Meter_StartTransfer(ctx);
+        }
     }
-
-    // L Field 범위 확인
-    if (L < 0x0B || L > 0xFC)  // L = C + A + CI + UserData
+    else if (ctx->state == METER_STATE_PREAMBLE)
     {
-        return PROTOCOL_UNKNOWN;
+        if ((int32_t)(now - ctx->phase_deadline_ms) >= 0)
+        {
+            // Preamble 종료: 포트 비활성화로 TX FIFO 클리어
+            Meter_PortEnable(ctx, DISABLE);
+            ctx->tx_step = TX_STEP_FIFO_CLEAR;
+            ctx->phase_deadline_ms = now + METER_FIFO_CLEAR_MS;
+            ctx->state = METER_STATE_TX;
+        }
     }
+    else if (ctx->state == METER_STATE_TX && ctx->tx_index == 0)
+    {
+        if ((int32_t)(now - ctx->phase_deadline_ms) >= 0)
+        {
+            if (ctx->tx_step == TX_STEP_FIFO_CLEAR)
+            {
+                // FIFO 클리어 완료: 재활성화 후 안정화 대기 (첫 바이트 손실 방지)
+                Meter_PortEnable(ctx, ENABLE);
+                ctx->tx_step = TX_STEP_STABILIZE;
+                ctx->phase_deadline_ms = now + METER_TX_STABILIZE_MS;
+            }
+            else
+            {
+                // 첫 바이트 송신, 이후 바이트는 TX 인터럽트에서 연속 송신
+                // (계량기가 프레임을 인식하려면 바이트 간 간격 없이 전송해야 함)
+                Meter_PortClearTxFlag(ctx);
+                Meter_PortTransmitByte(ctx, ctx->tx_buffer[ctx->tx_index++]);
+                Meter_PortTxInterrupt(ctx, ENABLE);
+            }
+        }
+    }
+}
 
-    // UserData 길이 계산
-    // L = C(1) + A(1) + CI(1) + UserData(n)
-    // UserData = L - 3
-    uint8_t userdata_len = L - 3;
-
-    // UserData 포인터
-    uint8_t* userdata = &frame[7];  // CI Field 다음부터 UserData
+/**
+ * @brief 포트 TX 인터럽트 처리 (비동기 송신 엔진)
+ * @param port 계량기 포트
+ * @return 1: 계량기 프레임 송신 중이라 처리함, 0: 송신 엔진 미사용 (ring buffer 송신에서 처리)
+ * @note main.c의 LPUART_IRQHandler_IT() 또는 Meter_PortIRQHandler()에서 TX 인터럽트 발생 시 호출
+ */
+uint8_t Meter_TxIRQHandler(METER_PORT_Type port)
+{
+    METER_CONTEXT_Type* ctx = &g_meter_ctx[port];
 
-    // 기본 UserData 구조:
-    // MDH(1) + ID(4) + Status(1) + DIF(1) + VIF(1) + Data(4) = 12 bytes (최소)
+    if (ctx->state != METER_STATE_TX || ctx->tx_index == 0)
+    {
+        return 0;
+    }
 
-    if (userdata_len < 12)
+    // 다음 바이트 송신
+    if (ctx->tx_index < ctx->tx_length)
     {
-        return PROTOCOL_UNKNOWN;  // 최소 길이 미달
+        Meter_PortTransmitByte(ctx, ctx->tx_buffer[ctx->tx_index++]);
+        return 1;
     }
 
-    // ========================================
-    // 1단계: UDF 유무 확인
-    // ========================================
-    // V1.1: UserData = 12 bytes (UDF 없음)
-    // V1.2+: UserData >= 12 bytes (UDF 포함 가능)
+    // 마지막 바이트 송신 완료: 응답 대기 상태로 전환
+    // (수신 인터럽트는 Meter_Init()에서 활성화되어 유지됨)
+    Meter_PortTxInterrupt(ctx, DISABLE);
 
-    if (userdata_len == 12)
-    {
-        // UDF 없음 → V1.1 가능성 높음
-        // 추가 검증: Status Bit 1 확인 (V1.1은 동파경고 사용)
-        uint8_t status = userdata[5];  // MDH(1) + ID(4) + Status(1)
+    ctx->timeout_ms = g_systick_ms + ctx->response_timeout_ms;
+    ctx->state = METER_STATE_WAIT_RESPONSE;
 
-        // V1.1 특징: Bit 1이 동파경고로 사용될 가능성
-        // V1.2+: Bit 1은 reserved (0)
-        // 하지만 확정 불가하므로 V1.1로 판단
-        return PROTOCOL_V1_1;
-    }
+    return 1;
+}
 
-    // ========================================
-    // 2단계: UDF 프로토콜 버전 확인
-    // ========================================
-    // UDF 시작 위치: MDH(1) + ID(4) + Status(1) + DIF(1) + VIF(1) + Data(4) = 12
-    uint8_t udf_offset = 12;
+/**
+ * @brief 시스템 틱 가져오기 (밀리초 단위)
+ * @return 시스템 시작 후 경과 시간 (ms)
+ */
+static uint32_t Meter_GetTick(void)
+{
+    return g_systick_ms;
+}
 
-    if (userdata_len >= udf_offset + 4)  // UDF 최소 4바이트 (Pro Ver + Ver Mo + Man Code)
-    {
-        // UDF[0]: Protocol Version
-        uint8_t proto_ver = userdata[udf_offset];
+/**
+ * @brief 시스템 틱 조회 (트레이스 타임스탬프 등 외부 모듈용)
+ * @return 시스템 시작 후 경과 시간 (ms)
+ */
+uint32_t Meter_GetTickMs(void)
+{
+    return g_systick_ms;
+}
 
-        if (proto_ver == 0x12)
-        {
-            return PROTOCOL_V1_2;
-        }
-        else if (proto_ver == 0x13)
-        {
-            return PROTOCOL_V1_3;
-        }
-        else if (proto_ver == 0x14)
-        {
-            return PROTOCOL_V1_4;
-        }
-    }
+//******************************************************************************
+// 범용 프로토콜 파서 구현 (V1.1~V1.4 지원)
+//******************************************************************************
 
-    // ========================================
-    // 3단계: Status2 존재 확인 (V1.4 특징)
-    // ========================================
-    // V1.4: VIF 위치에 S2&VIF 결합
-    // S2&VIF의 Bit 7~6이 Status2 (자석감지, 동파경보)
-    // VIF만 있는 경우: Bit 7~4는 단위, Bit 3~0은 소수점
-    //   → 단위=1(m³)이므로 Bit 7~4 = 0001 → 상위 비트는 0
+// 4바이트 BCD → 32비트 워드 (바이트 로드, 비정렬 주소 허용)
+#define BCD_LOAD_LE(b)  ((uint32_t)(b)[0] | ((uint32_t)(b)[1] << 8) | ((uint32_t)(b)[2] << 16) | ((uint32_t)(b)[3] << 24))
+#define BCD_LOAD_BE(b)  ((uint32_t)(b)[3] | ((uint32_t)(b)[2] << 8) | ((uint32_t)(b)[1] << 16) | ((uint32_t)(b)[0] << 24))
 
-    uint8_t vif_byte = userdata[7];  // VIF 또는 S2&VIF
+// 니블 > 9 ⇔ Bit 3 = 1 이고 (Bit 2 또는 Bit 1) = 1, 8개 니블 동시 검사
+#define BCD_INVALID(w)  ((((w) & (((w) << 1) | ((w) << 2))) & 0x88888888UL) != 0)
 
-    // V1.4 판단: Bit 7 또는 Bit 6이 1인 경우 (자석감지/동파경보 가능)
-    if ((vif_byte & 0xC0) != 0)
-    {
-        // Status2가 포함된 것으로 추정 → V1.4
-        return PROTOCOL_V1_4;
-    }
+/**
+ * @brief 검증된 8자리 BCD 워드를 정수로 변환 (SWAR, 나눗셈 없음)
+ * @param w BCD 워드 (최상위 니블이 최상위 자리)
+ * @return 변환된 정수 (0~99999999)
+ *
+ * @details 2자리 → 4자리 → 8자리 순서로 상위 부분에 (16-10), (256-100),
+ *   (65536-10000)을 곱해 빼서 자리 가중치를 보정한다.
+ */
+static uint32_t Meter_BCD_Combine(uint32_t w)
+{
+    w -= ((w >> 4) & 0x0F0F0F0FUL) * 6;         // 바이트마다 0~99
+    w -= ((w >> 8) & 0x00FF00FFUL) * 156;       // 하프워드마다 0~9999
+    w -= (w >> 16) * 55536;                     // 0~99999999
+
+    return w;
+}
 
-    // ========================================
-    // 4단계: 기본값
-    // ========================================
-    // UDF가 있지만 버전 정보가 명확하지 않은 경우
-    // V1.2로 간주 (가장 일반적)
-    return PROTOCOL_V1_2;
+/**
+ * @brief 8자리 BCD 워드를 정수로 변환
+ * @param w BCD 워드
+ * @return 변환된 정수, 잘못된 BCD이면 0
+ */
+static uint32_t Meter_BCD_DecodeWord(uint32_t w)
+{
+    return BCD_INVALID(w) ? 0 : Meter_BCD_Combine(w);
 }
 
 /**
  * @brief BCD 4바이트를 uint32로 변환
  * @param bcd BCD 배열 [4] (Little Endian)
- * @return 변환된 정수
+ * @return 변환된 정수, 잘못된 BCD이면 0
  *
  * @example
  *   BCD: {0x78, 0x56, 0x34, 0x12}
@@ -627,26 +1897,76 @@ ProtocolVersion_t Meter_DetectVersion(uint8_t* frame, uint16_t length)
  */
 uint32_t Meter_BCD_To_Uint32(uint8_t bcd[4])
 {
-    uint32_t result = 0;
-    uint8_t i;
+    return Meter_BCD_DecodeWord(BCD_LOAD_LE(bcd));
+}
+
+/**
+ * @brief BCD 4바이트를 uint32로 변환 (Big Endian, 기물번호)
+ * @param bcd BCD 배열 [4] (bcd[0]이 최상위 자리)
+ * @return 변환된 정수, 잘못된 BCD이면 0
+ */
+uint32_t Meter_BCD_To_Uint32_BE(const uint8_t bcd[4])
+{
+    return Meter_BCD_DecodeWord(BCD_LOAD_BE(bcd));
+}
+
+/**
+ * @brief 연속된 BCD 4바이트 배열 일괄 변환 (이력 검침값)
+ * @param bcd BCD 배열 (count x 4바이트, 각 항목 Little Endian)
+ * @param out 변환 결과 [count]
+ * @param count 항목 수
+ * @return 잘못된 BCD 항목 수 (해당 항목은 0으로 저장)
+ */
+uint16_t Meter_BCD_To_Uint32_Batch(const uint8_t* bcd, uint32_t* out, uint16_t count)
+{
+    uint16_t invalid = 0;
 
-    // Little Endian: bcd[3] bcd[2] bcd[1] bcd[0]
-    for (i = 0; i < 4; i++)
+    while (count-- > 0)
     {
-        uint8_t byte_val = bcd[3 - i];  // 역순으로 읽기
-        uint8_t high_nibble = (byte_val >> 4) & 0x0F;
-        uint8_t low_nibble = byte_val & 0x0F;
+        uint32_t w = BCD_LOAD_LE(bcd);
 
-        // BCD 유효성 검사
-        if (high_nibble > 9 || low_nibble > 9)
+        if (BCD_INVALID(w))
+        {
+            *out = 0;
+            invalid++;
+        }
+        else
         {
-            return 0;  // 잘못된 BCD
+            *out = Meter_BCD_Combine(w);
         }
 
-        result = result * 100 + (high_nibble * 10 + low_nibble);
+        out++;
+        bcd += 4;
+    }
+
+    return invalid;
+}
+
+/**
+ * @brief BCD 검침값을 정수부/소수부로 분리 (나눗셈 없음)
+ * @param bcd BCD 배열 [4] (Little Endian)
+ * @param decimal_point 소수점 자리수 (0~7)
+ * @param frac 소수부 (출력)
+ * @return 정수부, 잘못된 BCD이면 0 (소수부도 0)
+ *
+ * @details 소수점 위치가 니블 경계이므로 /10^n, %10^n 대신 BCD 워드를 시프트/마스크한다.
+ *   예: {0x78, 0x56, 0x34, 0x12}, 3 → 12345, frac = 678
+ */
+uint32_t Meter_BCD_Split(const uint8_t bcd[4], uint8_t decimal_point, uint32_t* frac)
+{
+    uint32_t w = BCD_LOAD_LE(bcd);
+    uint8_t shift;
+
+    if (BCD_INVALID(w))
+    {
+        *frac = 0;
+        return 0;
     }
 
-    return result;
+    shift = (decimal_point <= 7) ? (decimal_point * 4) : 0;
+    *frac = Meter_BCD_Combine(w & ((1UL << shift) - 1));
+
+    return Meter_BCD_Combine(w >> shift);
 }
 
 /**
@@ -715,7 +2035,7 @@ uint16_t Meter_GetDiameter(uint8_t dif_code)
         300   // C
     };
 
-    if (code >= sizeof(diameter_table))
+    if (code >= sizeof(diameter_table) / sizeof(diameter_table[0]))
     {
         return 0;  // 잘못된 코드
     }
@@ -754,23 +2074,11 @@ void Meter_PrintParsedData(MeterData_t* data)
 
     // 프로토콜 버전
     _DBG("[VERSION] ");
-    switch (data->version)
     {
-        case PROTOCOL_V1_1:
-            _DBG("V1.1 (2013.06)\r\n");
-            break;
-        case PROTOCOL_V1_2:
-            _DBG("V1.2 (2021.05)\r\n");
-            break;
-        case PROTOCOL_V1_3:
-            _DBG("V1.3 (2023.01)\r\n");
-            break;
-        case PROTOCOL_V1_4:
-            _DBG("V1.4 (2024.07)\r\n");
-            break;
-        default:
-            _DBG("Unknown\r\n");
-            break;
+        const MeterVersionDesc_t* desc = Meter_GetVersionDesc(data->version);
+
+        _DBG((desc != NULL) ? desc->name : "Unknown");
+        _DBG("\r\n");
     }
 
     // 체크섬 검증
@@ -832,19 +2140,12 @@ void Meter_PrintParsedData(MeterData_t* data)
 
     // 실제 검침값 계산 및 출력 (소수점 적용)
     _DBG("[ACTUAL VALUE] ");
-    if (data->decimal_point == 2)
-    {
-        // 소수점 2자리 (예: 12345.67)
-        uint32_t integer_part = data->reading_value / 100;
-        uint32_t decimal_part = data->reading_value % 100;
-        cprintf("%lu.%02lu m3\r\n", integer_part, decimal_part);
-    }
-    else if (data->decimal_point == 3)
+    if (data->decimal_point == 2 || data->decimal_point == 3)
     {
-        // 소수점 3자리 (예: 12345.678)
-        uint32_t integer_part = data->reading_value / 1000;
-        uint32_t decimal_part = data->reading_value % 1000;
-        cprintf("%lu.%03lu m3\r\n", integer_part, decimal_part);
+        // 소수점 2자리 (예: 12345.67), 3자리 (예: 12345.678)
+        uint32_t decimal_part;
+        uint32_t integer_part = Meter_BCD_Split(data->reading_bcd, data->decimal_point, &decimal_part);
+        cprintf((data->decimal_point == 2) ? "%lu.%02lu m3\r\n" : "%lu.%03lu m3\r\n", integer_part, decimal_part);
     }
     else
     {
@@ -66,19 +66,68 @@ extern "C" {
 #define METER_RESPONSE_TIMEOUT_MS   1000        // 응답 대기 시간
 #define METER_BYTE_TIMEOUT_MS       100         // 바이트간 타임아웃
 
+// 저전력 대기 가능 시간 조회 결과 (Meter_GetIdleMs 등): 기한 없음
+#define METER_TICK_NEVER            0xFFFFFFFFUL
+
 // 재전송
 #define METER_MAX_RETRY             3           // 최대 재전송 횟수
+#define METER_RETRY_BACKOFF_MS      100         // 첫 재전송 전 대기 시간 (재전송마다 2배)
+#define METER_RETRY_BACKOFF_MAX_MS  4000        // 재전송 대기 시간 상한
+
+// 커맨드 큐 (포트별)
+#define METER_CMD_QUEUE_SIZE        4           // 포트당 대기 커맨드 수
+#define METER_CMD_DATA_MAX          16          // 큐 커맨드 데이터 최대 길이
+
+// 수신 프레임 구분 방식
+//   정의: LPUART RCD(0x68 시작 문자 감지) + DMA 수신 + RTO(수신 타임아웃)로 하드웨어 프레임 구분
+//         → 0x68 이전 바이트는 인터럽트 없이 무시, 바이트 단위 인터럽트 없음
+//         → 핑퐁 프레임 버퍼를 복사 없이 콜백에 전달, Meter_ReleaseFrame()으로 반환
+//   미정의: 바이트 단위 소프트웨어 검색 (RXC 인터럽트 → 포트 링 버퍼 → Meter_Task)
+//   UART0/1, USART10 포트는 항상 바이트 단위 소프트웨어 검색 사용
+#define METER_RX_HW_DELIMIT
+
+#define METER_RX_TIMEOUT_BITS       30          // RTO: 3문자 시간 무수신 시 프레임 종료 (~25ms @1200bps)
+#define METER_RX_DMA_CHANNEL        DMAC0       // LPUART RX DMA 채널 (PERSEL_LPUARTRx)
+#define METER_RX_BUF_COUNT          2           // 핑퐁 프레임 버퍼 수
+#define METER_RX_RING_SIZE          32          // 포트별 바이트 수신 링 버퍼 (UART0/1, USART10, 미정의 시 LPUART)
+
+// 응답 대기 중 파워다운 (METER_RX_HW_DELIMIT 필요)
+//   정의: LPUART를 XSOSC(32.768kHz)로 구동하고 WAKEN을 켜서, 커맨드 송신 후 응답 대기 동안에도
+//         코어/HIRC를 끄고 파워다운 → 0x68 시작 문자(RCD 일치)로 깨어나 DMA로 수신, 끝나면 다시 파워다운
+//         (0x68이 아닌 잡음 문자는 깨우지 않음, 응답 타임아웃은 깨움 타이머가 기한으로 처리)
+//   미정의: 응답 대기 동안 sleep 모드 (SysTick 1ms 인터럽트 유지)
+//   보드에 32.768kHz 크리스탈(PE0/PE1) 필요 (SystemClock_Config가 XSOSC를 켜 둠)
+//   XSOSC가 발진하지 않으면 LPUART_Configure가 PCLK로 대체하고 sleep 모드로 대기 (미정의와 같음)
+#define METER_LPUART_WAKE
+
+#if defined(METER_LPUART_WAKE) && !defined(METER_RX_HW_DELIMIT)
+#error "METER_LPUART_WAKE requires METER_RX_HW_DELIMIT (wake-up on RCD match)"
+#endif
+
+#define METER_LPUART_XSOSC_HZ       32768UL     // LPUART 클럭 (OVRS 1배: BDR 26 → 27클럭/비트, 1213.6bps +1.1%)
+#define METER_LPUART_XSOSC_BCMP     0x0092      // BCMP1/4/7 +1클럭: 문자당 평균 27.33클럭/비트 (이상값 27.31)
+#define METER_LPUART_XSOSC_WAIT_MS  2000        // XSOSC 발진 확인 최대 대기 (LPUART 설정 전, 넘으면 PCLK로 대체)
+#define METER_LPUART_XSOSC_SETTLE_MS 100        // 클럭 모니터 준비(MONFLAG)가 이만큼 연속 유지되면 발진으로 판정
 
 // 딜레이 상수 (meter_protocol.c 내부 사용)
-#define METER_PREAMBLE_DELAY_CYCLES 160000      // Preamble 20ms (32MHz 기준)
-#define METER_TX_STABILIZE_DELAY    5000        // LPUART TX 안정화 딜레이
-#define METER_FIFO_CLEAR_DELAY      1000        // FIFO 클리어 딜레이
-#define METER_TX_COMPLETE_DELAY     400000      // TX 완료 대기 (~50ms)
+#define METER_PREAMBLE_DELAY_CYCLES 160000      // Preamble 20ms (32MHz 기준, Meter_SendPreamble 전용)
+#define METER_FIFO_CLEAR_MS         1           // FIFO 클리어 (포트 비활성) 유지 시간
+#define METER_TX_STABILIZE_MS       1           // 포트 재활성화 후 TX 안정화 시간
 
 //******************************************************************************
 // 타입 정의
 //******************************************************************************
 
+// 계량기 연결 포트 (포트별 독립 프로토콜 인스턴스)
+typedef enum
+{
+    METER_PORT_LPUART = 0,          // LPUART (RCD/RTO/DMA 하드웨어 수신 가능)
+    METER_PORT_UART0,               // UART0
+    METER_PORT_UART1,               // UART1 (예제에서는 디버그 포트로 사용)
+    METER_PORT_USART10,             // USART10 (UART 모드)
+    METER_PORT_MAX
+} METER_PORT_Type;
+
 // 프로토콜 상태
 typedef enum
 {
@@ -88,7 +137,8 @@ typedef enum
     METER_STATE_WAIT_RESPONSE,      // 응답 대기 중
     METER_STATE_RX,                 // 데이터 수신 중
     METER_STATE_COMPLETE,           // 완료
-    METER_STATE_ERROR               // 오류
+    METER_STATE_ERROR,              // 오류
+    METER_STATE_BACKOFF             // 재전송 대기 중 (지수 백오프)
 } METER_STATE_Type;
 
 // 프레임 타입
@@ -123,59 +173,174 @@ typedef struct
     uint8_t     checksum;           // 체크섬 (XOR)
 } METER_FRAME_Type;
 
-// 프로토콜 컨텍스트
+// 수신 프레임 디스크립터 (68 L L 68 [C A CI DATA] CS 16)
+// 수신 경로에서 체크섬을 누적하여 작성, 파서는 CS 1바이트 비교만 수행
+typedef struct
+{
+    uint8_t*    frame;              // 프레임 시작 (0x68)
+    uint16_t    length;             // 프레임 길이 (L + 6)
+    uint8_t     sum;                // C + A + CI + UserData 누적 합 (M-Bus 체크섬)
+    uint8_t     xor_sum;            // 동일 범위 누적 XOR
+    uint8_t     checksum_received;  // 수신한 CS
+    bool        checksum_valid;     // sum == CS
+} METER_RX_FRAME_Type;
+
+// 커맨드 우선순위 (값이 작을수록 먼저 전송)
+typedef enum
+{
+    METER_PRIO_HIGH = 0,            // 시간 설정 등 제어 커맨드
+    METER_PRIO_NORMAL,              // 현재값/상태 검침
+    METER_PRIO_LOW                  // 이력 데이터 등 대용량 검침
+} METER_PRIO_Type;
+
+// 커맨드별 전송 정책
+typedef struct
+{
+    uint8_t             cmd;                // 커맨드 코드
+    uint8_t             priority;           // METER_PRIO_Type
+    uint16_t            timeout_ms;         // 응답 대기 시간
+    uint8_t             max_retry;          // 최대 재전송 횟수
+    uint16_t            backoff_ms;         // 첫 재전송 전 대기 시간 (재전송마다 2배, METER_RETRY_BACKOFF_MAX_MS 상한)
+} METER_CMD_POLICY_Type;
+
+// 커맨드 완료 콜백 (result: METER_ERR_NONE 응답 수신, METER_ERR_TIMEOUT 재전송 소진)
+// data/length는 응답 프레임 (타임아웃 시 NULL/0), 콜백 안에서만 유효
+typedef void (*METER_CMD_DONE_Type)(METER_PORT_Type port, uint8_t cmd, METER_ERROR_Type result, uint8_t* data, uint16_t length);
+
+// 커맨드 큐 항목
 typedef struct
 {
-    METER_STATE_Type    state;              // 현재 상태
+    bool                used;               // 사용 중
+    uint8_t             seq;                // 등록 순서 (같은 우선순위 내 FIFO)
+    uint8_t             length;             // 데이터 길이
+    uint8_t             data[METER_CMD_DATA_MAX];
+    METER_CMD_POLICY_Type policy;           // 전송 정책
+    METER_CMD_DONE_Type on_complete;        // 완료 콜백
+} METER_CMD_ENTRY_Type;
+
+// 스트리밍 프레임 조립기 (포트별)
+typedef struct
+{
+    uint8_t             state;              // 조립 단계
+    uint8_t             len;                // L 필드
+    uint8_t             remain;             // 남은 BODY 바이트 수
+    uint8_t             sum;                // BODY 누적 합 (체크섬)
+    uint8_t             xor_sum;            // BODY 누적 XOR
+    METER_STATE_Type    resume_state;       // 프레임 시작 전 상태 (재동기화/폐기 시 복귀)
+    uint32_t            byte_deadline_ms;   // 다음 바이트 기한 (지나면 조립 중 프레임 폐기)
+} METER_ASM_Type;
+
+// 링크 통계 (포트별 누적 카운터, Meter_SetLinkStats()로 저장 위치 지정)
+typedef struct
+{
+    uint32_t            tx_frames;          // 커맨드 전송 (재전송 포함)
+    uint32_t            rx_frames;          // 체크섬 정상 수신
+    uint16_t            retries;            // 재전송
+    uint16_t            timeouts;           // 응답 타임아웃
+    uint16_t            checksum_errors;    // 체크섬 오류
+    uint16_t            invalid_frames;     // 잘못된 프레임
+} METER_LINK_STATS_Type;
+
+// 프로토콜 컨텍스트 (포트별 1개)
+typedef struct
+{
+    METER_PORT_Type     port;               // 연결 포트
+    volatile bool       active;             // Meter_Init() 완료 (스케줄러 처리 대상)
+    volatile METER_STATE_Type state;        // 현재 상태 (SysTick/포트 인터럽트에서 갱신)
     uint32_t            timeout_ms;         // 타임아웃 카운터
+    uint32_t            phase_deadline_ms;  // PREAMBLE/TX/BACKOFF 단계 만료 시각
     uint8_t             retry_count;        // 재전송 카운터
+    uint8_t             max_retry;          // 현재 커맨드 최대 재전송 횟수
+    uint16_t            response_timeout_ms;    // 현재 커맨드 응답 대기 시간
+    uint16_t            backoff_ms;         // 현재 커맨드 첫 재전송 대기 시간
+    bool                rx_wake;            // 파워다운 중 수신 시작으로 깨어남 (응답 대기 중 파워다운 허용)
     METER_ERROR_Type    last_error;         // 마지막 에러
 
     // TX 버퍼
     uint8_t             tx_buffer[METER_MAX_FRAME_SIZE];
     uint16_t            tx_length;
     uint16_t            tx_index;
+    uint8_t             tx_step;            // 송신 준비 단계 (FIFO 클리어/안정화)
+
+    // RX 링 버퍼 (포트 수신 인터럽트 → Meter_Task)
+    uint8_t             rx_ring[METER_RX_RING_SIZE];
+    volatile uint8_t    rx_ring_head;       // 인터럽트에서 갱신
+    volatile uint8_t    rx_ring_tail;       // Meter_Task에서 갱신
 
     // RX 버퍼
     uint8_t             rx_buffer[METER_MAX_FRAME_SIZE];
     uint16_t            rx_length;
     uint16_t            rx_index;
+    METER_ASM_Type      rx_asm;             // 프레임 조립기
+    METER_RX_FRAME_Type rx_desc;            // rx_buffer 프레임 디스크립터
+
+    // 커맨드 큐
+    METER_CMD_ENTRY_Type cmd_queue[METER_CMD_QUEUE_SIZE];
+    uint8_t             cmd_seq;            // 다음 등록 순서
+    uint8_t             cmd_active;         // 전송 중인 큐 항목 (METER_CMD_NONE: 없음)
 
     // 콜백 함수
-    void (*on_response_received)(uint8_t* data, uint16_t length);
-    void (*on_error)(METER_ERROR_Type error);
+    void (*on_response_received)(METER_PORT_Type port, uint8_t* data, uint16_t length);
+    void (*on_error)(METER_PORT_Type port, METER_ERROR_Type error);
 } METER_CONTEXT_Type;
 
 //******************************************************************************
 // 함수 프로토타입
 //******************************************************************************
 
-// 초기화 및 설정
-void Meter_Init(void);
-void Meter_SetResponseCallback(void (*callback)(uint8_t* data, uint16_t length));
-void Meter_SetErrorCallback(void (*callback)(METER_ERROR_Type error));
+// 초기화 및 설정 (포트 설정 후 포트별 호출)
+void Meter_Init(METER_PORT_Type port);
+void Meter_SetResponseCallback(METER_PORT_Type port, void (*callback)(METER_PORT_Type port, uint8_t* data, uint16_t length));
+void Meter_SetErrorCallback(METER_PORT_Type port, void (*callback)(METER_PORT_Type port, METER_ERROR_Type error));
 
 // 프레임 생성 및 전송
-METER_ERROR_Type Meter_SendCommand(uint8_t addr, uint8_t cmd, uint8_t* data, uint8_t length);
-METER_ERROR_Type Meter_SendACK(void);
-METER_ERROR_Type Meter_SendNAK(void);
+METER_ERROR_Type Meter_SendCommand(METER_PORT_Type port, uint8_t addr, uint8_t cmd, uint8_t* data, uint8_t length);
+METER_ERROR_Type Meter_SendACK(METER_PORT_Type port);
+METER_ERROR_Type Meter_SendNAK(METER_PORT_Type port);
+
+// 커맨드 큐 (우선순위, 커맨드별 타임아웃/재전송 정책, 완료 콜백)
+METER_ERROR_Type Meter_QueueCommand(METER_PORT_Type port, uint8_t cmd, uint8_t* data, uint8_t length, METER_CMD_DONE_Type on_complete);
+METER_ERROR_Type Meter_QueueCommandPolicy(METER_PORT_Type port, const METER_CMD_POLICY_Type* policy, uint8_t* data, uint8_t length, METER_CMD_DONE_Type on_complete);
+uint8_t Meter_GetQueueCount(METER_PORT_Type port);  // 대기 + 전송 중 커맨드 수
+
+// 동시 검침 (활성화된 모든 포트)
+uint8_t Meter_PollAll(uint8_t cmd, uint8_t* data, uint8_t length);  // 시작한 포트 비트마스크
+bool Meter_PollDone(void);  // 모든 포트 IDLE 여부
 
 // 수신 처리
-void Meter_ProcessReceive(uint8_t* data, uint16_t length);
-void Meter_Task(void);  // 주기적으로 호출해야 하는 타스크 함수
+void Meter_ProcessReceive(METER_PORT_Type port, uint8_t* data, uint16_t length);
+void Meter_Task(void);  // 주기적으로 호출해야 하는 타스크 함수 (모든 포트 처리)
+
+// 포트 인터럽트 처리
+uint8_t Meter_TxIRQHandler(METER_PORT_Type port);  // 1: 계량기 송신이 처리함, 0: 미사용
+void Meter_RxByteIRQHandler(METER_PORT_Type port, uint8_t byte);  // 바이트 수신 (링 버퍼 저장)
+void Meter_PortIRQHandler(METER_PORT_Type port);  // UART0/1, USART10 인터럽트 핸들러에서 호출
+
+// 하드웨어 프레임 수신 (METER_RX_HW_DELIMIT, LPUART RCD/RTO 인터럽트에서 호출)
+void Meter_RxIRQHandler(uint8_t intsrc);
+void Meter_ReleaseFrame(uint8_t* frame);  // 응답 콜백으로 받은 프레임 버퍼 반환
+const METER_RX_FRAME_Type* Meter_GetFrameInfo(uint8_t* frame);  // 응답 콜백 프레임의 디스크립터
+bool Meter_FrameIsHeld(const uint8_t* frame);  // 응답 콜백 프레임을 콜백 이후까지 보유 가능한지
 
 // 유틸리티 함수
 uint8_t Meter_CalculateChecksum(uint8_t* data, uint16_t length);
 uint8_t Meter_ValidateFrame(METER_FRAME_Type* frame);
+uint16_t Meter_CRC16(const void* data, uint16_t length, uint16_t crc);  // CRC-16/CCITT (초기값 0xFFFF)
 void Meter_SendPreamble(void);  // 20ms High Level 전송
 
 // 상태 조회
-METER_STATE_Type Meter_GetState(void);
-METER_ERROR_Type Meter_GetLastError(void);
-void Meter_Reset(void);
+METER_STATE_Type Meter_GetState(METER_PORT_Type port);  // 잘못된 포트는 IDLE
+void Meter_SetLinkStats(METER_LINK_STATS_Type* stats);  // [METER_PORT_MAX] 배열, NULL: 집계 안 함
+const METER_LINK_STATS_Type* Meter_GetLinkStats(METER_PORT_Type port);  // 미지정 시 NULL
+METER_ERROR_Type Meter_GetLastError(METER_PORT_Type port);  // 잘못된 포트는 METER_ERR_INVALID_PARAM
+void Meter_Reset(METER_PORT_Type port);
+void Meter_SetRxWake(METER_PORT_Type port, bool enable);  // 포트가 파워다운에서 수신 시작으로 깨어날 수 있음
 
 // SysTick 지원 함수 (A31L12x_it.c에서 호출)
 void Meter_SysTick_Increment(void);
+uint32_t Meter_GetTickMs(void);     // 시스템 시작 후 경과 시간 (ms)
+void Meter_SysTick_Advance(uint32_t ms);  // SysTick 정지(파워다운) 동안 지난 시간 반영
+uint32_t Meter_GetIdleMs(void);     // 0: 진행 중 (SysTick 필요), 그 외: 응답 기한까지 파워다운 가능 시간, METER_TICK_NEVER: 모든 포트 유휴
 
 //******************************************************************************
 // 범용 프로토콜 파서 (V1.1~V1.4 지원)
@@ -191,6 +356,44 @@ typedef enum
     PROTOCOL_V1_4    = 14       // V1.4 (2024.07~2025.05)
 } ProtocolVersion_t;
 
+// UserData 필드 위치 (MDH 기준 오프셋)
+typedef struct
+{
+    uint8_t mdh;                // MDH 값 (0x0F)
+    uint8_t id_ofs;             // 기물번호 BCD 4바이트 (Little Endian)
+    uint8_t dif_ofs;            // DIF (구경 코드)
+    uint8_t value_ofs;          // 검침값 BCD 4바이트 (Little Endian)
+    uint8_t udf_ofs;            // UDF 시작 (Pro Ver, Ver Mo, Man Code H/L)
+    uint8_t udf_len;            // UDF 최소 길이
+} MeterLayout_t;
+
+// Status 비트 필드: out[dst] = (userdata[src] & mask) >> shift
+typedef struct
+{
+    uint8_t src;                // UserData 오프셋 (Status1, S2&VIF 등)
+    uint8_t mask;               // 비트 마스크
+    uint8_t shift;              // 오른쪽 시프트
+    uint8_t dst;                // MeterData_t 내 1바이트 필드 오프셋 (offsetof)
+} MeterBitField_t;
+
+// 버전 감지 플래그
+#define METER_VER_NO_UDF        0x01    // UserData에 UDF 없음 (최소 길이 프레임)
+#define METER_VER_UDF_DEFAULT   0x02    // UDF 버전 필드로 판별 불가 시 기본값
+
+// 프로토콜 버전 디스크립터 (flash 상수 테이블, meter_protocol_parser.c)
+// 새 버전은 디스크립터 1개와 비트 필드 테이블 추가로 지원
+typedef struct
+{
+    ProtocolVersion_t       version;        // 프로토콜 버전
+    const char*             name;           // 표시 이름
+    uint8_t                 udf_ver;        // UDF Pro Ver 값 (0: 해당 없음)
+    uint8_t                 s2_mask;        // S2&VIF 중 Status2 비트 (UDF 없이 감지, 0: 해당 없음)
+    uint8_t                 flags;          // METER_VER_xxx
+    uint8_t                 field_count;    // 비트 필드 수
+    const MeterLayout_t*    layout;         // UserData 필드 위치
+    const MeterBitField_t*  fields;         // Status/VIF 비트 필드
+} MeterVersionDesc_t;
+
 // Status 정보 (버전별 차이 반영)
 typedef struct
 {
@@ -291,6 +494,13 @@ typedef struct
  */
 ProtocolVersion_t Meter_DetectVersion(uint8_t* frame, uint16_t length);
 
+/**
+ * @brief 프로토콜 버전 디스크립터 조회
+ * @param version 프로토콜 버전
+ * @return 디스크립터, 지원하지 않는 버전이면 NULL
+ */
+const MeterVersionDesc_t* Meter_GetVersionDesc(ProtocolVersion_t version);
+
 /**
  * @brief 모든 버전 프레임 통합 파싱
  * @param frame 원본 프레임
@@ -300,6 +510,14 @@ ProtocolVersion_t Meter_DetectVersion(uint8_t* frame, uint16_t length);
  */
 bool Meter_ParseFrame(uint8_t* frame, uint16_t length, MeterData_t* parsed_data);
 
+/**
+ * @brief 수신 프레임 파싱 (수신 경로의 누적 체크섬 사용, 프레임 재순회 없음)
+ * @param rx Meter_GetFrameInfo()가 반환한 디스크립터
+ * @param parsed_data 파싱 결과 저장 구조체 (출력)
+ * @return true: 파싱 성공, false: 파싱 실패
+ */
+bool Meter_ParseRxFrame(const METER_RX_FRAME_Type* rx, MeterData_t* parsed_data);
+
 /**
  * @brief 파싱된 데이터를 디버그 포트로 출력
  * @param data 파싱된 데이터
@@ -314,6 +532,31 @@ void Meter_PrintParsedData(MeterData_t* data);
  */
 uint32_t Meter_BCD_To_Uint32(uint8_t bcd[4]);
 
+/**
+ * @brief BCD 4바이트를 uint32로 변환 (Big Endian)
+ * @param bcd BCD 배열 [4] (bcd[0]이 최상위 자리, 프레임 내 기물번호 순서)
+ * @return 변환된 정수 (예: {0x12, 0x34, 0x56, 0x78} → 12345678)
+ */
+uint32_t Meter_BCD_To_Uint32_BE(const uint8_t bcd[4]);
+
+/**
+ * @brief 연속된 BCD 4바이트 배열 일괄 변환
+ * @param bcd BCD 배열 (count x 4바이트, 각 항목 Little Endian)
+ * @param out 변환 결과 [count] (잘못된 BCD 항목은 0)
+ * @param count 항목 수
+ * @return 잘못된 BCD 항목 수
+ */
+uint16_t Meter_BCD_To_Uint32_Batch(const uint8_t* bcd, uint32_t* out, uint16_t count);
+
+/**
+ * @brief BCD 검침값을 정수부/소수부로 분리 (나눗셈 없음)
+ * @param bcd BCD 배열 [4] (Little Endian)
+ * @param decimal_point 소수점 자리수 (0~7)
+ * @param frac 소수부 (출력)
+ * @return 정수부 (예: {0x78, 0x56, 0x34, 0x12}, 3 → 12345, frac = 678)
+ */
+uint32_t Meter_BCD_Split(const uint8_t bcd[4], uint8_t decimal_point, uint32_t* frac);
+
 /**
  * @brief 배터리 전압 코드를 실제 전압(V)으로 변환
  * @param voltage_code 0~31 (5비트)
@@ -10,287 +10,363 @@
 #include "meter_protocol.h"
 #include "A31L12x_hal_debug_frmwrk.h"
 #include "string.h"
+#include "stddef.h"
+
+//******************************************************************************
+// 프로토콜 버전 디스크립터 테이블 (flash 상수)
+//******************************************************************************
+
+// UserData 구조 (V1.1~V1.4 공통):
+// MDH(1) + ID(4) + Status(1) + DIF(1) + VIF(1) + Data(4) [+ UDF(n)]
+//  0       1-4      5           6        7        8-11      12-
+#define UD_STATUS       5           // Status (V1.4: Status1)
+#define UD_VIF          7           // VIF (V1.4: S2&VIF)
+
+#define MD_OFS(field)   ((uint8_t)offsetof(MeterData_t, field))
+
+static const MeterLayout_t g_layout_common =
+{
+    0x0F,       // MDH
+    1,          // ID
+    6,          // DIF
+    8,          // Data
+    12,         // UDF
+    4           // UDF 최소 길이
+};
+
+// V1.1: Bit 7 Q4 초과, Bit 6 역류, Bit 5 옥내누수, Bit 2 Batt.Low, Bit 1 동파경고
+static const MeterBitField_t g_fields_v11[] =
+{
+    { UD_STATUS, 0x80, 7, MD_OFS(status.q3_exceed) },
+    { UD_STATUS, 0x40, 6, MD_OFS(status.reverse_flow) },
+    { UD_STATUS, 0x20, 5, MD_OFS(status.indoor_leak) },
+    { UD_STATUS, 0x04, 2, MD_OFS(status.ext.v11.batt_low) },
+    { UD_STATUS, 0x02, 1, MD_OFS(status.ext.v11.freeze_warning) },
+    { UD_VIF,    0x0F, 0, MD_OFS(decimal_point) }
+};
+
+// V1.2: Bit 7 Q3 초과, Bit 6 역류, Bit 5 옥내누수, Bit 2 Batt.Low (3개월 전)
+static const MeterBitField_t g_fields_v12[] =
+{
+    { UD_STATUS, 0x80, 7, MD_OFS(status.q3_exceed) },
+    { UD_STATUS, 0x40, 6, MD_OFS(status.reverse_flow) },
+    { UD_STATUS, 0x20, 5, MD_OFS(status.indoor_leak) },
+    { UD_STATUS, 0x04, 2, MD_OFS(status.ext.v12.batt_low) },
+    { UD_VIF,    0x0F, 0, MD_OFS(decimal_point) }
+};
+
+// V1.3: Bit 7 Q3 초과, Bit 6 역류, Bit 5 옥내누수, Bit 4-0 배터리 전압
+static const MeterBitField_t g_fields_v13[] =
+{
+    { UD_STATUS, 0x80, 7, MD_OFS(status.q3_exceed) },
+    { UD_STATUS, 0x40, 6, MD_OFS(status.reverse_flow) },
+    { UD_STATUS, 0x20, 5, MD_OFS(status.indoor_leak) },
+    { UD_STATUS, 0x1F, 0, MD_OFS(status.ext.v13.batt_voltage) },
+    { UD_VIF,    0x0F, 0, MD_OFS(decimal_point) }
+};
+
+// V1.4: Status1은 V1.3과 동일, S2&VIF Bit 7 자석 감지, Bit 6 동파경보, Bit 3-0 소수점
+static const MeterBitField_t g_fields_v14[] =
+{
+    { UD_STATUS, 0x80, 7, MD_OFS(status.q3_exceed) },
+    { UD_STATUS, 0x40, 6, MD_OFS(status.reverse_flow) },
+    { UD_STATUS, 0x20, 5, MD_OFS(status.indoor_leak) },
+    { UD_STATUS, 0x1F, 0, MD_OFS(status.ext.v14.batt_voltage) },
+    { UD_VIF,    0x80, 7, MD_OFS(status.ext.v14.magnet_detected) },
+    { UD_VIF,    0x40, 6, MD_OFS(status.ext.v14.freeze_warning) },
+    { UD_VIF,    0x0F, 0, MD_OFS(decimal_point) }
+};
+
+#define FIELD_COUNT(t)  ((uint8_t)(sizeof(t) / sizeof((t)[0])))
+
+// 감지 순서: NO_UDF → udf_ver 일치 → s2_mask → UDF_DEFAULT
+static const MeterVersionDesc_t g_version_desc[] =
+{
+    { PROTOCOL_V1_1, "V1.1 (2013.06)",  0x00, 0x00, METER_VER_NO_UDF,      FIELD_COUNT(g_fields_v11), &g_layout_common, g_fields_v11 },
+    { PROTOCOL_V1_2, "V1.2 (2021.05)",  0x12, 0x00, METER_VER_UDF_DEFAULT, FIELD_COUNT(g_fields_v12), &g_layout_common, g_fields_v12 },
+    { PROTOCOL_V1_3, "V1.3 (2023.01)",  0x13, 0x00, 0,                     FIELD_COUNT(g_fields_v13), &g_layout_common, g_fields_v13 },
+    { PROTOCOL_V1_4, "V1.4 (2024.07)",  0x14, 0xC0, 0,                     FIELD_COUNT(g_fields_v14), &g_layout_common, g_fields_v14 }
+};
+
+#define VERSION_DESC_COUNT  (sizeof(g_version_desc) / sizeof(g_version_desc[0]))
 
 //******************************************************************************
 // 내부 함수 선언
 //******************************************************************************
 
-static bool Meter_ParseCommon(uint8_t* userdata, MeterData_t* out);
-static bool Meter_ParseV11_Status(uint8_t status_byte, MeterData_t* out);
-static bool Meter_ParseV12_Status(uint8_t status_byte, MeterData_t* out);
-static bool Meter_ParseV13_Status(uint8_t status_byte, MeterData_t* out);
-static bool Meter_ParseV14_Status(uint8_t status_byte, uint8_t s2vif_byte, MeterData_t* out);
-static bool Meter_ParseUDF(uint8_t* udf_data, uint8_t udf_len, MeterData_t* out);
+static bool Meter_ParseFrameSum(uint8_t* frame, uint16_t length, uint8_t checksum_calc, MeterData_t* parsed_data);
+static const MeterVersionDesc_t* Meter_DetectDesc(uint8_t* frame, uint16_t length);
+static void Meter_DecodeUserData(const MeterVersionDesc_t* desc, uint8_t* userdata, uint8_t userdata_len, MeterData_t* out);
 
 //******************************************************************************
-// 통합 파싱 함수 구현
+// 버전 감지
 //******************************************************************************
 
 /**
- * @brief 모든 버전 프레임 통합 파싱
- * @param frame 원본 프레임
- * @param length 프레임 길이
- * @param parsed_data 파싱 결과 저장 구조체
- * @return true: 파싱 성공, false: 파싱 실패
+ * @brief 프로토콜 버전 디스크립터 조회
+ * @param version 프로토콜 버전
+ * @return 디스크립터, 지원하지 않는 버전이면 NULL
  */
-bool Meter_ParseFrame(uint8_t* frame, uint16_t length, MeterData_t* parsed_data)
+const MeterVersionDesc_t* Meter_GetVersionDesc(ProtocolVersion_t version)
 {
-    // 초기화
-    memset(parsed_data, 0, sizeof(MeterData_t));
-    parsed_data->raw_frame = frame;
-    parsed_data->raw_length = length;
-    parsed_data->parse_success = false;
-
-    // 버전 감지
-    ProtocolVersion_t version = Meter_DetectVersion(frame, length);
-    parsed_data->version = version;
+    uint8_t i;
 
-    if (version == PROTOCOL_UNKNOWN)
+    for (i = 0; i < VERSION_DESC_COUNT; i++)
     {
-        return false;
+        if (g_version_desc[i].version == version)
+        {
+            return &g_version_desc[i];
+        }
     }
 
-    // 프레임 구조 검증
-    // 68 L L 68 C A CI [UserData] CS 16
-    //  0 1 2  3 4 5  6    ...     -2 -1
+    return NULL;
+}
 
-    uint8_t L = frame[1];
+/**
+ * @brief 프로토콜 버전 자동 감지
+ * @param frame 원본 프레임 (68 L L 68 C A CI [UserData] CS 16)
+ * @param length 프레임 길이
+ * @return 감지된 프로토콜 버전
+ */
+ProtocolVersion_t Meter_DetectVersion(uint8_t* frame, uint16_t length)
+{
+    const MeterVersionDesc_t* desc = Meter_DetectDesc(frame, length);
 
-    // 체크섬 검증
-    uint8_t checksum_calc = 0;
-    uint16_t i;
+    return (desc != NULL) ? desc->version : PROTOCOL_UNKNOWN;
+}
 
-    // 체크섬 계산: C + A + CI + UserData
-    for (i = 4; i < 4 + L; i++)
+/**
+ * @brief 프레임 검증 후 디스크립터 테이블로 버전 판별
+ * @param frame 원본 프레임
+ * @param length 프레임 길이
+ * @return 디스크립터, 판별 불가 시 NULL
+ *
+ * @details 판별 순서 (테이블 1회 순회):
+ *   1. UserData가 최소 길이(UDF 없음) → METER_VER_NO_UDF
+ *   2. UDF Pro Ver 값이 udf_ver와 일치
+ *   3. S2&VIF에 s2_mask 비트가 설정됨 (Status2 포함)
+ *   4. METER_VER_UDF_DEFAULT
+ */
+static const MeterVersionDesc_t* Meter_DetectDesc(uint8_t* frame, uint16_t length)
+{
+    const MeterLayout_t* layout = &g_layout_common;
+    const MeterVersionDesc_t* s2_desc = NULL;
+    const MeterVersionDesc_t* default_desc = NULL;
+    uint8_t no_udf_flag;
+    uint8_t proto_ver;
+    uint8_t vif_byte;
+    uint8_t L;
+    uint8_t userdata_len;
+    uint8_t i;
+
+    // 최소 길이: 6(헤더) + 최소UserData(4) + 2(CS+END)
+    if (length < 12)
     {
-        checksum_calc += frame[i];
+        return NULL;
     }
 
-    parsed_data->checksum_calculated = checksum_calc;
-    parsed_data->checksum_received = frame[4 + L];
-    parsed_data->checksum_valid = (checksum_calc == parsed_data->checksum_received);
-
-    if (!parsed_data->checksum_valid)
+    // 프레임 시작/종료 바이트, L Field 일치성 및 범위 확인
+    // L < 0x0B는 UserData 최소 길이 미달 (L < 3이면 UserData 길이가 음수)
+    L = frame[1];
+    if (frame[0] != 0x68 || frame[3] != 0x68 || frame[length - 1] != 0x16 ||
+        L != frame[2] || L < 0x0B || L > 0xFC)
     {
-        // 체크섬 오류지만 파싱은 계속 (디버깅용)
+        return NULL;
     }
 
-    // 기본 필드 추출
-    parsed_data->c_field = frame[4];
-    parsed_data->a_field = frame[5];
-    parsed_data->ci_field = frame[6];
-
-    // UserData 포인터
-    uint8_t* userdata = &frame[7];
-    uint8_t userdata_len = L - 3;
+    // L이 가리키는 CS/END(frame[4 + L], frame[5 + L])가 받은 길이 안에 있어야 UserData를 읽는다
+    if (length < (uint16_t)L + 6)
+    {
+        return NULL;
+    }
 
-    // 공통 파싱
-    if (!Meter_ParseCommon(userdata, parsed_data))
+    // UserData = L - C(1) - A(1) - CI(1)
+    userdata_len = L - 3;
+    if (userdata_len < layout->udf_ofs)
     {
-        return false;
+        return NULL;
     }
 
-    // 버전별 Status 파싱
-    uint8_t status_byte = userdata[5];  // MDH(1) + ID(4) + Status(1)
+    no_udf_flag = (userdata_len == layout->udf_ofs) ? METER_VER_NO_UDF : 0;
+    proto_ver = (userdata_len >= layout->udf_ofs + layout->udf_len) ? frame[7 + layout->udf_ofs] : 0;
+    vif_byte = frame[7 + UD_VIF];
 
-    switch (version)
+    for (i = 0; i < VERSION_DESC_COUNT; i++)
     {
-        case PROTOCOL_V1_1:
-            Meter_ParseV11_Status(status_byte, parsed_data);
-            break;
+        const MeterVersionDesc_t* desc = &g_version_desc[i];
 
-        case PROTOCOL_V1_2:
-            Meter_ParseV12_Status(status_byte, parsed_data);
-            break;
-
-        case PROTOCOL_V1_3:
-            Meter_ParseV13_Status(status_byte, parsed_data);
-            break;
+        if (no_udf_flag)
+        {
+            if (desc->flags & METER_VER_NO_UDF)
+            {
+                return desc;
+            }
+            continue;
+        }
 
-        case PROTOCOL_V1_4:
+        if (proto_ver != 0 && desc->udf_ver == proto_ver)
         {
-            uint8_t s2vif_byte = userdata[7];  // S2&VIF
-            Meter_ParseV14_Status(status_byte, s2vif_byte, parsed_data);
-            break;
+            return desc;
         }
 
-        default:
-            return false;
-    }
+        if (s2_desc == NULL && (vif_byte & desc->s2_mask) != 0)
+        {
+            s2_desc = desc;
+        }
 
-    // UDF 파싱 (V1.2+)
-    if (userdata_len > 12)
-    {
-        uint8_t* udf_data = &userdata[12];
-        uint8_t udf_len = userdata_len - 12;
-        Meter_ParseUDF(udf_data, udf_len, parsed_data);
+        if (default_desc == NULL && (desc->flags & METER_VER_UDF_DEFAULT))
+        {
+            default_desc = desc;
+        }
     }
 
-    parsed_data->parse_success = true;
-    return true;
+    return (s2_desc != NULL) ? s2_desc : default_desc;
 }
 
 //******************************************************************************
-// 내부 파싱 함수 구현
+// 통합 파싱 함수 구현
 //******************************************************************************
 
 /**
- * @brief 공통 필드 파싱
- * @param userdata UserData 포인터
- * @param out 출력 구조체
- * @return true: 성공, false: 실패
+ * @brief 모든 버전 프레임 통합 파싱
+ * @param frame 원본 프레임
+ * @param length 프레임 길이
+ * @param parsed_data 파싱 결과 저장 구조체
+ * @return true: 파싱 성공, false: 파싱 실패
+ * @note 체크섬을 프레임에서 직접 계산한다. 수신 프레임은 Meter_ParseRxFrame() 사용
  */
-static bool Meter_ParseCommon(uint8_t* userdata, MeterData_t* out)
+bool Meter_ParseFrame(uint8_t* frame, uint16_t length, MeterData_t* parsed_data)
 {
-    // UserData 구조:
-    // MDH(1) + ID(4) + Status(1) + DIF(1) + VIF(1) + Data(4) [+ UDF(n)]
-    //  0       1-4      5           6        7        8-11
+    uint8_t checksum_calc = 0;
+    uint16_t i;
 
-    // MDH 확인 (0x0F 고정)
-    if (userdata[0] != 0x0F)
+    // 체크섬 계산: C + A + CI + UserData (L 필드가 프레임 길이 안에 있을 때만)
+    if (length >= 6 && length >= (uint16_t)(frame[1] + 6))
     {
-        return false;
+        for (i = 4; i < 4 + frame[1]; i++)
+        {
+            checksum_calc += frame[i];
+        }
     }
 
-    // 기물번호 파싱 (BCD 4바이트)
-    uint8_t id_bcd[4];
-    id_bcd[0] = userdata[4];  // Little Endian
-    id_bcd[1] = userdata[3];
-    id_bcd[2] = userdata[2];
-    id_bcd[3] = userdata[1];
-
-    out->meter_id = Meter_BCD_To_Uint32(id_bcd);
-
-    // DIF 파싱
-    uint8_t dif = userdata[6];
-    out->diameter_mm = Meter_GetDiameter(dif);
-
-    // VIF 파싱 (또는 S2&VIF)
-    uint8_t vif = userdata[7];
-    out->decimal_point = vif & 0x0F;  // Bit 3-0: 소수점 위치
-
-    // 검침값 파싱 (BCD 4바이트)
-    out->reading_bcd[0] = userdata[8];   // Little Endian
-    out->reading_bcd[1] = userdata[9];
-    out->reading_bcd[2] = userdata[10];
-    out->reading_bcd[3] = userdata[11];
-
-    out->reading_value = Meter_BCD_To_Uint32(out->reading_bcd);
-
-    return true;
+    return Meter_ParseFrameSum(frame, length, checksum_calc, parsed_data);
 }
 
 /**
- * @brief V1.1 Status 파싱
+ * @brief 수신 프레임 파싱 (수신 경로의 누적 체크섬 사용)
+ * @param rx 수신 프레임 디스크립터
+ * @param parsed_data 파싱 결과 저장 구조체
+ * @return true: 파싱 성공, false: 파싱 실패
  */
-static bool Meter_ParseV11_Status(uint8_t status_byte, MeterData_t* out)
+bool Meter_ParseRxFrame(const METER_RX_FRAME_Type* rx, MeterData_t* parsed_data)
 {
-    // V1.1 Status Bit:
-    // Bit 7: Q4 초과
-    // Bit 6: 역류
-    // Bit 5: 옥내누수
-    // Bit 2: Batt.Low
-    // Bit 1: 동파경고
-
-    out->status.q3_exceed = (status_byte & 0x80) ? true : false;  // Bit 7 (V1.1은 Q4)
-    out->status.reverse_flow = (status_byte & 0x40) ? true : false;
-    out->status.indoor_leak = (status_byte & 0x20) ? true : false;
-
-    out->status.ext.v11.batt_low = (status_byte & 0x04) ? true : false;  // Bit 2
-    out->status.ext.v11.freeze_warning = (status_byte & 0x02) ? true : false;  // Bit 1
-
-    return true;
+    return Meter_ParseFrameSum(rx->frame, rx->length, rx->sum, parsed_data);
 }
 
 /**
- * @brief V1.2 Status 파싱
+ * @brief 통합 파싱 본체
+ * @param frame 원본 프레임
+ * @param length 프레임 길이
+ * @param checksum_calc C + A + CI + UserData 합
+ * @param parsed_data 파싱 결과 저장 구조체
+ * @return true: 파싱 성공, false: 파싱 실패
  */
-static bool Meter_ParseV12_Status(uint8_t status_byte, MeterData_t* out)
+static bool Meter_ParseFrameSum(uint8_t* frame, uint16_t length, uint8_t checksum_calc, MeterData_t* parsed_data)
 {
-    // V1.2 Status Bit:
-    // Bit 7: Q3 초과
-    // Bit 6: 역류
-    // Bit 5: 옥내누수
-    // Bit 2: Batt.Low (3개월 전)
-
-    out->status.q3_exceed = (status_byte & 0x80) ? true : false;
-    out->status.reverse_flow = (status_byte & 0x40) ? true : false;
-    out->status.indoor_leak = (status_byte & 0x20) ? true : false;
-
-    out->status.ext.v12.batt_low = (status_byte & 0x04) ? true : false;  // Bit 2
+    // 초기화
+    memset(parsed_data, 0, sizeof(MeterData_t));
+    parsed_data->raw_frame = frame;
+    parsed_data->raw_length = length;
+    parsed_data->parse_success = false;
 
-    return true;
-}
+    // 버전 감지
+    const MeterVersionDesc_t* desc = Meter_DetectDesc(frame, length);
 
-/**
- * @brief V1.3 Status 파싱
- */
-static bool Meter_ParseV13_Status(uint8_t status_byte, MeterData_t* out)
-{
-    // V1.3 Status Bit:
-    // Bit 7: Q3 초과
-    // Bit 6: 역류
-    // Bit 5: 옥내누수
-    // Bit 4-0: 배터리 전압 정보 (5비트)
+    if (desc == NULL)
+    {
+        parsed_data->version = PROTOCOL_UNKNOWN;
+        return false;
+    }
 
-    out->status.q3_exceed = (status_byte & 0x80) ? true : false;
-    out->status.reverse_flow = (status_byte & 0x40) ? true : false;
-    out->status.indoor_leak = (status_byte & 0x20) ? true : false;
+    parsed_data->version = desc->version;
 
-    out->status.ext.v13.batt_voltage = status_byte & 0x1F;  // Bit 4-0
+    // 프레임 구조 검증
+    // 68 L L 68 C A CI [UserData] CS 16
+    //  0 1 2  3 4 5  6    ...     -2 -1
 
-    return true;
-}
+    uint8_t L = frame[1];
 
-/**
- * @brief V1.4 Status 파싱
- */
-static bool Meter_ParseV14_Status(uint8_t status_byte, uint8_t s2vif_byte, MeterData_t* out)
-{
-    // V1.4 Status1 Bit:
-    // Bit 7: Q3 초과
-    // Bit 6: 역류
-    // Bit 5: 옥내누수
-    // Bit 4-0: 배터리 전압 정보
+    // 체크섬 검증 (CS 1바이트 비교, L + 6 <= length는 Meter_DetectDesc에서 확인)
+    parsed_data->checksum_calculated = checksum_calc;
+    parsed_data->checksum_received = frame[4 + L];
+    parsed_data->checksum_valid = (checksum_calc == parsed_data->checksum_received);
 
-    out->status.q3_exceed = (status_byte & 0x80) ? true : false;
-    out->status.reverse_flow = (status_byte & 0x40) ? true : false;
-    out->status.indoor_leak = (status_byte & 0x20) ? true : false;
+    if (!parsed_data->checksum_valid)
+    {
+        // 체크섬 오류지만 파싱은 계속 (디버깅용)
+    }
 
-    out->status.ext.v14.batt_voltage = status_byte & 0x1F;  // Bit 4-0
+    // 기본 필드 추출
+    parsed_data->c_field = frame[4];
+    parsed_data->a_field = frame[5];
+    parsed_data->ci_field = frame[6];
 
-    // V1.4 Status2 (S2&VIF의 상위 비트):
-    // Bit 7: 자석 감지
-    // Bit 6: 동파경보
+    // MDH 확인
+    if (frame[7] != desc->layout->mdh)
+    {
+        return false;
+    }
 
-    out->status.ext.v14.magnet_detected = (s2vif_byte & 0x80) ? true : false;  // Bit 7
-    out->status.ext.v14.freeze_warning = (s2vif_byte & 0x40) ? true : false;   // Bit 6
+    // UserData 디코드 (디스크립터 1회 순회)
+    Meter_DecodeUserData(desc, &frame[7], L - 3, parsed_data);
 
+    parsed_data->parse_success = true;
     return true;
 }
 
+//******************************************************************************
+// 내부 파싱 함수 구현
+//******************************************************************************
+
 /**
- * @brief UDF 파싱
+ * @brief 디스크립터 기반 UserData 디코드
+ * @param desc 버전 디스크립터
+ * @param userdata UserData 포인터 (MDH부터)
+ * @param userdata_len UserData 길이
+ * @param out 출력 구조체
  */
-static bool Meter_ParseUDF(uint8_t* udf_data, uint8_t udf_len, MeterData_t* out)
+static void Meter_DecodeUserData(const MeterVersionDesc_t* desc, uint8_t* userdata, uint8_t userdata_len, MeterData_t* out)
 {
-    if (udf_len < 4)
-    {
-        out->has_udf = false;
-        return false;
-    }
+    const MeterLayout_t* layout = desc->layout;
+    const MeterBitField_t* field = desc->fields;
+    uint8_t* dst = (uint8_t*)out;
+    uint8_t i;
 
-    out->has_udf = true;
+    // 기물번호 (BCD 4바이트, Big Endian)
+    out->meter_id = Meter_BCD_To_Uint32_BE(&userdata[layout->id_ofs]);
 
-    // UDF 구조:
-    // [Pro Ver] [Ver Mo] [Man Code High] [Man Code Low]
-    //    0         1           2                3
+    // DIF (구경)
+    out->diameter_mm = Meter_GetDiameter(userdata[layout->dif_ofs]);
 
-    out->udf_protocol_ver = udf_data[0];  // 0x12, 0x13, 0x14
-    out->udf_verification_month = udf_data[1];  // 1~12
+    // 검침값 (BCD 4바이트, Little Endian)
+    memcpy(out->reading_bcd, &userdata[layout->value_ofs], 4);
+    out->reading_value = Meter_BCD_To_Uint32(out->reading_bcd);
+
+    // Status/VIF 비트 필드
+    for (i = 0; i < desc->field_count; i++, field++)
+    {
+        dst[field->dst] = (uint8_t)((userdata[field->src] & field->mask) >> field->shift);
+    }
 
-    // 제조사 코드 (Big Endian)
-    out->udf_manufacturer_code = (udf_data[2] << 8) | udf_data[3];
+    // UDF (V1.2+)
+    // [Pro Ver] [Ver Mo] [Man Code High] [Man Code Low]
+    if (userdata_len >= layout->udf_ofs + layout->udf_len)
+    {
+        uint8_t* udf_data = &userdata[layout->udf_ofs];
 
-    return true;
+        out->has_udf = true;
+        out->udf_protocol_ver = udf_data[0];
+        out->udf_verification_month = udf_data[1];
+        out->udf_manufacturer_code = (udf_data[2] << 8) | udf_data[3];  // Big Endian
+    }
 }
@@ -0,0 +1,209 @@
+/**
+ *******************************************************************************
+ * @file        meter_record.c
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       검침 레코드 (저장/전송용 고정 16바이트 형식)
+ * @details     MeterData_t ↔ MeterRecord_t 변환
+ *******************************************************************************
+ */
+
+#include "meter_record.h"
+#include "string.h"
+
+//******************************************************************************
+// 내부 함수 선언
+//******************************************************************************
+
+static uint8_t Meter_DiameterCode(uint16_t diameter_mm);
+static void Meter_Uint32_To_BCD(uint32_t value, uint8_t bcd[4]);
+
+//******************************************************************************
+// 내부 변수
+//******************************************************************************
+
+static uint32_t g_record_time = 0;              // 마지막 갱신 시 레코드 시각 (초)
+static uint32_t g_record_tick = 0;              // 마지막 갱신 시 Meter_GetTickMs() (초 단위로 전진)
+
+//******************************************************************************
+// 함수 구현
+//******************************************************************************
+
+/**
+ * @brief 파싱 결과를 레코드로 변환
+ * @param data 파싱된 데이터
+ * @param timestamp 검침 시각 (초)
+ * @param rec 레코드 (출력)
+ */
+void Meter_RecordEncode(const MeterData_t* data, uint32_t timestamp, MeterRecord_t* rec)
+{
+    const MeterStatus_t* st = &data->status;
+    uint16_t status = 0;
+
+    // 공통 Status
+    if (st->q3_exceed)      status |= METER_REC_Q3_EXCEED;
+    if (st->reverse_flow)   status |= METER_REC_REVERSE_FLOW;
+    if (st->indoor_leak)    status |= METER_REC_INDOOR_LEAK;
+    if (data->has_udf)      status |= METER_REC_UDF;
+    if (data->checksum_valid) status |= METER_REC_CHECKSUM_OK;
+
+    // 버전별 Status
+    switch (data->version)
+    {
+        case PROTOCOL_V1_1:
+            if (st->ext.v11.batt_low)       status |= METER_REC_BATT_LOW;
+            if (st->ext.v11.freeze_warning) status |= METER_REC_FREEZE;
+            break;
+
+        case PROTOCOL_V1_2:
+            if (st->ext.v12.batt_low)       status |= METER_REC_BATT_LOW;
+            break;
+
+        case PROTOCOL_V1_3:
+            status |= (uint16_t)((st->ext.v13.batt_voltage << METER_REC_BATT_CODE_POS) & METER_REC_BATT_CODE_MASK);
+            break;
+
+        case PROTOCOL_V1_4:
+            status |= (uint16_t)((st->ext.v14.batt_voltage << METER_REC_BATT_CODE_POS) & METER_REC_BATT_CODE_MASK);
+            if (st->ext.v14.magnet_detected) status |= METER_REC_MAGNET;
+            if (st->ext.v14.freeze_warning)  status |= METER_REC_FREEZE;
+            break;
+
+        default:
+            break;
+    }
+
+    rec->timestamp = timestamp;
+    rec->meter_id = data->meter_id;
+    rec->reading = data->reading_value;
+    rec->status = status;
+    rec->version = (uint8_t)data->version;
+    rec->dp_dia = (uint8_t)((Meter_DiameterCode(data->diameter_mm) << METER_REC_DIA_POS) |
+                            (data->decimal_point & METER_REC_DP_MASK));
+}
+
+/**
+ * @brief 레코드를 파싱 결과 형식으로 복원
+ * @param rec 레코드
+ * @param data 복원 결과 (출력)
+ * @return 레코드 시각 (초)
+ */
+uint32_t Meter_RecordDecode(const MeterRecord_t* rec, MeterData_t* data)
+{
+    MeterStatus_t* st = &data->status;
+    uint16_t status = rec->status;
+    uint8_t batt_code = (uint8_t)((status & METER_REC_BATT_CODE_MASK) >> METER_REC_BATT_CODE_POS);
+
+    memset(data, 0, sizeof(MeterData_t));
+
+    data->version = (ProtocolVersion_t)rec->version;
+    data->parse_success = true;
+    data->meter_id = rec->meter_id;
+    data->reading_value = rec->reading;
+    Meter_Uint32_To_BCD(rec->reading, data->reading_bcd);
+    data->decimal_point = rec->dp_dia & METER_REC_DP_MASK;
+    data->diameter_mm = Meter_GetDiameter(rec->dp_dia & (0x0F << METER_REC_DIA_POS));
+    data->has_udf = (status & METER_REC_UDF) != 0;
+    data->checksum_valid = (status & METER_REC_CHECKSUM_OK) != 0;
+
+    st->q3_exceed = (status & METER_REC_Q3_EXCEED) != 0;
+    st->reverse_flow = (status & METER_REC_REVERSE_FLOW) != 0;
+    st->indoor_leak = (status & METER_REC_INDOOR_LEAK) != 0;
+
+    switch (data->version)
+    {
+        case PROTOCOL_V1_1:
+            st->ext.v11.batt_low = (status & METER_REC_BATT_LOW) != 0;
+            st->ext.v11.freeze_warning = (status & METER_REC_FREEZE) != 0;
+            break;
+
+        case PROTOCOL_V1_2:
+            st->ext.v12.batt_low = (status & METER_REC_BATT_LOW) != 0;
+            break;
+
+        case PROTOCOL_V1_3:
+            st->ext.v13.batt_voltage = batt_code;
+            break;
+
+        case PROTOCOL_V1_4:
+            st->ext.v14.batt_voltage = batt_code;
+            st->ext.v14.magnet_detected = (status & METER_REC_MAGNET) != 0;
+            st->ext.v14.freeze_warning = (status & METER_REC_FREEZE) != 0;
+            break;
+
+        default:
+            break;
+    }
+
+    return rec->timestamp;
+}
+
+/**
+ * @brief 레코드 시각 기준 설정
+ */
+void Meter_RecordTimeInit(uint32_t last)
+{
+    g_record_time = last + 1;
+    g_record_tick = Meter_GetTickMs();
+}
+
+/**
+ * @brief 현재 레코드 시각
+ * @details 지난 갱신 후 경과한 초만 더하고 나머지 ms는 다음 갱신으로 넘긴다.
+ *          틱 차이로 계산하므로 밀리초 틱이 랩어라운드해도 시각은 계속 증가한다.
+ */
+uint32_t Meter_RecordTime(void)
+{
+    uint32_t sec = (Meter_GetTickMs() - g_record_tick) / 1000;
+
+    g_record_time += sec;
+    g_record_tick += sec * 1000;
+
+    return g_record_time;
+}
+
+//******************************************************************************
+// 내부 함수 구현
+//******************************************************************************
+
+/**
+ * @brief 구경(mm)을 DIF 구경 코드로 역변환
+ * @param diameter_mm 구경 (mm)
+ * @return 구경 코드 (0: 알 수 없음)
+ */
+static uint8_t Meter_DiameterCode(uint16_t diameter_mm)
+{
+    uint8_t code;
+
+    if (diameter_mm == 0)
+    {
+        return 0;
+    }
+
+    for (code = 1; code <= 0x0F; code++)
+    {
+        if (Meter_GetDiameter((uint8_t)(code << 4)) == diameter_mm)
+        {
+            return code;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 정수를 BCD 4바이트로 변환 (Little Endian, 최대 99999999)
+ * @param value 정수
+ * @param bcd BCD 배열 [4] (출력)
+ */
+static void Meter_Uint32_To_BCD(uint32_t value, uint8_t bcd[4])
+{
+    uint8_t i;
+
+    for (i = 0; i < 4; i++)
+    {
+        uint8_t lo = (uint8_t)(value % 10);
+        value /= 10;
+        bcd[i] = (uint8_t)(((value % 10) << 4) | lo);
+        value /= 10;
+    }
+}
@@ -0,0 +1,98 @@
+/**
+ *******************************************************************************
+ * @file        meter_record.h
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       검침 레코드 (저장/전송용 고정 16바이트 형식)
+ * @details     MeterData_t(디버그 출력용)를 flash 로그, 업링크, BLE 덤프가
+ *              공통으로 사용하는 고정 크기 레코드로 변환
+ *******************************************************************************
+ */
+
+#ifndef _METER_RECORD_H_
+#define _METER_RECORD_H_
+
+#include "meter_protocol.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//******************************************************************************
+// 레코드 상수 정의
+//******************************************************************************
+
+#define METER_RECORD_SIZE           16          // 레코드 크기 (바이트, 4바이트 정렬)
+
+// 통합 Status 비트 (버전 무관)
+#define METER_REC_Q3_EXCEED         (1U << 0)   // 최대유량 초과 (V1.1은 Q4)
+#define METER_REC_REVERSE_FLOW      (1U << 1)   // 역류 감지
+#define METER_REC_INDOOR_LEAK       (1U << 2)   // 옥내누수
+#define METER_REC_BATT_LOW          (1U << 3)   // 배터리 부족 (V1.1, V1.2)
+#define METER_REC_FREEZE            (1U << 4)   // 동파경고 (V1.1) / 동파경보 (V1.4)
+#define METER_REC_MAGNET            (1U << 5)   // 자석 감지 (V1.4)
+#define METER_REC_UDF               (1U << 6)   // 원본 프레임에 UDF 포함
+#define METER_REC_CHECKSUM_OK       (1U << 7)   // 원본 프레임 체크섬 유효
+#define METER_REC_BATT_CODE_POS     8           // Bit 12-8: 배터리 전압 코드 (V1.3, V1.4)
+#define METER_REC_BATT_CODE_MASK    (0x1FU << METER_REC_BATT_CODE_POS)
+
+// dp_dia 필드
+#define METER_REC_DP_MASK           0x0F        // Bit 3-0: 소수점 자리수
+#define METER_REC_DIA_POS           4           // Bit 7-4: 구경 코드 (DIF 상위 4비트)
+
+//******************************************************************************
+// 레코드 구조체
+//******************************************************************************
+
+// 검침 레코드 (16바이트, 패딩 없음, Little Endian)
+typedef struct
+{
+    uint32_t    timestamp;          // 검침 시각 (초, Meter_RecordTime(): 리셋 후에도 감소하지 않음)
+    uint32_t    meter_id;           // 기물번호 (10진)
+    uint32_t    reading;            // 검침값 (소수점 없는 정수, 실제 값 = reading / 10^dp)
+    uint16_t    status;             // METER_REC_xxx
+    uint8_t     version;            // ProtocolVersion_t (11~14)
+    uint8_t     dp_dia;             // 구경 코드 | 소수점 자리수
+} MeterRecord_t;
+
+// 크기 고정 확인 (컴파일 타임)
+typedef char MeterRecord_SizeCheck_t[(sizeof(MeterRecord_t) == METER_RECORD_SIZE) ? 1 : -1];
+
+//******************************************************************************
+// 레코드 함수 프로토타입
+//******************************************************************************
+
+/**
+ * @brief 파싱 결과를 레코드로 변환
+ * @param data 파싱된 데이터 (parse_success == true)
+ * @param timestamp 검침 시각 (초)
+ * @param rec 레코드 (출력)
+ */
+void Meter_RecordEncode(const MeterData_t* data, uint32_t timestamp, MeterRecord_t* rec);
+
+/**
+ * @brief 레코드를 파싱 결과 형식으로 복원
+ * @param rec 레코드
+ * @param data 복원 결과 (출력, raw_frame/checksum/UDF 세부 값은 복원되지 않음)
+ * @return 레코드 시각 (초)
+ */
+uint32_t Meter_RecordDecode(const MeterRecord_t* rec, MeterData_t* data);
+
+/**
+ * @brief 레코드 시각 기준 설정 (시작 시 저장소 마운트 후 1회)
+ * @param last 저장된 레코드 중 가장 늦은 시각 (초, 저장된 레코드가 없으면 0)
+ * @details RTC가 없으므로 전원이 꺼져 있던 시간은 빠지지만, 리셋 후 레코드 시각이
+ *          저장된 레코드보다 작아지지 않는다 (이력 시각 조회의 이진 탐색 조건).
+ */
+void Meter_RecordTimeInit(uint32_t last);
+
+/**
+ * @brief 현재 레코드 시각 (초, last + 1부터 경과 시간만큼 증가, 감소하지 않음)
+ * @note 밀리초 틱 랩어라운드(49.7일)를 넘기려면 그 안에 한 번 이상 호출해야 한다 (예제: 폴링마다).
+ */
+uint32_t Meter_RecordTime(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _METER_RECORD_H_ */
@@ -0,0 +1,127 @@
+/**
+ *******************************************************************************
+ * @file        meter_retain.c
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       SRAM 유지 영역 (파워다운/웜 리셋 간 상태 보존)
+ * @details     대기 검침 레코드는 변경될 때마다, 링크 통계/스케줄러 상태는
+ *              파워다운 진입 시 봉인한다. 깨어 있는 동안 통계가 바뀐 후 리셋되어도
+ *              대기 검침 레코드 섹션은 유효하게 남는다.
+ *******************************************************************************
+ */
+
+#include "meter_retain.h"
+#include "string.h"
+#include "stddef.h"
+
+//******************************************************************************
+// 내부 함수 선언
+//******************************************************************************
+
+static uint16_t MeterRetain_QueueCRC(const MeterRetainQueue_t* queue);
+static uint16_t MeterRetain_StateCRC(const MeterRetainState_t* state);
+
+//******************************************************************************
+// 함수 구현
+//******************************************************************************
+
+/**
+ * @brief 시작 시 유지 영역 검사
+ * @return 복원된 섹션, 0: 콜드 스타트
+ */
+uint8_t MeterRetain_Restore(void)
+{
+    MeterRetain_t* r = METER_RETAIN;
+    uint8_t restored = 0;
+
+    if (r->magic == METER_RETAIN_MAGIC && r->size == sizeof(MeterRetain_t))
+    {
+        if (r->queue.count <= METER_RETAIN_QUEUE_SIZE && r->queue.crc == MeterRetain_QueueCRC(&r->queue))
+        {
+            restored |= METER_RETAIN_QUEUE_OK;
+        }
+
+        if (r->state.crc == MeterRetain_StateCRC(&r->state))
+        {
+            restored |= METER_RETAIN_STATE_OK;
+        }
+    }
+    else
+    {
+        r->magic = METER_RETAIN_MAGIC;
+        r->size = sizeof(MeterRetain_t);
+    }
+
+    if (!(restored & METER_RETAIN_QUEUE_OK))
+    {
+        memset(&r->queue, 0, sizeof(r->queue));
+    }
+
+    if (!(restored & METER_RETAIN_STATE_OK))
+    {
+        memset(&r->state, 0, sizeof(r->state));
+    }
+    else
+    {
+        r->state.sched.warm_starts++;
+    }
+
+    MeterRetain_Seal();
+
+    Meter_SetLinkStats(r->state.link);
+
+    return restored;
+}
+
+/**
+ * @brief 대기 검침 레코드 섹션 봉인
+ */
+void MeterRetain_SealQueue(void)
+{
+    METER_RETAIN->queue.crc = MeterRetain_QueueCRC(&METER_RETAIN->queue);
+}
+
+/**
+ * @brief 전체 섹션 봉인
+ */
+void MeterRetain_Seal(void)
+{
+    MeterRetain_t* r = METER_RETAIN;
+
+    r->queue.crc = MeterRetain_QueueCRC(&r->queue);
+    r->state.crc = MeterRetain_StateCRC(&r->state);
+}
+
+/**
+ * @brief 유지 영역을 봉인하고 SRAM 유지 전원으로 파워다운 진입
+ */
+void MeterRetain_EnterPowerDown(void)
+{
+    METER_RETAIN->state.sched.sleep_count++;
+    MeterRetain_Seal();
+
+    HAL_PMU_Enable_SRAMRetentionPower();
+    HAL_PWR_EnterPowerDownMode();
+}
+
+//******************************************************************************
+// 내부 함수 구현
+//******************************************************************************
+
+/**
+ * @brief 대기 검침 레코드 섹션 CRC (사용 중인 레코드만)
+ */
+static uint16_t MeterRetain_QueueCRC(const MeterRetainQueue_t* queue)
+{
+    uint16_t crc;
+
+    crc = Meter_CRC16(&queue->count, sizeof(queue->count), 0xFFFF);
+    return Meter_CRC16(queue->rec, (uint16_t)(queue->count * sizeof(MeterRecord_t)), crc);
+}
+
+/**
+ * @brief 링크 통계/스케줄러 상태 섹션 CRC
+ */
+static uint16_t MeterRetain_StateCRC(const MeterRetainState_t* state)
+{
+    return Meter_CRC16(state, (uint16_t)offsetof(MeterRetainState_t, crc), 0xFFFF);
+}
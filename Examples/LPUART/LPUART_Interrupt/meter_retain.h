@@ -0,0 +1,110 @@
+/**
+ *******************************************************************************
+ * @file        meter_retain.h
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       SRAM 유지 영역 (파워다운/웜 리셋 간 상태 보존)
+ * @details     RAM 상위 512바이트를 링커 범위에서 제외하고 고정 주소로 사용한다.
+ *              시작 코드가 0으로 초기화하지 않으므로 파워다운 후 재시작이나
+ *              웜 리셋 후에도 내용이 남고, 섹션별 CRC로 유효성을 판정한다.
+ *******************************************************************************
+ */
+
+#ifndef _METER_RETAIN_H_
+#define _METER_RETAIN_H_
+
+#include "meter_record.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//******************************************************************************
+// 유지 영역 상수 정의
+//******************************************************************************
+
+// 예약 영역 (RAM 상위 512바이트, 링커 IRAM 범위에서 제외해야 함)
+#define METER_RETAIN_ADDR           0x20001E00UL
+#define METER_RETAIN_SIZE           0x200
+
+#define METER_RETAIN_MAGIC          0x314E5452UL    // "RTN1"
+#define METER_RETAIN_QUEUE_SIZE     14              // 대기 검침 레코드 수 (flash 로그 2페이지 분량)
+
+// MeterRetain_Restore() 결과 (복원된 섹션)
+#define METER_RETAIN_QUEUE_OK       0x01            // 대기 검침 레코드
+#define METER_RETAIN_STATE_OK       0x02            // 링크 통계, 스케줄러 상태
+
+//******************************************************************************
+// 유지 영역 구조체
+//******************************************************************************
+
+// 대기 검침 레코드 (flash 로그에 아직 기록되지 않은 레코드)
+typedef struct
+{
+    uint16_t            count;                      // 레코드 수
+    uint16_t            crc;                        // CRC-16 (count, rec[0..count))
+    MeterRecord_t       rec[METER_RETAIN_QUEUE_SIZE];
+} MeterRetainQueue_t;
+
+// 스케줄러 상태
+typedef struct
+{
+    uint32_t            poll_count;                 // 검침 폴링 횟수
+    uint32_t            sleep_count;                // 파워다운 진입 횟수
+    uint32_t            warm_starts;                // 유지 영역 복원 후 시작 횟수
+} MeterSchedState_t;
+
+// 링크 통계 + 스케줄러 상태 (파워다운 진입 시 봉인)
+typedef struct
+{
+    METER_LINK_STATS_Type   link[METER_PORT_MAX];
+    MeterSchedState_t       sched;
+    uint16_t                reserved;
+    uint16_t                crc;                    // CRC-16 (crc 필드 앞까지)
+} MeterRetainState_t;
+
+// 유지 영역 배치
+typedef struct
+{
+    uint32_t            magic;                      // METER_RETAIN_MAGIC
+    uint32_t            size;                       // sizeof(MeterRetain_t) (배치 변경 시 무효)
+    MeterRetainQueue_t  queue;
+    MeterRetainState_t  state;
+} MeterRetain_t;
+
+typedef char MeterRetain_SizeCheck_t[(sizeof(MeterRetain_t) <= METER_RETAIN_SIZE) ? 1 : -1];
+
+#define METER_RETAIN                ((MeterRetain_t*)METER_RETAIN_ADDR)
+
+//******************************************************************************
+// 유지 영역 함수 프로토타입
+//******************************************************************************
+
+/**
+ * @brief 시작 시 유지 영역 검사 (main 초기화 초기에 1회 호출)
+ * @return 복원된 섹션 (METER_RETAIN_QUEUE_OK | METER_RETAIN_STATE_OK), 0: 콜드 스타트
+ * @details 헤더 또는 섹션 CRC가 맞지 않는 섹션은 0으로 초기화하여 봉인한다.
+ *          링크 통계 저장 위치를 유지 영역으로 지정한다 (Meter_SetLinkStats).
+ */
+uint8_t MeterRetain_Restore(void);
+
+/**
+ * @brief 대기 검침 레코드 섹션 봉인 (큐 변경 후 호출)
+ */
+void MeterRetain_SealQueue(void);
+
+/**
+ * @brief 전체 섹션 봉인
+ */
+void MeterRetain_Seal(void);
+
+/**
+ * @brief 유지 영역을 봉인하고 SRAM 유지 전원으로 파워다운 진입
+ * @note 웨이크업 소스는 호출 전에 설정, 웨이크업 후 반환
+ */
+void MeterRetain_EnterPowerDown(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _METER_RETAIN_H_ */
@@ -0,0 +1,147 @@
+/**
+ *******************************************************************************
+ * @file        meter_trace.c
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       지연 포맷 바이너리 트레이스 로그
+ * @details     target: 레코드당 워드 저장 몇 번 (vsprintf, 문자열 버퍼 사용 안 함)
+ *              host:   tools/trace_decode.py <elf> <capture>
+ *******************************************************************************
+ */
+
+#include "meter_trace.h"
+#include "meter_protocol.h"
+#include "A31L12x_hal_debug_frmwrk.h"
+
+//******************************************************************************
+// 전역 변수
+//******************************************************************************
+
+static uint32_t g_trace_buf[TRACE_BUF_WORDS];
+static uint16_t g_trace_head = 0;               // 다음 기록 위치 (Trace_Write)
+static volatile uint16_t g_trace_tail = 0;      // 다음 덤프 위치 (Trace_Dump)
+static volatile uint16_t g_trace_drops = 0;     // 링 가득 참으로 버린 레코드 수
+
+#define TRACE_MASK      (TRACE_BUF_WORDS - 1)
+
+//******************************************************************************
+// 내부 함수 선언
+//******************************************************************************
+
+static void Trace_PutWord(uint32_t word);
+
+//******************************************************************************
+// 함수 구현
+//******************************************************************************
+
+/**
+ * @brief 트레이스 레코드 기록
+ * @param fmt 포맷 문자열 (flash)
+ * @param nargs 인자 수 (0~TRACE_MAX_ARGS)
+ * @param a0 ~ a3 인자
+ */
+void Trace_Write(const char* fmt, uint32_t nargs, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3)
+{
+    uint32_t args[TRACE_MAX_ARGS] = { a0, a1, a2, a3 };
+    uint32_t primask;
+    uint32_t i;
+    uint16_t head;
+    uint16_t used;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    head = g_trace_head;
+    used = (uint16_t)((head - g_trace_tail) & TRACE_MASK);
+
+    // 빈 칸 1워드는 가득 참/비어 있음 구분용
+    if (used + 2 + nargs > TRACE_BUF_WORDS - 1)
+    {
+        g_trace_drops++;
+        __set_PRIMASK(primask);
+        return;
+    }
+
+    g_trace_buf[head] = ((uint32_t)fmt & TRACE_ADDR_MASK) | (nargs << TRACE_NARGS_POS);
+    head = (head + 1) & TRACE_MASK;
+    g_trace_buf[head] = Meter_GetTickMs();
+    head = (head + 1) & TRACE_MASK;
+
+    for (i = 0; i < nargs; i++)
+    {
+        g_trace_buf[head] = args[i];
+        head = (head + 1) & TRACE_MASK;
+    }
+
+    g_trace_head = head;
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 링에 쌓인 레코드를 디버그 포트로 바이너리 덤프 후 비움
+ * @details 덤프 시작 시점까지의 레코드만 출력한다. 출력 중 기록되는 레코드는
+ *          다음 덤프에 포함되며, 출력 중인 구간은 tail 갱신 전까지 덮어쓰이지 않는다.
+ */
+void Trace_Dump(void)
+{
+    uint32_t primask;
+    uint16_t head;
+    uint16_t tail;
+    uint16_t drops;
+    uint16_t count;
+#ifdef _DEBUG_MSG_BUFFERED
+    FunctionalState buffered;
+#endif
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    head = g_trace_head;
+    drops = g_trace_drops;
+    g_trace_drops = 0;
+    __set_PRIMASK(primask);
+
+    tail = g_trace_tail;
+    count = (uint16_t)((head - tail) & TRACE_MASK);
+
+#ifdef _DEBUG_MSG_BUFFERED
+    // 덤프는 링 크기를 넘을 수 있으므로 블로킹 출력으로 전환
+    buffered = debug_frmwrk_buffered(DISABLE);
+#endif
+
+    _DBG(TRACE_DUMP_SYNC);
+    _DBC((uint8_t)count);
+    _DBC((uint8_t)(count >> 8));
+    _DBC((uint8_t)drops);
+    _DBC((uint8_t)(drops >> 8));
+
+    while (tail != head)
+    {
+        Trace_PutWord(g_trace_buf[tail]);
+        tail = (tail + 1) & TRACE_MASK;
+    }
+
+    g_trace_tail = tail;
+
+#ifdef _DEBUG_MSG_BUFFERED
+    debug_frmwrk_buffered(buffered);
+#endif
+}
+
+/**
+ * @brief 링이 가득 차서 버린 레코드 수 (마지막 덤프 이후)
+ */
+uint16_t Trace_GetDrops(void)
+{
+    return g_trace_drops;
+}
+
+/**
+ * @brief 32비트 워드 출력 (Little Endian)
+ */
+static void Trace_PutWord(uint32_t word)
+{
+    _DBC((uint8_t)word);
+    _DBC((uint8_t)(word >> 8));
+    _DBC((uint8_t)(word >> 16));
+    _DBC((uint8_t)(word >> 24));
+}
@@ -0,0 +1,76 @@
+/**
+ *******************************************************************************
+ * @file        meter_trace.h
+ * @author      Seoul Digital Water Meter Protocol Implementation
+ * @brief       지연 포맷 바이너리 트레이스 로그
+ * @details     호출 위치는 포맷 문자열 주소 + 타임스탬프 + 인자만 RAM 링에 기록하고,
+ *              문자열 변환은 호스트(tools/trace_decode.py)가 ELF의 포맷 문자열로 수행
+ *******************************************************************************
+ */
+
+#ifndef _METER_TRACE_H_
+#define _METER_TRACE_H_
+
+#include "main_conf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//******************************************************************************
+// 트레이스 상수 정의
+//******************************************************************************
+
+#define TRACE_BUF_WORDS             128         // 링 크기 (32비트 워드, 2의 거듭제곱)
+#define TRACE_MAX_ARGS              4           // 레코드당 최대 인자 수
+
+// 레코드 (32비트 워드, Little Endian)
+//   [0] 포맷 문자열 주소 (Bit 27-0) | 인자 수 (Bit 31-28)
+//   [1] 타임스탬프 (ms, Meter_GetTickMs())
+//   [2..] 인자 (32비트 정수 또는 flash 문자열 주소)
+#define TRACE_ADDR_MASK             0x0FFFFFFFUL
+#define TRACE_NARGS_POS             28
+
+// 덤프 블록: "TRC1" + 워드 수(uint16) + 드롭 레코드 수(uint16) + 레코드 워드
+#define TRACE_DUMP_SYNC             "TRC1"
+
+//******************************************************************************
+// 트레이스 매크로
+//******************************************************************************
+
+// fmt는 문자열 리터럴 (flash 상주), %s 인자는 flash 문자열만 사용
+#define TRACE0(fmt)                 Trace_Write((fmt), 0, 0, 0, 0, 0)
+#define TRACE1(fmt, a)              Trace_Write((fmt), 1, (uint32_t)(a), 0, 0, 0)
+#define TRACE2(fmt, a, b)           Trace_Write((fmt), 2, (uint32_t)(a), (uint32_t)(b), 0, 0)
+#define TRACE3(fmt, a, b, c)        Trace_Write((fmt), 3, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c), 0)
+#define TRACE4(fmt, a, b, c, d)     Trace_Write((fmt), 4, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c), (uint32_t)(d))
+
+//******************************************************************************
+// 트레이스 함수 프로토타입
+//******************************************************************************
+
+/**
+ * @brief 트레이스 레코드 기록 (TRACEn 매크로 사용)
+ * @param fmt 포맷 문자열 (flash)
+ * @param nargs 인자 수 (0~TRACE_MAX_ARGS)
+ * @param a0 ~ a3 인자
+ * @note 인터럽트 포함 어느 문맥에서나 호출 가능, 링이 가득 차면 레코드를 버리고 드롭 수 증가
+ */
+void Trace_Write(const char* fmt, uint32_t nargs, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3);
+
+/**
+ * @brief 링에 쌓인 레코드를 디버그 포트로 바이너리 덤프 후 비움
+ * @note 블로킹 출력, 메인 루프에서만 호출
+ */
+void Trace_Dump(void);
+
+/**
+ * @brief 링이 가득 차서 버린 레코드 수
+ */
+uint16_t Trace_GetDrops(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _METER_TRACE_H_ */
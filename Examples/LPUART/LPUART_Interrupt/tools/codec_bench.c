@@ -0,0 +1,217 @@
+/*
+ * Host benchmark for meter_codec.c (delta + zigzag-varint reading series).
+ *
+ * Build (from the example directory):
+ *     gcc -O2 -I. tools/codec_bench.c meter_codec.c -o codec_bench
+ *
+ * Usage:
+ *     codec_bench <capture.txt>
+ *
+ * The capture is debug UART text printed by 'h' (NOR history) on the target.
+ * Several captures may be concatenated. Lines that are not history records are
+ * ignored:
+ *     #<index> [<timestamp> s] V<ver> ID <meter id>: <int>.<frac> m3, status 0x<hex>
+ *
+ * Readings are grouped per meter ID and compressed into blocks of at most
+ * BLOCK_SIZE bytes (a new block starts when one is full), then decoded again
+ * and compared. The report shows the compression ratio against
+ * the 16-byte stored record and the host time per record.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "meter_codec.h"
+
+#define MAX_RECORDS     200000
+#define RECORD_SIZE     16          /* METER_RECORD_SIZE */
+#define BENCH_ROUNDS    100
+#define BLOCK_SIZE      4096        /* one NOR sector */
+
+typedef struct
+{
+    unsigned long       meter_id;
+    MeterCodecSample_t  sample;
+} Record;
+
+static Record g_rec[MAX_RECORDS];
+static MeterCodecSample_t g_series[MAX_RECORDS];
+static uint8_t g_block[MAX_RECORDS * (METER_CODEC_MAX_RECORD + METER_CODEC_HEADER_SIZE)];
+
+/* Encode a series into consecutive blocks, returns total length */
+static size_t encode_series(const MeterCodecSample_t* series, size_t count, uint32_t id, size_t* blocks)
+{
+    MeterCodecEncoder_t enc;
+    size_t pos = 0;
+    size_t i;
+
+    *blocks = 1;
+    MeterCodec_EncodeBegin(&enc, g_block, BLOCK_SIZE, id, 0);
+
+    for (i = 0; i < count; i++)
+    {
+        if (MeterCodec_EncodeAdd(&enc, &series[i]) == METER_CODEC_ERR_FULL)
+        {
+            pos += MeterCodec_EncodeEnd(&enc);
+            MeterCodec_EncodeBegin(&enc, &g_block[pos], BLOCK_SIZE, id, 0);
+            (*blocks)++;
+            if (MeterCodec_EncodeAdd(&enc, &series[i]) != METER_CODEC_OK)
+            {
+                fprintf(stderr, "ID %08lu: record %zu not encoded\n", (unsigned long)id, i);
+                exit(1);
+            }
+        }
+    }
+
+    return pos + MeterCodec_EncodeEnd(&enc);
+}
+
+/* Decode consecutive blocks and compare, returns number of mismatches */
+static int verify_series(const MeterCodecSample_t* series, size_t count, uint32_t id, size_t len)
+{
+    MeterCodecDecoder_t dec;
+    MeterCodecSample_t out;
+    size_t pos = 0;
+    size_t i = 0;
+
+    while (pos < len)
+    {
+        if (MeterCodec_DecodeBegin(&dec, &g_block[pos], (uint16_t)(len - pos > BLOCK_SIZE ? BLOCK_SIZE : len - pos))
+                != METER_CODEC_OK || dec.series_id != id)
+        {
+            return 1;
+        }
+
+        while (MeterCodec_DecodeNext(&dec, &out) == METER_CODEC_OK)
+        {
+            if (i >= count || out.timestamp != series[i].timestamp || out.reading != series[i].reading ||
+                out.status != series[i].status)
+            {
+                return 1;
+            }
+            i++;
+        }
+
+        if (dec.index != dec.count)
+        {
+            return 1;
+        }
+        pos += dec.pos;
+    }
+
+    return (i == count) ? 0 : 1;
+}
+
+static size_t load_capture(const char* path)
+{
+    char line[256];
+    FILE* f = fopen(path, "r");
+    size_t n = 0;
+
+    if (f == NULL)
+    {
+        perror(path);
+        exit(2);
+    }
+
+    while (n < MAX_RECORDS && fgets(line, sizeof(line), f) != NULL)
+    {
+        unsigned long index, stamp, id, ipart;
+        unsigned int ver, status;
+        char frac[12];
+        const char* p = strchr(line, '#');
+        unsigned long scale = 1;
+        size_t i;
+
+        if (p == NULL ||
+            sscanf(p, "#%lu [%lu s] V%u ID %lu: %lu.%11[0-9] m3, status 0x%x",
+                   &index, &stamp, &ver, &id, &ipart, frac, &status) != 7)
+        {
+            continue;
+        }
+
+        for (i = 0; i < strlen(frac); i++)
+        {
+            scale *= 10;
+        }
+
+        g_rec[n].meter_id = id;
+        g_rec[n].sample.timestamp = (uint32_t)stamp;
+        g_rec[n].sample.reading = (uint32_t)(ipart * scale + strtoul(frac, NULL, 10));
+        g_rec[n].sample.status = (uint16_t)status;
+        n++;
+    }
+
+    fclose(f);
+
+    return n;
+}
+
+int main(int argc, char** argv)
+{
+    size_t total;
+    size_t done = 0;
+    size_t raw = 0;
+    size_t packed = 0;
+    double seconds = 0;
+    int errors = 0;
+    static unsigned char used[MAX_RECORDS];
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: %s <capture.txt>\n", argv[0]);
+        return 2;
+    }
+
+    total = load_capture(argv[1]);
+    if (total == 0)
+    {
+        fprintf(stderr, "no history records found\n");
+        return 1;
+    }
+
+    while (done < total)
+    {
+        unsigned long id = 0;
+        size_t count = 0;
+        size_t blocks = 0;
+        size_t len = 0;
+        size_t i;
+        clock_t start;
+        int round;
+
+        /* Next meter: all its records in capture order */
+        for (i = 0; i < total; i++)
+        {
+            if (!used[i] && (count == 0 || g_rec[i].meter_id == id))
+            {
+                id = g_rec[i].meter_id;
+                g_series[count++] = g_rec[i].sample;
+                used[i] = 1;
+            }
+        }
+        done += count;
+
+        start = clock();
+        for (round = 0; round < BENCH_ROUNDS; round++)
+        {
+            len = encode_series(g_series, count, (uint32_t)id, &blocks);
+        }
+        seconds += (double)(clock() - start) / CLOCKS_PER_SEC / BENCH_ROUNDS;
+
+        errors += verify_series(g_series, count, (uint32_t)id, len);
+
+        printf("ID %08lu: %zu readings, %zu blocks, %zu bytes (%.2f bytes/reading)\n",
+               id, count, blocks, len, (double)len / count);
+
+        raw += count * RECORD_SIZE;
+        packed += len;
+    }
+
+    printf("Total: %zu readings, %zu -> %zu bytes, ratio %.2f:1, encode %.1f ns/reading\n",
+           total, raw, packed, (double)raw / packed, seconds * 1e9 / total);
+    printf(errors ? "Round trip FAILED\n" : "Round trip OK\n");
+
+    return errors ? 1 : 0;
+}
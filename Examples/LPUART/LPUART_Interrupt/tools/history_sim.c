@@ -0,0 +1,723 @@
+/*
+ * Host simulation for meter_history.c (NOR reading history, time index) and
+ * meter_nor_cache.c (page cache with readahead) on a RAM model of the P25Q16.
+ *
+ * Build (from the example directory):
+ *     gcc -O2 -D__A31L12x_CONF_H -include tools/sim_host.h -I. tools/history_sim.c tools/sim_host.c -o history_sim
+ *
+ * Usage:
+ *     history_sim [appends] [seed]       (default 200000 appends, seed 1)
+ *
+ * meter_history.c and meter_nor_cache.c are included into this file so their
+ * static state can be cleared on every simulated reset. meter_nor.c is
+ * replaced by a model with the same API: operations complete after a random
+ * number of MeterNor_Task() polls, program is AND (1 -> 0) and must stay in
+ * one 256-byte page, erase sets a 4 KB sector to 0xFF.
+ *
+ * 1. Power cuts: appends mixed with reads while the ring wraps. A cut is
+ *    injected inside a random program or erase, and some programs report a
+ *    failure (timeout). A cut or failed program leaves a random run of its
+ *    bytes programmed, some only partly (the page program order is not
+ *    guaranteed). After every mount a full scan must return each record
+ *    exactly as written, in order: a torn record that is read back as a
+ *    record is a failure. Records may be missing only if they were still in
+ *    the RAM queue at a cut.
+ * 2. Time lookup: random stamp gaps (repeats, hours, days), clean reboots and
+ *    a ring wrap. MeterHistory_Find() must return the slot of the first
+ *    scanned record with stamp >= t (brute force). Then index entries are
+ *    zeroed and the queries are repeated through the fallback path.
+ * 3. Full scan in HISTORY_SCAN_BURST (main.c) steps with the cache counters.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+
+#include "meter_history.h"
+#include "meter_nor_cache.h"
+
+#include "../meter_history.c"
+#include "../meter_nor_cache.c"
+
+#define CUT_INTERVAL        300     /* mean record programs between power cuts */
+#define SECTOR_CUT_ONE_IN   4       /* erases, sector headers and index entries (rare, so cut more often) */
+#define FAIL_ONE_IN         500     /* page program reported as failed (timeout), bytes partly written */
+#define READ_ONE_IN         20      /* history read between appends */
+#define QUERIES             12000
+#define CORRUPT_ENTRIES     50
+#define SCAN_BURST          (METER_NOR_PAGE_SIZE / METER_RECORD_SIZE)  /* main.c HISTORY_SCAN_BURST */
+
+#define NOR_OP_NONE         0
+#define NOR_OP_READ         1
+#define NOR_OP_PROGRAM      2
+#define NOR_OP_ERASE        3
+
+static uint8_t g_nor[METER_NOR_SIZE];
+
+static struct
+{
+    uint8_t             op;
+    uint32_t            addr;
+    uint8_t*            rd;
+    const uint8_t*      wr;
+    uint16_t            len;
+    uint8_t             polls;
+    MeterNorCallback_t  done;
+} g_nor_op;
+
+static METER_NOR_ERROR_Type g_nor_result;
+static MeterNorStats_t g_nor_stats;
+static bool g_cuts;
+static long g_cut_countdown;
+static jmp_buf g_power_cut;
+
+static uint32_t* g_stamp;           /* per id: timestamp written */
+static uint8_t* g_lost;             /* per id: in the RAM queue at a cut */
+static uint32_t g_last_id;
+static uint32_t g_time;
+
+static MeterRecord_t* g_scan;       /* full scan buffer (committed records) */
+static uint32_t* g_scan_slot;       /* slot index of each scanned record */
+static uint32_t g_scan_count;
+
+static struct
+{
+    unsigned long   program_cuts;
+    unsigned long   program_fails;
+    unsigned long   erase_cuts;
+    unsigned long   resets;
+    unsigned long   lost;
+    unsigned long   reads;
+    unsigned long   scans;
+    unsigned long   failures;
+} g_sim;
+
+static void Sim_Fail(const char* what, uint32_t a, uint32_t b)
+{
+    if (g_sim.failures++ < 20)
+    {
+        printf("FAIL: %s (%lu, %lu)\n", what, (unsigned long)a, (unsigned long)b);
+    }
+}
+
+//******************************************************************************
+// NOR model (meter_nor.h API)
+//******************************************************************************
+
+static void Sim_NorStart(uint8_t op, uint32_t addr, uint16_t len, MeterNorCallback_t done)
+{
+    g_nor_op.op = op;
+    g_nor_op.addr = addr;
+    g_nor_op.len = len;
+    g_nor_op.polls = (uint8_t)Sim_RandBelow(3);
+    g_nor_op.done = done;
+}
+
+/* Cut this program/erase? Sector operations are a few per 253 records, so they get their own rate */
+static bool Sim_CutNow(void)
+{
+    if (!g_cuts)
+    {
+        return false;
+    }
+
+    if (g_nor_op.op == NOR_OP_ERASE || g_nor_op.addr % METER_NOR_SECTOR_SIZE == 0 ||
+        g_nor_op.addr >= METER_HISTORY_INDEX_ADDR)
+    {
+        return Sim_RandBelow(SECTOR_CUT_ONE_IN) == 0;
+    }
+
+    return --g_cut_countdown <= 0;
+}
+
+static void Sim_PowerCut(void)
+{
+    g_cut_countdown = 1 + (long)Sim_RandBelow(2 * CUT_INTERVAL);
+    longjmp(g_power_cut, 1);
+}
+
+/* Program cut or failed: a random run of bytes partly or fully programmed, the rest untouched */
+static void Sim_TearProgram(void)
+{
+    uint32_t i = Sim_RandBelow(g_nor_op.len + 1);
+    uint32_t end = i + Sim_RandBelow(g_nor_op.len - i + 1);
+
+    for (; i < end; i++)
+    {
+        g_nor[g_nor_op.addr + i] &= g_nor_op.wr[i] | (Sim_RandBelow(2) ? (uint8_t)Sim_Rand() : 0);
+    }
+}
+
+static METER_NOR_ERROR_Type Sim_NorFinish(void)
+{
+    uint32_t i;
+    uint32_t n;
+
+    switch (g_nor_op.op)
+    {
+    case NOR_OP_READ:
+        memcpy(g_nor_op.rd, &g_nor[g_nor_op.addr], g_nor_op.len);
+        break;
+
+    case NOR_OP_PROGRAM:
+        if (Sim_CutNow())
+        {
+            Sim_TearProgram();
+            g_sim.program_cuts++;
+            Sim_PowerCut();
+        }
+        if (Sim_RandBelow(FAIL_ONE_IN) == 0)
+        {
+            Sim_TearProgram();
+            g_sim.program_fails++;
+            return METER_NOR_ERR_TIMEOUT;
+        }
+        for (i = 0; i < g_nor_op.len; i++)
+        {
+            g_nor[g_nor_op.addr + i] &= g_nor_op.wr[i];
+        }
+        break;
+
+    case NOR_OP_ERASE:
+        if (Sim_CutNow())
+        {
+            /* Untouched, partly erased or fully erased */
+            n = Sim_RandBelow(3);
+            for (i = 0; n != 0 && i < METER_NOR_SECTOR_SIZE; i++)
+            {
+                g_nor[g_nor_op.addr + i] = (n == 2 || Sim_RandBelow(2)) ? 0xFF : g_nor[g_nor_op.addr + i] | (uint8_t)Sim_Rand();
+            }
+            g_sim.erase_cuts++;
+            Sim_PowerCut();
+        }
+        memset(&g_nor[g_nor_op.addr], 0xFF, METER_NOR_SECTOR_SIZE);
+        break;
+    }
+
+    return METER_NOR_OK;
+}
+
+METER_NOR_ERROR_Type MeterNor_Init(void)
+{
+    memset(&g_nor_op, 0, sizeof(g_nor_op));
+    g_nor_result = METER_NOR_OK;
+    return METER_NOR_OK;
+}
+
+METER_NOR_ERROR_Type MeterNor_StartRead(uint32_t addr, uint8_t* buf, uint16_t len, MeterNorCallback_t done)
+{
+    if (g_nor_op.op != NOR_OP_NONE)
+    {
+        return METER_NOR_ERR_BUSY;
+    }
+    if (len == 0 || len > METER_NOR_DMA_MAX || addr >= METER_NOR_SIZE || len > METER_NOR_SIZE - addr)
+    {
+        return METER_NOR_ERR_PARAM;
+    }
+
+    g_nor_op.rd = buf;
+    Sim_NorStart(NOR_OP_READ, addr, len, done);
+    g_nor_stats.reads++;
+    g_nor_stats.read_bytes += len;
+    return METER_NOR_OK;
+}
+
+METER_NOR_ERROR_Type MeterNor_StartProgram(uint32_t addr, const uint8_t* buf, uint16_t len, MeterNorCallback_t done)
+{
+    if (g_nor_op.op != NOR_OP_NONE)
+    {
+        return METER_NOR_ERR_BUSY;
+    }
+    if (len == 0 || len > METER_NOR_PAGE_SIZE || addr >= METER_NOR_SIZE ||
+        addr % METER_NOR_PAGE_SIZE + len > METER_NOR_PAGE_SIZE)
+    {
+        Sim_Fail("program crosses a page", addr, len);
+        return METER_NOR_ERR_PARAM;
+    }
+
+    g_nor_op.wr = buf;
+    Sim_NorStart(NOR_OP_PROGRAM, addr, len, done);
+    g_nor_stats.programs++;
+    return METER_NOR_OK;
+}
+
+METER_NOR_ERROR_Type MeterNor_StartErase(uint32_t addr, MeterNorCallback_t done)
+{
+    if (g_nor_op.op != NOR_OP_NONE)
+    {
+        return METER_NOR_ERR_BUSY;
+    }
+    if (addr >= METER_NOR_SIZE)
+    {
+        return METER_NOR_ERR_PARAM;
+    }
+
+    Sim_NorStart(NOR_OP_ERASE, addr - addr % METER_NOR_SECTOR_SIZE, 0, done);
+    g_nor_stats.erases++;
+    return METER_NOR_OK;
+}
+
+METER_NOR_ERROR_Type MeterNor_Wait(void)
+{
+    while (g_nor_op.op != NOR_OP_NONE)
+    {
+        MeterNor_Task();
+    }
+
+    return g_nor_result;
+}
+
+void MeterNor_Task(void)
+{
+    MeterNorCallback_t done;
+
+    if (g_nor_op.op == NOR_OP_NONE)
+    {
+        return;
+    }
+    if (g_nor_op.polls != 0)
+    {
+        g_nor_op.polls--;
+        return;
+    }
+
+    g_nor_result = Sim_NorFinish();
+
+    // 유휴로 돌린 뒤 통지 (meter_nor.c와 같음)
+    done = g_nor_op.done;
+    g_nor_op.op = NOR_OP_NONE;
+    g_nor_op.done = NULL;
+
+    if (done != NULL)
+    {
+        done(g_nor_result);
+    }
+}
+
+bool MeterNor_PowerDown(void)
+{
+    return g_nor_op.op == NOR_OP_NONE;
+}
+
+bool MeterNor_IsBusy(void)
+{
+    return g_nor_op.op != NOR_OP_NONE;
+}
+
+const MeterNorStats_t* MeterNor_GetStats(void)
+{
+    return &g_nor_stats;
+}
+
+void MeterNor_DmaHandler(void)
+{
+}
+
+//******************************************************************************
+// Simulation
+//******************************************************************************
+
+/* Record contents derived from the id, so any torn or stale record shows up */
+static void Sim_MakeRecord(uint32_t id, MeterRecord_t* rec)
+{
+    rec->timestamp = g_stamp[id];
+    rec->meter_id = id;
+    rec->reading = id * 2654435761UL;
+    rec->status = (uint16_t)(id ^ 0x5A5A);
+    rec->version = (uint8_t)(11 + id % 4);
+    rec->dp_dia = (uint8_t)(id >> 8);
+}
+
+static bool Sim_RecordOk(const MeterRecord_t* rec)
+{
+    MeterRecord_t ref;
+
+    if (rec->meter_id == 0 || rec->meter_id > g_last_id)
+    {
+        return false;
+    }
+
+    Sim_MakeRecord(rec->meter_id, &ref);
+    return memcmp(rec, &ref, sizeof(ref)) == 0;
+}
+
+/* Static state of meter_history.c and meter_nor_cache.c after a reset */
+static void Sim_ResetState(void)
+{
+    g_hist_mounted = false;
+    g_hist_seq = 0;
+    g_hist_used = 0;
+    g_hist_head_recs = 0;
+    g_hist_sectors = 0;
+    g_hist_op = HIST_OP_NONE;
+    g_hist_prog = 0;
+    g_hist_count = 0;
+    memset(&g_hist_stats, 0, sizeof(g_hist_stats));
+    g_hist_read_error = false;
+    g_hist_head_first = 0;
+    g_hist_head_last = 0;
+    g_hist_index_pending = false;
+    g_hist_commit_pending = false;
+    g_hist_map_seq = 0;
+
+    memset(g_cache_slot, 0, sizeof(g_cache_slot));
+    g_cache_clock = 0;
+    g_cache_loading = CACHE_NONE;
+    g_cache_stale = false;
+    g_cache_last = CACHE_NO_PAGE;
+    g_cache_seq = false;
+    g_cache_result = METER_NOR_OK;
+    memset(&g_cache_stats, 0, sizeof(g_cache_stats));
+
+    (void)MeterNor_Init();
+}
+
+/*
+ * Read the whole history through the cache into g_scan, burst records per call. MeterHistory_Read() skips
+ * uncommitted slots; with burst 1 the index ends right after the record read, which gives its slot.
+ */
+static void Sim_Scan(uint16_t burst)
+{
+    uint32_t total = MeterHistory_GetCount();
+    uint32_t index = 0;
+    uint16_t n;
+
+    g_scan_count = 0;
+
+    while (index < total)
+    {
+        n = MeterHistory_Read(&index, &g_scan[g_scan_count], burst);
+        if (n == 0)
+        {
+            if (index < total)
+            {
+                Sim_Fail("history read stopped", index, total);
+            }
+            break;
+        }
+
+        if (burst == 1)
+        {
+            g_scan_slot[g_scan_count] = index - 1;
+        }
+        g_scan_count += n;
+    }
+
+    g_sim.scans++;
+}
+
+/* Scan after mount: every intact record as written, in order, gaps only where records were lost */
+static void Sim_Verify(void)
+{
+    uint32_t prev = 0;
+    uint32_t index;
+    uint32_t id;
+
+    Sim_Scan(SCAN_BURST);
+
+    for (index = 0; index < g_scan_count; index++)
+    {
+        if (!Sim_RecordOk(&g_scan[index]))
+        {
+            Sim_Fail("corrupt record", index, g_scan[index].meter_id);
+            continue;
+        }
+
+        id = g_scan[index].meter_id;
+        if (prev != 0)
+        {
+            if (id <= prev)
+            {
+                Sim_Fail("record out of order", id, prev);
+            }
+            for (prev++; prev < id; prev++)
+            {
+                if (!g_lost[prev])
+                {
+                    Sim_Fail("record lost", prev, id);
+                }
+            }
+        }
+        prev = id;
+    }
+}
+
+static void Sim_Boot(bool verify)
+{
+    uint8_t i;
+
+    /* The RAM queue dies with the reset */
+    for (i = 0; i < g_hist_count; i++)
+    {
+        if (!g_lost[g_hist_queue[i].meter_id])
+        {
+            g_lost[g_hist_queue[i].meter_id] = 1;
+            g_sim.lost++;
+        }
+    }
+
+    Sim_ResetState();
+
+    if (MeterHistory_Mount() == 0 && g_hist_read_error)
+    {
+        Sim_Fail("mount read error", 0, 0);
+    }
+
+    if (verify)
+    {
+        Sim_Verify();
+    }
+}
+
+/* Main loop between two readings: run the NOR and history tasks a few times */
+static void Sim_Poll(void)
+{
+    uint8_t n = (uint8_t)(1 + Sim_RandBelow(4));
+
+    while (n--)
+    {
+        MeterNor_Task();
+        MeterHistory_Task();
+    }
+}
+
+static void Sim_Drain(void)
+{
+    while (MeterHistory_GetPending() != 0 || g_hist_index_pending || g_hist_op != HIST_OP_NONE || MeterNor_IsBusy())
+    {
+        MeterNor_Task();
+        MeterHistory_Task();
+    }
+}
+
+static void Sim_Append(void)
+{
+    MeterRecord_t rec;
+    uint32_t r = Sim_RandBelow(100);
+
+    /* Repeated stamps, hourly readings and the odd outage of days */
+    g_time += (r < 10) ? 0 : (r < 99) ? 1 + Sim_RandBelow(7200) : 86400 * (1 + Sim_RandBelow(5));
+    g_stamp[g_last_id + 1] = g_time;
+    Sim_MakeRecord(g_last_id + 1, &rec);
+
+    /* The id counts as written once the queue takes it (a cut while waiting drops it unseen) */
+    while (MeterHistory_Append(&rec) == METER_HISTORY_ERR_QUEUE_FULL)
+    {
+        Sim_Poll();
+    }
+    g_last_id++;
+}
+
+/* A few records from a random place while the writer is running */
+static void Sim_RandomRead(void)
+{
+    MeterRecord_t rec[SCAN_BURST];
+    uint32_t total = MeterHistory_GetCount();
+    uint32_t index;
+    uint16_t n;
+    uint16_t i;
+
+    if (total == 0)
+    {
+        return;
+    }
+
+    index = Sim_RandBelow(total);
+    n = MeterHistory_Read(&index, rec, (uint16_t)(1 + Sim_RandBelow(SCAN_BURST)));
+    g_sim.reads++;
+
+    for (i = 0; i < n; i++)
+    {
+        if (!Sim_RecordOk(&rec[i]))
+        {
+            Sim_Fail("corrupt record read while writing", index, rec[i].meter_id);
+        }
+    }
+}
+
+static void Sim_PowerCutRun(unsigned long appends)
+{
+    g_cuts = true;
+    g_cut_countdown = 1 + (long)Sim_RandBelow(2 * CUT_INTERVAL);
+
+    if (setjmp(g_power_cut) != 0)
+    {
+        g_sim.resets++;
+        Sim_Boot(true);
+    }
+
+    while (g_last_id < appends)
+    {
+        Sim_Append();
+        Sim_Poll();
+
+        if (Sim_RandBelow(READ_ONE_IN) == 0)
+        {
+            Sim_RandomRead();
+        }
+    }
+
+    Sim_Drain();
+    g_cuts = false;
+
+    Sim_Boot(true);
+
+    printf("power cuts: %lu appends, %lu resets (%lu in program, %lu in erase), %lu failed programs, %lu reads while writing\n",
+           appends, g_sim.resets, g_sim.program_cuts, g_sim.erase_cuts, g_sim.program_fails, g_sim.reads);
+    printf("  %lu records stored, %lu uncommitted slots skipped, %lu lost from the RAM queue, %lu full scans\n",
+           (unsigned long)g_scan_count, (unsigned long)(MeterHistory_GetCount() - g_scan_count), g_sim.lost,
+           g_sim.scans);
+}
+
+/* Slot of the first scanned record with stamp >= t (MeterHistory_GetCount() if none) */
+static uint32_t Sim_LowerBound(uint32_t t)
+{
+    uint32_t lo = 0;
+    uint32_t hi = g_scan_count;
+    uint32_t mid;
+
+    while (lo < hi)
+    {
+        mid = lo + (hi - lo) / 2;
+        if (g_scan[mid].timestamp >= t)
+        {
+            hi = mid;
+        }
+        else
+        {
+            lo = mid + 1;
+        }
+    }
+
+    return lo;
+}
+
+static void Sim_Queries(const char* title)
+{
+    unsigned long reads = g_nor_stats.reads;
+    uint32_t first = g_scan[0].timestamp;
+    uint32_t last = g_scan[g_scan_count - 1].timestamp;
+    uint32_t misses = g_hist_stats.index_misses;
+    uint32_t t;
+    uint32_t i;
+    uint32_t r;
+
+    for (i = 0; i < QUERIES; i++)
+    {
+        r = Sim_RandBelow(4);
+        t = g_scan[Sim_RandBelow(g_scan_count)].timestamp;
+
+        if (r == 1)
+        {
+            t++;
+        }
+        else if (r == 2)
+        {
+            t = first - 10 + Sim_RandBelow(last - first + 20);
+        }
+        else if (r == 3)
+        {
+            t = (Sim_RandBelow(2) == 0) ? first - Sim_RandBelow(first + 1) : last + Sim_RandBelow(1000);
+        }
+
+        r = Sim_LowerBound(t);
+        r = (r < g_scan_count) ? g_scan_slot[r] : MeterHistory_GetCount();
+        if (MeterHistory_Find(t) != r)
+        {
+            Sim_Fail("find differs from brute force", t, r);
+        }
+    }
+
+    printf("  %s: %u queries, %.1f NOR reads per query, %lu index misses\n", title, QUERIES,
+           (double)(g_nor_stats.reads - reads) / QUERIES, (unsigned long)(g_hist_stats.index_misses - misses));
+}
+
+static void Sim_FindRun(unsigned long appends)
+{
+    static const uint8_t zero[METER_HISTORY_INDEX_SIZE];
+    uint32_t seq;
+    uint32_t i;
+
+    memset(g_nor, 0xFF, sizeof(g_nor));
+    memset(g_lost, 0, appends + 2);
+    g_last_id = 0;
+    g_time = 1000000;
+    Sim_Boot(false);
+
+    while (g_last_id < appends)
+    {
+        Sim_Append();
+        Sim_Poll();
+
+        /* Clean reboot now and then (queued records are lost, stamps keep increasing) */
+        if (Sim_RandBelow(5000) == 0)
+        {
+            Sim_Boot(false);
+        }
+    }
+
+    Sim_Drain();
+    Sim_Boot(true);
+    Sim_Scan(1);
+
+    printf("time lookup: %lu appends, %lu records stored over %u sectors, %lu uncommitted slots\n",
+           appends, (unsigned long)g_scan_count, g_hist_sectors,
+           (unsigned long)(MeterHistory_GetCount() - g_scan_count));
+    Sim_Queries("with index");
+
+    /* Zero random index entries of full sectors (the head sector has none) */
+    for (i = 0; i < CORRUPT_ENTRIES; i++)
+    {
+        seq = g_hist_seq - g_hist_sectors + 1 + Sim_RandBelow(g_hist_sectors - 1);
+        memcpy(&g_nor[HIST_INDEX_ADDR(seq)], zero, sizeof(zero));
+    }
+    Sim_Boot(false);
+    Sim_Scan(1);
+    Sim_Queries("50 entries zeroed");
+}
+
+static void Sim_ScanRun(void)
+{
+    const MeterNorCacheStats_t* cache = MeterNorCache_GetStats();
+    unsigned long reads;
+
+    Sim_Boot(false);
+    MeterNorCache_ResetStats();
+    reads = g_nor_stats.reads;
+
+    Sim_Scan(SCAN_BURST);
+
+    printf("full scan: %lu records, %lu NOR reads, cache %lu hits, %lu misses, %lu readaheads (%lu used, %lu waits)\n",
+           (unsigned long)g_scan_count, g_nor_stats.reads - reads, (unsigned long)cache->hits,
+           (unsigned long)cache->misses, (unsigned long)cache->readaheads, (unsigned long)cache->readahead_used,
+           (unsigned long)cache->waits);
+}
+
+int main(int argc, char** argv)
+{
+    unsigned long appends = (argc > 1) ? strtoul(argv[1], NULL, 0) : 200000;
+
+    Sim_Seed((argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 1);
+
+    g_stamp = calloc(appends + 2, sizeof(*g_stamp));
+    g_lost = calloc(appends + 2, sizeof(*g_lost));
+    g_scan = calloc(METER_HISTORY_SECTOR_COUNT * METER_HISTORY_RECS_PER_SECTOR, sizeof(*g_scan));
+    g_scan_slot = calloc(METER_HISTORY_SECTOR_COUNT * METER_HISTORY_RECS_PER_SECTOR, sizeof(*g_scan_slot));
+    if (g_stamp == NULL || g_lost == NULL || g_scan == NULL || g_scan_slot == NULL)
+    {
+        return 2;
+    }
+
+    memset(g_nor, 0xFF, sizeof(g_nor));
+    g_time = 1000000;
+    Sim_Boot(false);
+
+    Sim_PowerCutRun(appends);
+    Sim_FindRun(appends);
+    Sim_ScanRun();
+
+    printf("%s (%lu failures)\n", g_sim.failures ? "FAILED" : "OK", g_sim.failures);
+
+    return g_sim.failures ? 1 : 0;
+}
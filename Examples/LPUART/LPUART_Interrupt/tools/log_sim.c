@@ -0,0 +1,399 @@
+/*
+ * Host power-cut simulation for meter_log.c (internal flash page log) and
+ * meter_retain.c (retained SRAM queue).
+ *
+ * Build (from the example directory):
+ *     gcc -O2 -D__A31L12x_CONF_H -include tools/sim_host.h -I. tools/log_sim.c tools/sim_host.c -o log_sim
+ *
+ * Usage:
+ *     log_sim [writes] [seed]            (default 30000 writes, seed 1)
+ *
+ * meter_log.c and meter_retain.c are included into this file so the log
+ * region and the retained block can be moved to host memory and their static
+ * state can be cleared on every simulated reset. The flash region is mapped
+ * at a fixed address below 4 GB because meter_log.c keeps page addresses in
+ * uint32_t (Linux).
+ *
+ * The flash model programs by AND (1 -> 0) and erases to 0xFF, like the FMC.
+ * A power cut is injected inside a random erase or write: part of the page is
+ * changed, one word is left half-programmed, and the run restarts from
+ * MeterRetain_Restore() + MeterLog_Mount(). Some resets also lose the
+ * retained SRAM. The LVI interrupt is fired from inside flash operations (the
+ * deferred path) and from the main loop.
+ *
+ * After every mount each record id written so far must be found exactly as
+ * written, in order, in a committed page or in the pending queue. Exceptions:
+ * ids older than the oldest page still in the ring, and ids lost with the
+ * retained SRAM. A page committed just before a cut may be written once more
+ * (duplicate, not loss).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <sys/mman.h>
+
+#include "meter_log.h"
+#include "meter_retain.h"
+#include "meter_flash.h"
+
+#define SIM_FLASH_ADDR      0x10000000UL
+#define SIM_FLASH_SIZE      (METER_LOG_PAGE_COUNT * METER_LOG_PAGE_SIZE)
+
+#define CUT_INTERVAL        120     /* mean flash operations between power cuts */
+#define RESET_ONE_IN        400     /* clean reset between writes */
+#define SRAM_LOSS_ONE_IN    8       /* resets that also lose the retained SRAM */
+#define LVI_IN_FLASH_ONE_IN 300     /* LVI interrupt during a flash operation */
+#define LVI_ONE_IN          150     /* LVI interrupt from the main loop */
+
+#undef METER_LOG_BASE_ADDR
+#define METER_LOG_BASE_ADDR SIM_FLASH_ADDR
+
+static uint32_t g_sim_retain[METER_RETAIN_SIZE / 4];
+
+#undef METER_RETAIN
+#define METER_RETAIN        ((MeterRetain_t*)g_sim_retain)
+
+#include "../meter_log.c"
+#include "../meter_retain.c"
+
+static uint8_t* g_flash;
+static jmp_buf g_power_cut;
+static long g_cut_countdown;
+
+static uint32_t g_last_id;          /* last id passed to MeterLog_Write() */
+static uint32_t g_floor_id;         /* ids up to this one may be lost (retained SRAM loss) */
+static uint32_t* g_seen;            /* per id: verify pass that found it */
+static uint8_t* g_dup;              /* per id: already counted as a duplicate */
+static uint32_t g_pass;
+
+static struct
+{
+    unsigned long   erase_cuts;
+    unsigned long   write_cuts;
+    unsigned long   resets;
+    unsigned long   sram_losses;
+    unsigned long   lvi;
+    unsigned long   duplicates;
+    unsigned long   recovered;
+    unsigned long   programs;
+    unsigned long   records;
+    unsigned long   failures;
+} g_sim;
+
+static void Sim_Fail(const char* what, uint32_t a, uint32_t b)
+{
+    if (g_sim.failures++ < 20)
+    {
+        printf("FAIL: %s (%lu, %lu)\n", what, (unsigned long)a, (unsigned long)b);
+    }
+}
+
+/* Record contents derived from the id, so any torn or stale record shows up */
+static void Sim_MakeRecord(uint32_t id, MeterRecord_t* rec)
+{
+    rec->timestamp = id;
+    rec->meter_id = id;
+    rec->reading = id * 2654435761UL;
+    rec->status = (uint16_t)(id ^ 0x5A5A);
+    rec->version = (uint8_t)(11 + id % 4);
+    rec->dp_dia = (uint8_t)(id >> 8);
+}
+
+static bool Sim_RecordOk(const MeterRecord_t* rec)
+{
+    MeterRecord_t ref;
+
+    Sim_MakeRecord(rec->meter_id, &ref);
+    return rec->meter_id != 0 && rec->meter_id <= g_last_id && memcmp(rec, &ref, sizeof(ref)) == 0;
+}
+
+static bool Sim_Cut(void)
+{
+    return --g_cut_countdown <= 0;
+}
+
+static void Sim_PowerCut(void)
+{
+    g_cut_countdown = 1 + (long)Sim_RandBelow(2 * CUT_INTERVAL);
+    longjmp(g_power_cut, 1);
+}
+
+/* The LVI interrupt can arrive while the main loop is inside a flash operation */
+static void Sim_LviDuringFlash(void)
+{
+    if (Sim_RandBelow(LVI_IN_FLASH_ONE_IN) == 0)
+    {
+        g_sim.lvi++;
+        MeterLog_EmergencyFlush();
+    }
+}
+
+static uint32_t* Sim_Page(uint32_t u32Addr)
+{
+    if (u32Addr < SIM_FLASH_ADDR || u32Addr >= SIM_FLASH_ADDR + SIM_FLASH_SIZE || u32Addr % METER_LOG_PAGE_SIZE)
+    {
+        printf("bad flash address 0x%08lX\n", (unsigned long)u32Addr);
+        exit(2);
+    }
+
+    return (uint32_t*)(uintptr_t)u32Addr;
+}
+
+uint32_t MeterFlash_PageErase(uint32_t u32UserId, uint32_t u32Addr)
+{
+    uint32_t* page = Sim_Page(u32Addr);
+    uint32_t i;
+
+    if (u32UserId != METER_LOG_FMC_ERASE_ID)
+    {
+        return FLASH_PGM_FAIL;
+    }
+
+    Sim_LviDuringFlash();
+
+    if (Sim_Cut())
+    {
+        /* Interrupted erase: cells are somewhere between old contents and 0xFF */
+        for (i = 0; i < METER_LOG_PAGE_SIZE / 4; i++)
+        {
+            page[i] = (Sim_RandBelow(2) == 0) ? 0xFFFFFFFFUL : page[i] | Sim_Rand();
+        }
+        g_sim.erase_cuts++;
+        Sim_PowerCut();
+    }
+
+    memset(page, 0xFF, METER_LOG_PAGE_SIZE);
+    return FLASH_PGM_GOOD;
+}
+
+uint32_t MeterFlash_PageWrite(uint32_t u32UserId, uint32_t u32Addr, const uint32_t* u32Buf)
+{
+    uint32_t* page = Sim_Page(u32Addr);
+    uint32_t words = METER_LOG_PAGE_SIZE / 4;
+    uint32_t done;
+    uint32_t i;
+
+    if (u32UserId != METER_LOG_FMC_WRITE_ID)
+    {
+        return FLASH_PGM_FAIL;
+    }
+
+    Sim_LviDuringFlash();
+
+    if (Sim_Cut())
+    {
+        /* Interrupted write: words programmed in order, the current one only partly */
+        done = Sim_RandBelow(words + 1);
+        for (i = 0; i < done; i++)
+        {
+            page[i] &= u32Buf[i];
+        }
+        if (done < words)
+        {
+            page[done] &= u32Buf[done] | Sim_Rand();
+        }
+        g_sim.write_cuts++;
+        Sim_PowerCut();
+    }
+
+    for (i = 0; i < words; i++)
+    {
+        page[i] &= u32Buf[i];
+    }
+    return FLASH_PGM_GOOD;
+}
+
+/* Static state of meter_log.c after a reset (startup code clears .bss/.data) */
+static void Sim_ResetLogState(void)
+{
+    g_log_mounted = false;
+    g_log_head = METER_LOG_PAGE_COUNT - 1;
+    g_log_count = 0;
+    g_log_seq = 0;
+    memset(&g_log_page, 0xA5, sizeof(g_log_page));
+    g_log_pending_ms = 0;
+    memset(&g_log_stats, 0, sizeof(g_log_stats));
+    g_log_busy = false;
+    g_log_lvi_pending = false;
+}
+
+/* One record in log order: new, or a rewrite of one already seen */
+static void Sim_CheckRecord(const MeterRecord_t* rec, uint32_t* max_id)
+{
+    uint32_t id = rec->meter_id;
+
+    if (!Sim_RecordOk(rec))
+    {
+        Sim_Fail("corrupt record", id, g_last_id);
+        return;
+    }
+
+    if (id > *max_id)
+    {
+        *max_id = id;
+    }
+    else if (g_seen[id] == g_pass)
+    {
+        if (!g_dup[id])
+        {
+            g_dup[id] = 1;
+            g_sim.duplicates++;
+        }
+    }
+    else if (id > g_floor_id)
+    {
+        Sim_Fail("record out of order", id, *max_id);
+    }
+
+    g_seen[id] = g_pass;
+}
+
+/* Log pages (oldest first) + pending queue against the ids written so far */
+static void Sim_Verify(void)
+{
+    const MeterLogPage_t* page;
+    const MeterRecord_t* pending;
+    uint32_t max_id = 0;
+    uint32_t oldest = 0;
+    uint32_t id;
+    uint16_t count = MeterLog_GetPageCount();
+    uint16_t age;
+    uint8_t n;
+    uint8_t i;
+
+    g_pass++;
+
+    for (age = count; age-- > 0;)
+    {
+        page = MeterLog_GetPage(age);
+        if (page == NULL)
+        {
+            /* Only the oldest page may be gone (erased for the next page when the cut came) */
+            if (age != count - 1)
+            {
+                Sim_Fail("hole in the log", age, count);
+            }
+            continue;
+        }
+
+        for (i = 0; i < page->header.count; i++)
+        {
+            if (oldest == 0)
+            {
+                oldest = page->rec[i].meter_id;
+            }
+            Sim_CheckRecord(&page->rec[i], &max_id);
+        }
+    }
+
+    n = MeterLog_GetPending(&pending);
+    for (i = 0; i < n; i++)
+    {
+        if (oldest == 0)
+        {
+            oldest = pending[i].meter_id;
+        }
+        Sim_CheckRecord(&pending[i], &max_id);
+    }
+
+    /* Everything since the oldest surviving page must be there */
+    for (id = (oldest > g_floor_id) ? oldest : g_floor_id + 1; id != 0 && id <= g_last_id; id++)
+    {
+        if (g_seen[id] != g_pass)
+        {
+            Sim_Fail("record lost", id, g_last_id);
+        }
+    }
+}
+
+static void Sim_Boot(void)
+{
+    if (Sim_RandBelow(SRAM_LOSS_ONE_IN) == 0)
+    {
+        uint32_t i;
+
+        for (i = 0; i < METER_RETAIN_SIZE / 4; i++)
+        {
+            g_sim_retain[i] = Sim_Rand();
+        }
+        g_floor_id = g_last_id;
+        g_sim.sram_losses++;
+    }
+
+    g_sim.programs += g_log_stats.programs;
+    g_sim.records += g_log_stats.records;
+    Sim_ResetLogState();
+
+    (void)MeterRetain_Restore();
+    (void)MeterLog_Mount();
+    g_sim.recovered += g_log_stats.recovered;
+
+    Sim_Verify();
+}
+
+int main(int argc, char** argv)
+{
+    unsigned long writes = (argc > 1) ? strtoul(argv[1], NULL, 0) : 30000;
+    MeterRecord_t rec;
+    void* map;
+
+    Sim_Seed((argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 1);
+
+    map = mmap((void*)(uintptr_t)SIM_FLASH_ADDR, SIM_FLASH_SIZE, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    g_seen = calloc(writes + 2, sizeof(*g_seen));
+    g_dup = calloc(writes + 2, sizeof(*g_dup));
+    if (map != (void*)(uintptr_t)SIM_FLASH_ADDR || g_seen == NULL || g_dup == NULL)
+    {
+        printf("cannot map the flash image at 0x%08lX\n", SIM_FLASH_ADDR);
+        return 2;
+    }
+    g_flash = map;
+    memset(g_flash, 0xFF, SIM_FLASH_SIZE);
+    memset(g_sim_retain, 0, sizeof(g_sim_retain));
+    g_cut_countdown = 1 + (long)Sim_RandBelow(2 * CUT_INTERVAL);
+
+    if (setjmp(g_power_cut) != 0)
+    {
+        g_sim.resets++;
+    }
+    Sim_Boot();
+
+    while (g_last_id < writes)
+    {
+        /* 0 ~ 2 hours between readings: the 4-hour deadline flushes partial pages */
+        g_sim_tick_ms += Sim_RandBelow(2 * 3600 * 1000);
+
+        if (Sim_RandBelow(RESET_ONE_IN) == 0)
+        {
+            g_sim.resets++;
+            Sim_Boot();
+        }
+
+        (void)MeterLog_Task();
+
+        if (Sim_RandBelow(LVI_ONE_IN) == 0)
+        {
+            g_sim.lvi++;
+            MeterLog_EmergencyFlush();
+        }
+
+        Sim_MakeRecord(++g_last_id, &rec);
+        (void)MeterLog_Write(&rec);
+    }
+
+    g_sim.resets++;
+    Sim_Boot();
+
+    printf("writes %lu, resets %lu (power cuts: %lu in erase, %lu in write), retained SRAM lost %lu\n",
+           writes, g_sim.resets, g_sim.erase_cuts, g_sim.write_cuts, g_sim.sram_losses);
+    printf("LVI flushes %lu, uncommitted pages dropped at mount %lu, duplicate records %lu\n",
+           g_sim.lvi, g_sim.recovered, g_sim.duplicates);
+    printf("page programs %lu, %.2f records per program\n",
+           g_sim.programs, g_sim.programs ? (double)g_sim.records / g_sim.programs : 0.0);
+    printf("%s (%lu failures)\n", g_sim.failures ? "FAILED" : "OK", g_sim.failures);
+
+    return g_sim.failures ? 1 : 0;
+}
@@ -0,0 +1,67 @@
+/*
+ * Host versions of the target services used by the storage simulations.
+ * See sim_host.h for the build line.
+ */
+
+#include "meter_protocol.h"
+#include "meter_clock.h"
+
+uint32_t g_sim_tick_ms;
+
+static uint32_t g_sim_rand = 1;
+
+/* Same nibble table as meter_protocol.c (CRC-16/CCITT) */
+uint16_t Meter_CRC16(const void* data, uint16_t length, uint16_t crc)
+{
+    static const uint16_t nibble_table[16] =
+    {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+    };
+    const uint8_t* p = (const uint8_t*)data;
+
+    while (length--)
+    {
+        crc = (uint16_t)((crc << 4) ^ nibble_table[(crc >> 12) ^ (*p >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ nibble_table[(crc >> 12) ^ (*p & 0x0F)]);
+        p++;
+    }
+
+    return crc;
+}
+
+uint32_t Meter_GetTickMs(void)
+{
+    return g_sim_tick_ms;
+}
+
+void Meter_SetLinkStats(METER_LINK_STATS_Type* stats)
+{
+    (void)stats;
+}
+
+void MeterClock_Boost(void)
+{
+}
+
+void MeterClock_Release(void)
+{
+}
+
+void Sim_Seed(uint32_t seed)
+{
+    g_sim_rand = seed ? seed : 1;
+}
+
+uint32_t Sim_Rand(void)
+{
+    g_sim_rand ^= g_sim_rand << 13;
+    g_sim_rand ^= g_sim_rand >> 17;
+    g_sim_rand ^= g_sim_rand << 5;
+    return g_sim_rand;
+}
+
+uint32_t Sim_RandBelow(uint32_t n)
+{
+    return Sim_Rand() % n;
+}
@@ -0,0 +1,35 @@
+/*
+ * Host build shim for the storage simulations (log_sim.c, history_sim.c).
+ *
+ * Force-included in place of main_conf.h, which pulls in the device headers:
+ *     gcc ... -D__A31L12x_CONF_H -include tools/sim_host.h -I. ...
+ *
+ * Provides the few device constants the meter sources use and the host
+ * versions of the target services they call (tick, CRC, clock scaling).
+ */
+
+#ifndef SIM_HOST_H
+#define SIM_HOST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* A31L12x_hal_fmc.h */
+#define SECTOR_SIZE_BYTE            (0x80uL)
+#define FLASH_PGM_GOOD              0x0uL
+#define FLASH_PGM_FAIL              0x9uL
+
+/* meter_retain.c power-down entry (not simulated) */
+#define HAL_PMU_Enable_SRAMRetentionPower()
+#define HAL_PWR_EnterPowerDownMode()
+
+/* Simulated millisecond tick returned by Meter_GetTickMs() */
+extern uint32_t g_sim_tick_ms;
+
+/* xorshift32, seeded by Sim_Seed() */
+void Sim_Seed(uint32_t seed);
+uint32_t Sim_Rand(void);
+uint32_t Sim_RandBelow(uint32_t n);
+
+#endif /* SIM_HOST_H */
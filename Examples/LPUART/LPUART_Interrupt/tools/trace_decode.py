@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+"""
+Decode binary trace dumps from meter_trace.c.
+
+Usage:
+    trace_decode.py <firmware.elf|.axf> <capture.bin>
+
+The capture is the raw byte stream of the debug UART (38400 bps, 8-N-1) after
+pressing 'l'. Text around the dump blocks is ignored. Format strings are read
+from the ELF at the address stored in each record, so the ELF must be the one
+that is running on the target.
+
+Dump block (little endian):
+    "TRC1" | word count (u16) | dropped records (u16) | words
+Record:
+    [0] format string address (bits 27-0) | argument count (bits 31-28)
+    [1] timestamp (ms)
+    [2..] arguments (32-bit)
+"""
+
+import re
+import struct
+import sys
+
+SYNC = b"TRC1"
+ADDR_MASK = 0x0FFFFFFF
+NARGS_POS = 28
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+# printf conversion: flags, width, precision, length modifier, conversion
+FMT_RE = re.compile(r"%([-+ #0]*)(\d*)(?:\.(\d+))?(hh|h|ll|l|z|j|t)?([diouxXcsp%])")
+
+
+class Elf:
+    """Minimal ELF reader: maps loadable section contents by address."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            data = f.read()
+
+        if data[:4] != b"\x7fELF":
+            raise ValueError("%s: not an ELF file" % path)
+        if data[5] != 1:
+            raise ValueError("%s: big endian ELF not supported" % path)
+
+        is64 = data[4] == 2
+        if is64:
+            shoff, = struct.unpack_from("<Q", data, 0x28)
+            shentsize, shnum = struct.unpack_from("<HH", data, 0x3A)
+        else:
+            shoff, = struct.unpack_from("<I", data, 0x20)
+            shentsize, shnum = struct.unpack_from("<HH", data, 0x2E)
+
+        self.sections = []
+        for i in range(shnum):
+            off = shoff + i * shentsize
+            if is64:
+                _, sh_type, flags, addr, offset, size = struct.unpack_from("<IIQQQQ", data, off)
+            else:
+                _, sh_type, flags, addr, offset, size = struct.unpack_from("<IIIIII", data, off)
+            if flags & SHF_ALLOC and sh_type != SHT_NOBITS and size > 0:
+                self.sections.append((addr, data[offset:offset + size]))
+
+    def string(self, addr):
+        for base, content in self.sections:
+            if base <= addr < base + len(content):
+                end = content.find(b"\0", addr - base)
+                if end < 0:
+                    end = len(content)
+                return content[addr - base:end].decode("latin-1")
+        return None
+
+
+def render(elf, fmt, args):
+    """Applies printf-style conversions to 32-bit arguments."""
+    out = []
+    pos = 0
+    it = iter(args)
+
+    for m in FMT_RE.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        flags, width, prec, _, conv = m.groups()
+
+        if conv == "%":
+            out.append("%")
+            continue
+
+        arg = next(it, 0)
+        spec = "%" + flags + width + ("." + prec if prec else "")
+
+        if conv in "di":
+            if arg & 0x80000000:
+                arg -= 1 << 32
+            out.append((spec + "d") % arg)
+        elif conv == "u":
+            out.append((spec + "d") % arg)
+        elif conv in "oxX":
+            out.append((spec + conv) % arg)
+        elif conv == "p":
+            out.append("0x%08X" % arg)
+        elif conv == "c":
+            out.append((spec + "c") % chr(arg & 0xFF))
+        elif conv == "s":
+            s = elf.string(arg)
+            out.append((spec + "s") % (s if s is not None else "<0x%08X>" % arg))
+
+    out.append(fmt[pos:])
+    return "".join(out)
+
+
+def decode_block(elf, words, drops):
+    i = 0
+    while i + 1 < len(words):
+        head, stamp = words[i], words[i + 1]
+        nargs = head >> NARGS_POS
+        args = words[i + 2:i + 2 + nargs]
+        i += 2 + nargs
+
+        fmt = elf.string(head & ADDR_MASK)
+        if fmt is None:
+            text = "<unknown format 0x%08X> %s" % (head & ADDR_MASK, " ".join("0x%08X" % a for a in args))
+        else:
+            text = render(elf, fmt, args)
+
+        print("[%8u.%03u] %s" % (stamp // 1000, stamp % 1000, text.rstrip("\r\n")))
+
+    if drops:
+        print("[         ...] %u records dropped (trace ring full)" % drops)
+
+
+def main(argv):
+    if len(argv) != 3:
+        sys.stderr.write(__doc__)
+        return 2
+
+    elf = Elf(argv[1])
+    with open(argv[2], "rb") as f:
+        capture = f.read()
+
+    blocks = 0
+    pos = capture.find(SYNC)
+    while pos >= 0 and pos + 8 <= len(capture):
+        count, drops = struct.unpack_from("<HH", capture, pos + 4)
+        start = pos + 8
+        end = start + count * 4
+        if end > len(capture):
+            sys.stderr.write("truncated dump block at offset %u\n" % pos)
+            break
+
+        decode_block(elf, list(struct.unpack_from("<%uI" % count, capture, start)), drops)
+        blocks += 1
+        pos = capture.find(SYNC, end)
+
+    if blocks == 0:
+        sys.stderr.write("no trace dump found\n")
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))